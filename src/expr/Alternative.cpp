@@ -30,6 +30,8 @@
 #include <sstream>
 // pgen
 #include "Alternative.h"
+#include "Text.h"
+#include "Trie.h"
 
 using namespace std;
 namespace pgen 
@@ -54,16 +56,64 @@ namespace pgen
 		expr.push_back(expression);
 	}
 
+	bool Alternative::literals()
+	{
+		string bytes;
+		for (ICompilable* c: expr)
+		{
+			if (!c->literal(bytes)) 
+			{
+				return false;
+			}
+		}
+		return !expr.empty();
+	}
+
 	/**
+	 * When all the alternatives are literal (see Alternative::literals()), they are matched by a Trie that reads
+	 * each byte once. Every text that matches the input is then tried with the rest of the chain, in the same order
+	 * as the alternatives.
+	 * compiled code: (chained version, literal alternatives)
+	 * %cprototype()% {
+	 *  int p;
+	 *  %trie.compile()%, with the stop code:
+	 *  %for (Trie::Match m: matches)%
+	 *   p = chain_next(text + %m.length%, chain);
+	 *   if (p != -1) return p + %m.length%;
+	 *  %end for%
+	 *   return -1;
+	 * }
 	 * compiled code: (chained version)
 	 * %cprototype()% {
-	 *  fc%name()%[%expr.size()+1%].subchain = chain;
-	 *  return next_chain(text, fc%name()%);
+	 *  int pos = 0, cpos = 0;
+	 * %for (ICompilable* c: expr)%
+	 *  pos = %c->funcname()%(text);
+	 *  if (pos != -1) {
+	 *   cpos = chain_next(text+pos, chain);
+	 *   if (cpos != -1) return cpos + pos;
+	 *  }
+	 * %end for%
+	 *  return -1;
 	 * }
 	 */
 	string Alternative::ccompile() 
 	{
 		stringstream s;
+		if (this->literals())
+		{
+			s << cprototype() << " {"											"\n"
+				 " int p;"														"\n"
+			  << this->trie().compile(true, [](stringstream& s, const string& tabs, const vector<Trie::Match>& matches) {
+					for (const Trie::Match& m: matches)
+					{
+						s << tabs << "p = chain_next(text + " << m.length << ", chain);"		"\n"
+						  << tabs << "if (p != -1) return p + " << m.length << ";"				"\n";
+					}
+					s << tabs << "return -1;"													"\n";
+				}) <<
+				 "}"															"\n\n";
+			return s.str();
+		}
 		s << cprototype() << " {" << endl;
 		s << "\tint pos = 0, cpos = 0;" << endl;
 		for (ICompilable* c: expr) 
@@ -80,6 +130,23 @@ namespace pgen
 	}
 
 	/**
+	 * When all the alternatives are literal (see Alternative::literals()), they are matched by a Trie that reads
+	 * each byte once and stops as soon as the first alternative that matches the input is known.
+	 * compiled code: (single literal alternative)
+	 * %prototype()% {
+	 *  int pos = 0;
+	 *  %Text::compare(bytes)%
+	 *  return pos;
+	 * }
+	 * compiled code: (literal alternatives)
+	 * %prototype()% {
+	 *  %trie.compile()%, with the stop code:
+	 *  %if (matches.empty())%
+	 *   return -1;
+	 *  %else%
+	 *   return %matches[0].length%;
+	 *  %end if%
+	 * }
 	 * compiled code:
 	 * %prototype()% {
 	 * 	int pos = 0;
@@ -93,6 +160,25 @@ namespace pgen
 	string Alternative::compile() 
 	{
 		stringstream s;
+		if (this->literals())
+		{
+			s << prototype() << " {"											"\n";
+			string bytes;
+			if (this->literal(bytes))
+			{
+				s << " int pos = 0;"											"\n"
+				  << Text::compare(bytes) <<
+					 " return pos;"												"\n";
+			}
+			else
+			{
+				s << this->trie().compile(false, [](stringstream& s, const string& tabs, const vector<Trie::Match>& matches) {
+					s << tabs << "return " << (matches.empty() ? -1 : (int)matches.front().length) << ";"	"\n";
+				});
+			}
+			s << "}"															"\n\n";
+			return s.str();
+		}
 		s << prototype() << " {" << endl;
 		s << "\tint pos = 0;" << endl;
 		for (ICompilable* c: expr) 
@@ -105,20 +191,66 @@ namespace pgen
 		return s.str();
 	}
 
+	bool Alternative::literal(string& bytes)
+	{
+		return (expr.size() == 1 && expr[0]->literal(bytes));
+	}
+
+	Trie Alternative::trie()
+	{
+		Trie trie;
+		for (unsigned int i = 0; i < expr.size(); i++)
+		{
+			string bytes;
+			expr[i]->literal(bytes);
+			trie.add(bytes, i);
+		}
+		return trie;
+	}
+
 	vector<ICompilable*> & Alternative::dependences() 
 	{
 		return this->expr;
 	}
 
+	bool Alternative::nullable()
+	{
+		for (ICompilable* c: expr)
+		{
+			if (c->nullable())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Alternative::first(IntervalSet& set)
+	{
+		for (ICompilable* c: expr)
+		{
+			c->first(set);
+		}
+	}
+
+	string Alternative::str()
+	{
+		stringstream s;
+		for (unsigned int i = 0; i < expr.size(); i++)
+		{
+			s << (i > 0 ? "|" : "") << expr[i]->str();
+		}
+		return s.str();
+	}
+
 	string Alternative::name() 
 	{
 		stringstream s;
-		s << "al";
 		for (ICompilable* c: expr)
 		{
 			s << '_' << c->name();
 		}
-		return s.str();
+		return intern("al", s.str());
 	}
 
 	/**
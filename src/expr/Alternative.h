@@ -34,6 +34,7 @@
 #include <memory>
 // pgen
 #include "ICompilable.h"
+#include "Trie.h"
 
 using namespace std;
 namespace pgen 
@@ -55,6 +56,20 @@ namespace pgen
 		 */
 		void add(ICompilable* expression);
 
+		/**
+		 * Checks if all the alternatives are literal texts (see ICompilable::literal()), in which case they are 
+		 * matched by a Trie instead of calling the function of each alternative.
+		 * \return true if there is at least one alternative and all of them are literal.
+		 */
+		bool literals();
+		/**
+		 * Returns a Trie with the literal text of each alternative. The item of each text is the index of the 
+		 * alternative, so the first alternative has the highest priority.
+		 * \return the Trie of the alternatives.
+		 * \remark all the alternatives must be literal (see Alternative::literals()).
+		 */
+		Trie trie();
+
 		/**
 		 * Returns C code that can parse the regular expression.
 		 * The returned code should be a function with the following
@@ -82,11 +97,29 @@ namespace pgen
 		 * \return A vector of ICompilable dependences of the code.
 		 */
 		virtual vector<ICompilable*> & dependences();
+		/**
+		 * Appends the bytes of the alternative to "bytes" (see ICompilable::literal()).
+		 * \returns true when there is a single alternative and it is literal.
+		 */
+		virtual bool literal(string& bytes);
+		/**
+		 * \returns true when any of the alternatives is nullable.
+		 */
+		virtual bool nullable();
+		/**
+		 * Adds the first characters of all the alternatives to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the alternatives separated by '|'.
+		 */
+		virtual string str();
 		/**
 		 * Returns the name of the expression. The returned name must be usable as a function
 		 * name in the standard C (C99). i.e. it has to match the following format:
 		 * [a-zA-Z][A-Za-z0-9_]*
-		 * \return The name of the expression (usable as function names).
+		 * Structurally equal alternatives share the same name (see ICompilable::intern()).
+		 * \return The text "al" followed by the id of the alternative.
 		 */
 		virtual string name();
 		/**
@@ -0,0 +1,206 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-23
+ * \file
+ * This file contains the implementation of the Backtracking class, the analysis of the backtracking risks of an
+ * expression (see Backtracking.h).
+ */
+
+// STL
+#include <string>
+#include <vector>
+// pgen
+#include "Backtracking.h"
+#include "Alternative.h"
+#include "Quantified.h"
+#include "Sequence.h"
+
+using namespace std;
+namespace pgen
+{
+
+	Backtracking::Backtracking(ICompilable* expr)
+	 : level(NONE)
+	{
+		IntervalSet loops;
+		analyze(expr, loops, nullptr, false);
+	}
+
+	Backtracking::Risk Backtracking::risk()
+	{
+		return level;
+	}
+
+	const vector<string>& Backtracking::warnings()
+	{
+		return messages;
+	}
+
+	bool Backtracking::overlaps(const IntervalSet& a, const IntervalSet& b)
+	{
+		IntervalSet common(a);
+		common.intersect(b);
+		return !common.empty();
+	}
+
+	void Backtracking::warn(Risk risk, ICompilable* expr, const string& reason)
+	{
+		if (reported.insert(expr).second)
+		{
+			messages.push_back(string(risk == EXPONENTIAL ? "exponential" : "polynomial") + " backtracking in '" + 
+				expr->str() + "': " + reason);
+		}
+		if (risk > level)
+		{
+			level = risk;
+		}
+	}
+
+	void Backtracking::loopFirst(ICompilable* expr, IntervalSet& set)
+	{
+		switch (expr->type())
+		{
+		case Sequence::TYPE:
+			{
+				for (ICompilable* e: expr->dependences())
+				{
+					loopFirst(e, set);
+					if (!e->nullable())
+					{
+						break;
+					}
+				}
+				break;
+			}
+		case Alternative::TYPE:
+			{
+				for (ICompilable* e: expr->dependences())
+				{
+					loopFirst(e, set);
+				}
+				break;
+			}
+		case Quantified::TYPE:
+			{
+				Quantified* q = reinterpret_cast<Quantified*>(expr);
+				if (q->getMax() == Quantified::INF)
+				{
+					q->first(set);
+				}
+				else if (q->getMax() > 0)
+				{
+					loopFirst(q->dependences()[0], set);
+				}
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Ambiguous quantifiers are reported as exponential when they are nested in an unbounded quantifier. Otherwise, 
+	 * only unbounded quantifiers are reported (as polynomial), since bounded ones only multiply the time by a constant.
+	 * The sets of the items of a sequence are computed from the last item to the first one: the loops that follow an
+	 * item are the loops that start the next items, up to the first item that is not nullable, plus the loops that 
+	 * follow the whole sequence when all the next items are nullable.
+	 * The body of a quantifier that repeats more than once is followed by its own first characters (the next 
+	 * occurrence), so a quantifier nested in it that can match those characters is ambiguous.
+	 */
+	void Backtracking::analyze(ICompilable* expr, const IntervalSet& loops, ICompilable* outer, bool unbounded)
+	{
+		switch (expr->type())
+		{
+		case Sequence::TYPE:
+			{
+				vector<ICompilable*>& items = expr->dependences();
+				IntervalSet next(loops);
+				for (unsigned int i = items.size(); i-- > 0; )
+				{
+					analyze(items[i], next, outer, unbounded);
+					if (!items[i]->nullable())
+					{
+						next.clear();
+					}
+					loopFirst(items[i], next);
+				}
+				break;
+			}
+		case Alternative::TYPE:
+			{
+				vector<ICompilable*>& alternatives = expr->dependences();
+				if (unbounded)
+				{
+					IntervalSet all;
+					for (ICompilable* e: alternatives)
+					{
+						IntervalSet first;
+						e->first(first);
+						if (overlaps(all, first))
+						{
+							warn(EXPONENTIAL, outer, "the alternatives '" + expr->str() + "' can start with the same "
+								"characters");
+							break;
+						}
+						all.add(first);
+					}
+				}
+				for (ICompilable* e: alternatives)
+				{
+					analyze(e, loops, outer, unbounded);
+				}
+				break;
+			}
+		case Quantified::TYPE:
+			{
+				Quantified* q = reinterpret_cast<Quantified*>(expr);
+				ICompilable* e = q->dependences()[0];
+				if (q->getMax() <= 1)
+				{
+					analyze(e, loops, outer, unbounded);
+					break;
+				}
+				IntervalSet first;
+				e->first(first);
+				if (q->getMax() == Quantified::INF && e->nullable())
+				{
+					warn(EXPONENTIAL, q, "the repeated expression can match an empty text");
+				}
+				else if (q->getMin() < q->getMax() && overlaps(first, loops))
+				{
+					if (unbounded)
+					{
+						warn(EXPONENTIAL, outer, "the nested quantifier '" + q->str() + "' can match the same "
+							"characters as the next occurrence");
+					}
+					else if (q->getMax() == Quantified::INF)
+					{
+						warn(POLYNOMIAL, q, "the quantifier can match the same characters as the next quantifier");
+					}
+				}
+				IntervalSet next(loops);
+				next.add(first);
+				analyze(e, next, q, unbounded || q->getMax() == Quantified::INF);
+				break;
+			}
+		}
+	}
+
+} /* namespace pgen */
@@ -0,0 +1,119 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-23
+ * \file
+ * The Backtracking class analyzes an expression looking for sub-expressions that can make the generated backtracking
+ * code take exponential or polynomial time to match (or fail to match) a text. The analysis is based on the FIRST
+ * sets of the expressions (see ICompilable::first()): a quantifier that can either stop or repeat when it reads the
+ * same character is ambiguous, and the code has to try both ways. It is only a problem when the text that follows
+ * the quantifier is itself repeated, since every way of splitting the characters between the repetitions has to be 
+ * tried before failing. The following cases are reported:
+ *  - Exponential: a repeated expression that can match an empty text, e.g. "(a*)*";
+ *  - Exponential: an ambiguous quantifier nested in an unbounded quantifier, e.g. "(a+)+" or "([a-z]+\s?)*";
+ *  - Exponential: alternatives that can start with the same character under an unbounded quantifier, e.g.
+ *    "([a-z]|[0-9a-f])+" or "(\\.|[^"])*";
+ *  - Polynomial: an ambiguous unbounded quantifier followed by another unbounded quantifier that can match the 
+ *    same characters, e.g. "a*a*b" or "[0-9]+\.?[0-9]+", or nested in a bounded quantifier, e.g. "(a+){10}".
+ * The analysis is conservative: it may report expressions that do not really backtrack that much (e.g. "(a|ab)*",
+ * where each text can only be matched in a single way), but it does not miss the common patterns of catastrophic
+ * backtracking.
+ */
+
+#ifndef BACKTRACKING_H_
+#define BACKTRACKING_H_
+
+// STL
+#include <string>
+#include <vector>
+#include <set>
+// pgen
+#include "ICompilable.h"
+#include "../misc/IntervalSet.h"
+
+using namespace std;
+namespace pgen
+{
+	class Backtracking
+	{
+	public:
+		/**
+		 * The worst case of the time that the backtracking code of an expression takes to match a text, as a
+		 * function of the length of the text.
+		 */
+		enum Risk
+		{
+			NONE = 0,			//< Linear time.
+			POLYNOMIAL = 1,		//< Polynomial time, e.g. O(n^2).
+			EXPONENTIAL = 2		//< Exponential time, e.g. O(2^n).
+		};
+	private:
+		Risk level;					//< The highest risk found.
+		vector<string> messages;	//< Description of each risk found.
+		set<ICompilable*> reported;	//< The sub-expressions which were already reported.
+
+		/**
+		 * Analyzes an expression and its sub-expressions.
+		 * \param expr the expression to analyze.
+		 * \param loops the characters that can follow the text matched by the expression and that can be matched by
+		 * unbounded quantifiers or by the next occurrence of the enclosing quantifiers.
+		 * \param outer the innermost enclosing quantifier which repeats more than once, or nullptr.
+		 * \param unbounded true if there is an enclosing quantifier without a maximum occurrence.
+		 */
+		void analyze(ICompilable* expr, const IntervalSet& loops, ICompilable* outer, bool unbounded);
+		/**
+		 * Adds the first characters of the unbounded quantifiers that can start the text matched by an expression 
+		 * (e.g. the characters of "b" for "a?b+c").
+		 * \param expr the expression.
+		 * \param set the set to add the characters to.
+		 */
+		static void loopFirst(ICompilable* expr, IntervalSet& set);
+		/**
+		 * \return true if two sets have any common characters.
+		 */
+		static bool overlaps(const IntervalSet& a, const IntervalSet& b);
+		/**
+		 * Records a risk found on a sub-expression. Only the first risk found on each sub-expression is reported.
+		 * \param risk the risk.
+		 * \param expr the sub-expression.
+		 * \param reason the explanation of why the sub-expression is risky.
+		 */
+		void warn(Risk risk, ICompilable* expr, const string& reason);
+	public:
+		/**
+		 * Analyzes an expression.
+		 * \param expr the expression to analyze.
+		 */
+		Backtracking(ICompilable* expr);
+
+		/**
+		 * \return the highest risk found on the expression.
+		 */
+		Risk risk();
+		/**
+		 * \return a message for each risky sub-expression, e.g. "exponential backtracking in '(a+)+': an ambiguous
+		 * quantifier is nested in another quantifier".
+		 */
+		const vector<string>& warnings();
+	}; /* class Backtracking */
+} /* namespace pgen */
+
+#endif /* BACKTRACKING_H_ */
@@ -0,0 +1,478 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-24
+ * \file
+ * This file contains the implementation of the BitParallel class, which compiles an expression into an automaton of
+ * the bit-parallel engine (see BitParallel.h).
+ */
+
+// STL
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+// pgen
+#include "BitParallel.h"
+#include "Alternative.h"
+#include "Quantified.h"
+#include "Sequence.h"
+#include "Text.h"
+#include "Character.h"
+#include "Range.h"
+#include "CharClass.h"
+#include "../misc/Util.h"
+
+using namespace std;
+namespace pgen
+{
+
+	/**
+	 * Formats a set of positions as a C constant.
+	 */
+	static string mask(uint64_t set)
+	{
+		stringstream s;
+		s << "0x" << hex << uppercase << set << "ULL";
+		return s.str();
+	}
+
+	BitParallel::BitParallel(ICompilable* expression)
+	 : expr(expression)
+	 , valid(false)
+	 , sets({false, 0, 0})
+	{
+		if (count(expr) > MAX_POSITIONS || !greedy(expr))
+		{
+			return;
+		}
+		sets = build(expr);
+		valid = deterministic(sets.first);
+		for (uint64_t f: follow)
+		{
+			valid = valid && deterministic(f);
+		}
+	}
+
+	BitParallel::~BitParallel()
+	{
+	}
+
+	bool BitParallel::greedy(ICompilable* expression)
+	{
+		switch (expression->type())
+		{
+		case Sequence::TYPE:
+			{
+				for (ICompilable* e: expression->dependences())
+				{
+					if (!greedy(e))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		case Alternative::TYPE:
+			{
+				vector<ICompilable*>& alternatives = expression->dependences();
+				for (unsigned int i = 0; i < alternatives.size(); i++)
+				{
+					if (!greedy(alternatives[i]) || (i + 1 < alternatives.size() && alternatives[i]->nullable()))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		case Quantified::TYPE:
+			{
+				Quantified* q = reinterpret_cast<Quantified*>(expression);
+				ICompilable* e = q->dependences()[0];
+				return q->greedy && !e->nullable() && greedy(e);
+			}
+		case Text::TYPE:
+		case Character::TYPE:
+		case Range::TYPE:
+		case CharClass::TYPE:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	unsigned int BitParallel::count(ICompilable* expression)
+	{
+		const unsigned int limit = MAX_POSITIONS + 1;
+		switch (expression->type())
+		{
+		case Sequence::TYPE:
+		case Alternative::TYPE:
+			{
+				unsigned int n = 0;
+				for (ICompilable* e: expression->dependences())
+				{
+					n += count(e);
+					if (n >= limit)
+					{
+						return limit;
+					}
+				}
+				return n;
+			}
+		case Quantified::TYPE:
+			{
+				Quantified* q = reinterpret_cast<Quantified*>(expression);
+				unsigned int copies = (q->getMax() == Quantified::INF ? max(q->getMin(), 1u) : q->getMax());
+				unsigned int n = count(q->dependences()[0]);
+				if (copies >= limit || (n > 0 && copies * n >= limit))
+				{
+					return limit;
+				}
+				return copies * n;
+			}
+		case Text::TYPE:
+			{
+				const string& text = reinterpret_cast<Text*>(expression)->getText();
+				unsigned int n = 0, i = 0;
+				while (i < text.length())
+				{
+					Util::next_utf8(text, i);
+					n++;
+				}
+				return min(n, limit);
+			}
+		case Character::TYPE:
+		case Range::TYPE:
+		case CharClass::TYPE:
+			return 1;
+		default:
+			return limit;
+		}
+	}
+
+	/**
+	 * The sets of each type of expression are built as follows (where "e" is a sub-expression):
+	 *  - characters, ranges and classes: a position;
+	 *  - texts: the concatenation of a position for each character;
+	 *  - sequences: the concatenation of the expressions;
+	 *  - alternatives: the union of the sets of the alternatives;
+	 *  - e{min,}: "e" concatenated min-1 times, followed by "e+" (or just "e+" with an empty match when min is 0);
+	 *  - e{min,max}: "e" concatenated min times, followed by nested optional occurrences "(e(e(...)?)?)?", which keeps
+	 *    the automaton deterministic (unlike "e?e?...").
+	 */
+	BitParallel::Sets BitParallel::build(ICompilable* expression)
+	{
+		switch (expression->type())
+		{
+		case Sequence::TYPE:
+			{
+				Sets s = {true, 0, 0};
+				for (ICompilable* e: expression->dependences())
+				{
+					s = concat(s, build(e));
+				}
+				return s;
+			}
+		case Alternative::TYPE:
+			{
+				Sets s = {false, 0, 0};
+				for (ICompilable* e: expression->dependences())
+				{
+					Sets a = build(e);
+					s.nullable = s.nullable || a.nullable;
+					s.first |= a.first;
+					s.last |= a.last;
+				}
+				return s;
+			}
+		case Quantified::TYPE:
+			{
+				Quantified* q = reinterpret_cast<Quantified*>(expression);
+				ICompilable* e = q->dependences()[0];
+				Sets s = {true, 0, 0};
+				if (q->getMax() == Quantified::INF)
+				{
+					for (unsigned int i = 1; i < q->getMin(); i++)
+					{
+						s = concat(s, build(e));
+					}
+					Sets loop = repeat(build(e));
+					loop.nullable = loop.nullable || q->getMin() == 0;
+					return concat(s, loop);
+				}
+				for (unsigned int i = 0; i < q->getMin(); i++)
+				{
+					s = concat(s, build(e));
+				}
+				vector<Sets> optional;
+				for (unsigned int i = q->getMin(); i < q->getMax(); i++)
+				{
+					optional.push_back(build(e));
+				}
+				if (optional.empty())
+				{
+					return s;
+				}
+				Sets tail = optional.back();
+				tail.nullable = true;
+				for (int i = optional.size() - 2; i >= 0; i--)
+				{
+					tail = concat(optional[i], tail);
+					tail.nullable = true;
+				}
+				return concat(s, tail);
+			}
+		case Text::TYPE:
+			{
+				const string& text = reinterpret_cast<Text*>(expression)->getText();
+				Sets s = {true, 0, 0};
+				unsigned int i = 0;
+				while (i < text.length())
+				{
+					unsigned int c = Util::next_utf8(text, i);
+					IntervalSet set;
+					set.add(c, c);
+					s = concat(s, position(set));
+				}
+				return s;
+			}
+		default:
+			{
+				// Characters, ranges and classes of characters match a single character of their first set.
+				IntervalSet set;
+				expression->first(set);
+				return position(set);
+			}
+		}
+	}
+
+	BitParallel::Sets BitParallel::position(const IntervalSet& set)
+	{
+		uint64_t bit = (uint64_t)1 << positions.size();
+		positions.push_back(set);
+		follow.push_back(0);
+		return {false, bit, bit};
+	}
+
+	BitParallel::Sets BitParallel::concat(const Sets& a, const Sets& b)
+	{
+		for (unsigned int i = 0; i < positions.size(); i++)
+		{
+			if ((a.last >> i) & 1)
+			{
+				follow[i] |= b.first;
+			}
+		}
+		return {
+			a.nullable && b.nullable, 
+			a.first | (a.nullable ? b.first : 0), 
+			b.last | (b.nullable ? a.last : 0)
+		};
+	}
+
+	BitParallel::Sets BitParallel::repeat(const Sets& a)
+	{
+		for (unsigned int i = 0; i < positions.size(); i++)
+		{
+			if ((a.last >> i) & 1)
+			{
+				follow[i] |= a.first;
+			}
+		}
+		return a;
+	}
+
+	bool BitParallel::deterministic(uint64_t set)
+	{
+		IntervalSet seen;
+		for (unsigned int i = 0; i < positions.size(); i++)
+		{
+			if ((set >> i) & 1)
+			{
+				IntervalSet common(seen);
+				common.intersect(positions[i]);
+				if (!common.empty())
+				{
+					return false;
+				}
+				seen.add(positions[i]);
+			}
+		}
+		return true;
+	}
+
+	bool BitParallel::supported()
+	{
+		return valid;
+	}
+
+	unsigned int BitParallel::size()
+	{
+		return positions.size();
+	}
+
+	/**
+	 * compiled code:
+	 * %cprototype()% {
+	 *  int pos = %funcname()%(text), pchain;
+	 *  if (pos == -1) return -1;
+	 *  pchain = chain_next(text + pos, chain);
+	 *  if (pchain == -1) return -1;
+	 *  return pos + pchain;
+	 * }
+	 */
+	string BitParallel::ccompile()
+	{
+		stringstream s;
+		s << this->cprototype() << " {"										"\n"
+			 " int pos = " << this->funcname() << "(text), pchain;"			"\n"
+			 " if (pos == -1) return -1;"									"\n"
+			 " pchain = chain_next(text + pos, chain);"						"\n"
+			 " if (pchain == -1) return -1;"								"\n"
+			 " return pos + pchain;"										"\n"
+			 "}"															"\n\n";
+		return s.str();
+	}
+
+	/**
+	 * Only the ASCII characters accepted by some position are initialized on the ascii table.
+	 * compiled code:
+	 * %prototype()% {
+	 *  static const uint64_t follow[] = {%follow[0]%,...};
+	 *  static const uint64_t ascii[128] = {[%c%] = %positions that accept c%,...};
+	 *  static const unsigned int ranges[] = {%start%,%end%,...};
+	 *  static const int index[] = {%index of the first range of each position%,...,%number of ranges%};
+	 *  static const bp_automaton a = {%first%, %last%, %nullable%, %size()%, follow, ascii, ranges, index};
+	 *  return bp_match(&a, text);
+	 * }
+	 */
+	string BitParallel::compile()
+	{
+		stringstream s;
+		vector<unsigned int> ranges, index;
+		vector<uint64_t> ascii(128, 0);
+		for (unsigned int i = 0; i < positions.size(); i++)
+		{
+			index.push_back(ranges.size() / 2);
+			for (auto& r: positions[i])
+			{
+				ranges.push_back(r.first);
+				ranges.push_back(r.second);
+				for (unsigned int c = r.first; c <= r.second && c < 128; c++)
+				{
+					ascii[c] |= (uint64_t)1 << i;
+				}
+			}
+		}
+		index.push_back(ranges.size() / 2);
+		s << this->prototype() << " {"										"\n"
+			 " static const uint64_t follow[] = {";
+		for (unsigned int i = 0; i < follow.size(); i++)
+		{
+			if (i > 0) s << ",";
+			if (follow.size() > 4 && i % 4 == 0) s << "\n   ";
+			s << mask(follow[i]);
+		}
+		s << "};"															"\n"
+			 " static const uint64_t ascii[128] = {";
+		unsigned int n = 0;
+		for (unsigned int c = 0; c < 128; c++)
+		{
+			if (ascii[c] == 0) continue;
+			if (n > 0) s << ",";
+			if (n % 4 == 0) s << "\n   ";
+			s << "[" << c << "] = " << mask(ascii[c]);
+			n++;
+		}
+		if (n == 0)
+		{
+			s << "0";
+		}
+		s << "};"															"\n"
+			 " static const unsigned int ranges[] = {";
+		for (unsigned int i = 0; i < ranges.size(); i++)
+		{
+			if (i > 0) s << ",";
+			if (ranges.size() > 32 && i % 32 == 0) s << "\n   ";
+			s << ranges[i];
+		}
+		if (ranges.empty())
+		{
+			s << "0";
+		}
+		s << "};"															"\n"
+			 " static const int index[] = {";
+		for (unsigned int i = 0; i < index.size(); i++)
+		{
+			if (i > 0) s << ",";
+			if (index.size() > 32 && i % 32 == 0) s << "\n   ";
+			s << index[i];
+		}
+		s << "};"															"\n"
+			 " static const bp_automaton a = {" << mask(sets.first) << ", " << mask(sets.last) << ", " 
+		  << (sets.nullable ? 1 : 0) << ", " << positions.size() << ", follow, ascii, ranges, index};"	"\n"
+			 " return bp_match(&a, text);"									"\n"
+			 "}"															"\n\n";
+		return s.str();
+	}
+
+	bool BitParallel::nullable()
+	{
+		return expr->nullable();
+	}
+
+	void BitParallel::first(IntervalSet& set)
+	{
+		expr->first(set);
+	}
+
+	string BitParallel::str()
+	{
+		return expr->str();
+	}
+
+	string BitParallel::name()
+	{
+		return intern("bp", expr->name());
+	}
+
+	/**
+	 * \returns the type identifier of this class.
+	 */
+	int BitParallel::type()
+	{
+		return TYPE;
+	}
+
+	#ifdef _DEBUG
+	void BitParallel::print(int level)
+	{
+		for (int i = 0; i < level; i++)
+		{
+			cout << '.';
+		}
+		cout << "BITPARALLEL(@" << hex << this << ", POSITIONS=" << dec << positions.size() << ")" << endl;
+		this->expr->print(level+1);
+	}
+	#endif
+
+} /* namespace pgen */
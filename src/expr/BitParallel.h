@@ -0,0 +1,185 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-24
+ * \file
+ * The BitParallel class matches an expression with the bit-parallel engine instead of the backtracking code generated
+ * by the other ICompilable classes. Each character matched by the expression is a position of a Glushkov automaton 
+ * (e.g. "a(b|c)*d" has the positions a1, b2, c3 and d4), and the automaton is described by:
+ *  - first: the positions that can match the first character of the text (a1);
+ *  - last: the positions that can match the last character of the text (d4);
+ *  - follow[i]: the positions that can match the character after the one matched by position i (follow[a1] = 
+ *    follow[b2] = follow[c3] = {b2, c3, d4});
+ *  - ascii[c]: the positions that accept the ASCII character c (the other characters are tested against the ranges
+ *    of each position).
+ * The sets of positions are bit masks, so an expression with up to 64 positions is matched with a few operations on
+ * a single machine word per character (see bp_match on Code::bitParallelRuntime), without backtracking.
+ * The engine finds the longest match, which is the same one found by the backtracking code only when the automaton
+ * is deterministic (no character can be matched by two positions of the same set), all the quantifiers are greedy,
+ * and only the last alternative of a group can match the empty text. The engine is only used for the expressions
+ * that meet those conditions (see BitParallel::supported()), and only for the tokens that may backtrack 
+ * catastrophically when the language enables the automaton engines (see TokenType), since it is faster than the
+ * linear-time engine (see Linear) but slower than the backtracking code of the expressions that do not backtrack
+ * much.
+ */
+
+#ifndef BITPARALLEL_H_
+#define BITPARALLEL_H_
+
+// STL
+#include <string>
+#include <vector>
+#include <cstdint>
+// pgen
+#include "ICompilable.h"
+#include "../misc/IntervalSet.h"
+
+using namespace std;
+namespace pgen
+{
+	class BitParallel
+	 : public ICompilable
+	{
+	private:
+		/**
+		 * The Glushkov sets of a sub-expression.
+		 */
+		struct Sets
+		{
+			bool nullable;					//< True when the sub-expression matches the empty text.
+			uint64_t first;					//< The positions that can match the first character.
+			uint64_t last;					//< The positions that can match the last character.
+		};
+
+		ICompilable* expr;					//< The expression (not owned by the BitParallel object).
+		bool valid;							//< True when the automaton matches the same texts as the expression.
+		vector<IntervalSet> positions;		//< The characters accepted by each position.
+		vector<uint64_t> follow;			//< The positions that can follow each position.
+		Sets sets;							//< The sets of the whole expression.
+
+		/**
+		 * Checks the conditions under which the longest match is the match of the backtracking code.
+		 * \param expression the expression to check.
+		 * \return true when the quantifiers are greedy, their expressions can not match the empty text and only the 
+		 * last alternative of each group can match the empty text.
+		 */
+		static bool greedy(ICompilable* expression);
+		/**
+		 * Counts the positions of an expression, up to MAX_POSITIONS + 1.
+		 */
+		static unsigned int count(ICompilable* expression);
+		/**
+		 * Adds the positions of an expression to the automaton.
+		 * \return the sets of the expression.
+		 */
+		Sets build(ICompilable* expression);
+		/**
+		 * Adds a position that accepts a set of characters to the automaton.
+		 * \return the sets of the position.
+		 */
+		Sets position(const IntervalSet& set);
+		/**
+		 * Makes the positions of "b" follow the last positions of "a".
+		 * \return the sets of the concatenation "ab".
+		 */
+		Sets concat(const Sets& a, const Sets& b);
+		/**
+		 * Makes the first positions of "a" follow its last positions.
+		 * \return the sets of the repetition "a+".
+		 */
+		Sets repeat(const Sets& a);
+		/**
+		 * \return true when no character is accepted by two positions of a set.
+		 */
+		bool deterministic(uint64_t set);
+	public:
+		static const unsigned int MAX_POSITIONS = 64;
+
+		/**
+		 * Builds the automaton of an expression.
+		 * \param expression the expression. It is not owned by the BitParallel object, so it must outlive it.
+		 */
+		BitParallel(ICompilable* expression);
+		virtual ~BitParallel();
+
+		/**
+		 * \return true when the expression has up to MAX_POSITIONS positions and the automaton finds the same 
+		 * matches as the backtracking code. The compiled code of an unsupported automaton must not be used.
+		 */
+		bool supported();
+		/**
+		 * \return the number of positions of the automaton.
+		 */
+		unsigned int size();
+
+		// ICompilable Methods Implementation
+		/**
+		 * Returns C code that can parse the regular expression.
+		 * The returned code should be a function with the following
+		 * prototype: int expr_name(char *text, int (*chain[])());
+		 * the function must return the numbers of consumed bytes on success or -1 on failure.
+		 * The bit-parallel engine does not backtrack, so the chain is only called with the text that follows the
+		 * match of the expression.
+		 * \return the chainable compiled C code that parses the expression.
+		 */
+		virtual string ccompile();
+		/**
+		 * Returns C code that can parse the regular expression.
+		 * the returned code shuld be a function with the following prototype:
+		 * int expr_name(char *text);
+		 * The function must return the numbers of consumed bytes on success or -1 on failure.
+		 * This version of the function is not chainable.
+		 * \return the compiled C code that parses the expression.
+		 */
+		virtual string compile();
+		/**
+		 * \returns true when the expression is nullable (see ICompilable::nullable()).
+		 */
+		virtual bool nullable();
+		/**
+		 * Adds the first characters of the expression to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the regular expression of the expression (see ICompilable::str()).
+		 */
+		virtual string str();
+		/**
+		 * Returns the name of the expression. The returned name must be usable as a function
+		 * name in the standard C (C99). i.e. it has to match the following format:
+		 * [a-zA-Z][A-Za-z0-9_]*
+		 * \return The text "bp" followed by the id of the expression (see ICompilable::intern()).
+		 */
+		virtual string name();
+		/**
+		 * \returns the type identifier of this class.
+		 */
+		virtual int type();
+
+		#ifdef _DEBUG
+		virtual void print(int level = 0);
+		#endif
+
+		static const int TYPE = 9;
+	}; /* class BitParallel */
+} /* namespace pgen */
+
+#endif /* BITPARALLEL_H_ */
@@ -34,6 +34,9 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
 // Other
 #include "Character.h"
 #include "CharClass.h"
@@ -41,6 +44,7 @@
 #include "RegexEscape.h"
 #include "../parser/NamedClassManager.h"
 #include "../misc/Util.h"
+#include "../misc/UnicodeData.h"
 #include "../misc/RegexException.h"
 
 using namespace std;
@@ -77,7 +81,7 @@ namespace pgen
 		return s.str();
 	}
 
-	CharClass* CharClass::parse(string& expression, unsigned int& pos, NamedClassManager& ncm)
+	CharClass* CharClass::parse(string& expression, unsigned int& pos, NamedClassManager& ncm, bool ignoreCase)
 	{
 		stringstream namedClass;
 		unsigned int c = Util::next_utf8(expression, pos);
@@ -159,6 +163,10 @@ namespace pgen
 						cClass->add(lastChar);
 						lastChar = UINT_MAX;
 					}
+					if (ignoreCase)
+					{
+						cClass->fold();
+					}
 					cClass->normalize();
 					return cClass;
 				// When it's the '-' char, it could be the beggining of a range, or just the char itself.
@@ -207,6 +215,10 @@ namespace pgen
 							case ']':
 								cClass->add(lastChar);
 								cClass->add('-');
+								if (ignoreCase)
+								{
+									cClass->fold();
+								}
 								cClass->normalize();
 								return cClass;
 							// When it's the end of the stream, it's an error.
@@ -254,61 +266,19 @@ namespace pgen
 	void CharClass::add(unsigned int c) 
 	{
 		add(c,c);
-		// TODO zzz create a more efficient way of doing this with a single char, if possible.
 	}
 
 	void CharClass::add(unsigned int cstart, unsigned int cend) 
 	{
-		Range * v = this->range, * t = nullptr;
-		// If this is the first interval, just add it
-		if (v == nullptr) 
-		{
-			this->range = new Range(cstart, cend);
-			return;
-		}
-		// If this isn't the first interval, try to find an interval to merge with
-		// The search should stop if one of the following conditions is satisfied:
-		// 1. An insert happened (in which case the method must merge, stop and return)
-		// 2. The end of the list of intervals was reached (then the interval must be added to the end)
-		// 3. All the following intervals' boundareis are greater than the proposed new interval (then the interval must be added to the current position)
-		while (v != nullptr && cend+1 >= v->start) 
-		{
-			if (v->join(cstart, cend)) 
-			{ // if an insert happened
-				this->merge(v); // merge the interval that changed nad return
-				return;
-			}
-			t = v;
-			v = v->next;
-		}
-		// if the search reached the end of the list, append a new interval to the end of the list.
-		if (v == nullptr) 
-		{
-			v = new Range(cstart, cend);
-			v->prev = t;	// if the code reached this point, "t" will not be null. it represents the previous interval.
-			v->next = t->next;
-			t->next = v;
-		}
-		// else if there was no merging and it is not the end of the list, create a new interval and insert it on the list accordingly.
-		else 
-		{
-			t = new Range(cstart, cend);
-			t->next = v;
-			t->prev = v->prev;
-			v->prev = t;
-			if (t->prev == nullptr) this->range = t;
-			else t->prev->next = t;
-		}
+		// the character 0 (end of text) is never accepted, it is replaced by 1 (see Range::Range()).
+		if (cstart == 0) cstart = 1;
+		if (cend == 0) cend = 1;
+		ranges.add(cstart, cend);
 	}
 	
 	void CharClass::add(const CharClass& c)
 	{
-		Range * r = c.range;
-		while (r != nullptr) 
-		{
-			this->add(r->start, r->end);
-			r = r->next;
-		}
+		ranges.add(c.ranges);
 	}
 
 	void CharClass::add(CharClass * c) 
@@ -316,35 +286,22 @@ namespace pgen
 		this->add(const_cast<const CharClass&>(*c));
 	}
 
-	void CharClass::merge(Range * v) 
+	void CharClass::add(const IntervalSet& set)
 	{
-		Range * t;
-		// merge backwards on the linked list, removing the merged elements
-		while (v->prev != nullptr && v->prev->join(v)) 
+		for (auto& r: set)
 		{
-			t = v;
-			v = t->prev;
-			v->next = t->next;
-			if (v->next != nullptr) 
-			{
-				v->next->prev = v;
-			}
-			delete t;
+			this->add(r.first, r.second);
 		}
-		// merge forward on the linked list, removing the merged elements
-		while (v->next != nullptr && v->next->join(v)) 
-		{
-			t = v;
-			v = t->next;
-			v->prev = t->prev;
-			if (v->prev != nullptr) 
-			{ 
-				v->prev->next = v;
-			}
-			delete t;
-		}
-		// if the head element was merged, update the head pointer.
-		if (v->prev == nullptr) this->range = v;
+	}
+
+	void CharClass::intersect(const CharClass& c)
+	{
+		ranges.intersect(c.ranges);
+	}
+
+	void CharClass::fold()
+	{
+		UnicodeData::fold(ranges);
 	}
 
 	void CharClass::normalize() 
@@ -358,122 +315,269 @@ namespace pgen
 
 	void CharClass::invert() 
 	{
-		unsigned int s = 1, e;
-		Range * v = range;
-		if (v == nullptr) 
-		{
-			range = new Range(1,UINT_MAX);
-			return;
-		}
-		// if the first interval starts from 1, then the inverse starts after 1.
-		if (v != nullptr && v->start == 1) 
-		{
-			e = v->end;
-			s = v->end+1;
-			range = v->next;
-			delete v;
-		}
-		// change every following interval to its negation
-		v = range;
-		while (v != nullptr) 
-		{
-			e = v->end;
-			v->end = v->start-1;
-			v->start = s;
-			s = e + 1;
-			if (v->next == nullptr) break;
-			v = v->next;
-		}
-
-		// if the last interval didn't end in UINT_MAX create a new interval that contains
-		// all the remaining characters from the current character to UINT_MAX
-		if (e < UINT_MAX) 
-		{
-			if (v != nullptr) 
-			{
-				v->next = new Range(s,UINT_MAX);
-				v->next->prev = v;
-			} 
-			else 
-			{
-				range = new Range(s,UINT_MAX);
-			}
-		}
+		ranges.invert(1, UINT_MAX);
 	}
 
 	CharClass::CharClass()
-	 : range(nullptr)
-	 , negated(false) 
+	 : negated(false) 
 	{
 	}
 	
 	CharClass::CharClass(const CharClass& cClass)
-	 : range(nullptr)
+	 : ranges(cClass.ranges)
 	 , negated(cClass.negated)
 	{
-		this->add(cClass);
 	}
 	
 	CharClass::~CharClass() 
 	{
-		Range * next;
-		while (range != nullptr) 
+	}
+
+	bool CharClass::operator==(const CharClass & c) const 
+	{
+		return (c.negated == this->negated && c.ranges == this->ranges);
+	}
+
+	bool CharClass::operator!=(const CharClass &c) const 
+	{
+		return !(*this == c);
+	}
+
+	/**
+	 * Builds a C expression that compares "c" (or another variable) with a list of ranges, omitting the comparisons 
+	 * that are always true inside the interval [lo, hi].
+	 */
+	static string compares(const vector<pair<unsigned int, unsigned int>>& ranges, unsigned int lo, unsigned int hi,
+		const string& c = "c")
+	{
+		stringstream s;
+		if (ranges.empty()) 
 		{
-			next = range->next;
-			delete range;
-			range = next;
+			return "0";
 		}
+		for (unsigned int i = 0; i < ranges.size(); i++)
+		{
+			bool checkStart = (ranges[i].first > lo), checkEnd = (ranges[i].second < hi);
+			if (!checkStart && !checkEnd) 
+			{
+				return "1";
+			}
+			if (i > 0) s << " || ";
+			s << "(";
+			if (checkStart && checkEnd && ranges[i].first == ranges[i].second)
+			{
+				s << c << " == " << ranges[i].first << ")";
+				continue;
+			}
+			if (checkStart) s << c << " >= " << ranges[i].first;
+			if (checkStart && checkEnd) s << " && ";
+			if (checkEnd) s << c << " <= " << ranges[i].second;
+			s << ")";
+		}
+		return s.str();
 	}
 
-	bool CharClass::operator==(const CharClass & c) const 
+	/**
+	 * Checks if a list of ranges holds only ASCII letters, each one along with its other case (e.g. [sS] or 
+	 * [a-fA-F]), in which case the ranges of the lower case letters are added to "lower".
+	 */
+	static bool caseless(const vector<pair<unsigned int, unsigned int>>& ranges, 
+		vector<pair<unsigned int, unsigned int>>& lower)
 	{
-		if (c.negated != this->negated) return false;
-		Range * vc = c.range, * vt = this->range;
-		while (vc != nullptr && vt != nullptr) 
+		IntervalSet upperCase, lowerCase;
+		for (auto& r: ranges)
+		{
+			if (r.first >= 'A' && r.second <= 'Z')
+			{
+				upperCase.add(r.first + 32, r.second + 32);
+			}
+			else if (r.first >= 'a' && r.second <= 'z')
+			{
+				lowerCase.add(r.first, r.second);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		if (lowerCase.empty() || upperCase != lowerCase)
+		{
+			return false;
+		}
+		for (auto& r: lowerCase)
 		{
-			if (*vc != *vt) return false;
-			vc = vc->next;
-			vt = vt->next;
+			lower.push_back(r);
 		}
-		return (vc == nullptr && vt == nullptr);
+		return true;
 	}
 
-	bool CharClass::operator!=(const CharClass &c) const 
+	/**
+	 * Writes a C array initializer, breaking a line every 32 values.
+	 */
+	static void initializer(stringstream& s, const vector<unsigned int>& values)
 	{
-		return !(*this == c);
+		s << "{";
+		for (unsigned int i = 0; i < values.size(); i++)
+		{
+			if (i > 0) s << ",";
+			if (values.size() > 32 && i % 32 == 0) s << "\n   ";
+			s << values[i];
+		}
+		s << "}";
+	}
+
+	/**
+	 * Classes of ASCII letters in both cases (e.g. the case insensitive [sS]) are tested by comparing the lower case 
+	 * of "c", i.e. (c | 32), with the lower case letters. Setting the bit 5 maps exactly the upper and lower case 
+	 * letters into the interval 'a'..'z', so no other character can match. 
+	 * Classes with up to MAX_COMPARES ranges are tested with a comparison for each range. Larger classes are split
+	 * in three parts:
+	 *  - Latin-1 characters (c < 256) are tested with a 256-bit bitmap (bm);
+	 *  - The remaining Unicode characters (c < 0x110000) are tested with comparisons (up to MAX_COMPARES ranges), a
+	 *    binary search on the list of ranges (up to MAX_SEARCH ranges, see in_ranges on Code::helperCode) or a 
+	 *    two-level table (st1 maps each block of 256 characters to a 256-bit bitmap of st2);
+	 *  - Characters outside of the Unicode space are tested with comparisons.
+	 * expression:
+	 *  (c < 256 ? %latin-1% : c < 0x110000 ? %unicode% : %others%)
+	 */
+	string CharClass::membership(string& tables)
+	{
+		vector<pair<unsigned int, unsigned int>> all, latin, unicode, others;
+		for (auto& r: ranges)
+		{
+			all.push_back(r);
+			if (r.first <= 0xFF) 
+			{
+				latin.push_back(make_pair(r.first, min(r.second, 0xFFu)));
+			}
+			if (r.second >= 0x100 && r.first <= 0x10FFFF) 
+			{
+				unicode.push_back(make_pair(max(r.first, 0x100u), min(r.second, 0x10FFFFu)));
+			}
+			if (r.second >= 0x110000) 
+			{
+				others.push_back(make_pair(max(r.first, 0x110000u), r.second));
+			}
+		}
+		vector<pair<unsigned int, unsigned int>> lower;
+		if (caseless(all, lower) && lower.size() <= MAX_COMPARES)
+		{
+			return compares(lower, 0, UINT_MAX, "(c | 32)");
+		}
+		if (all.size() <= MAX_COMPARES)
+		{
+			return compares(all, 0, UINT_MAX);
+		}
+		stringstream s, t;
+		s << "(c < 256 ? ";
+		if (latin.size() <= 1)
+		{
+			s << compares(latin, 0, 0xFF);
+		}
+		else
+		{
+			vector<unsigned int> bm(32, 0);
+			for (auto& r: latin)
+			{
+				for (unsigned int c = r.first; c <= r.second; c++) 
+				{
+					bm[c >> 3] |= 1 << (c & 7);
+				}
+			}
+			t << "  static const unsigned char bm[32] = ";
+			initializer(t, bm);
+			t << ";"																			"\n";
+			s << "(bm[c >> 3] >> (c & 7)) & 1";
+		}
+		s << " : c < 0x110000 ? ";
+		if (unicode.size() <= MAX_COMPARES)
+		{
+			s << compares(unicode, 0x100, 0x10FFFF);
+		}
+		else if (unicode.size() <= MAX_SEARCH)
+		{
+			vector<unsigned int> rg;
+			for (auto& r: unicode)
+			{
+				rg.push_back(r.first);
+				rg.push_back(r.second);
+			}
+			t << "  static const unsigned int rg[" << rg.size() << "] = ";
+			initializer(t, rg);
+			t << ";"																			"\n";
+			s << "in_ranges(c, rg, " << unicode.size() << ")";
+		}
+		else
+		{
+			// stage 2 holds the distinct bitmaps of the blocks, the first one is empty.
+			vector<vector<unsigned int>> blocks(1, vector<unsigned int>(32, 0));
+			map<vector<unsigned int>, unsigned int> index;
+			vector<unsigned int> st1(0x1100, 0);
+			index[blocks[0]] = 0;
+			for (unsigned int b = 1; b < 0x1100; b++)
+			{
+				vector<unsigned int> bm(32, 0);
+				for (auto& r: unicode)
+				{
+					unsigned int start = max(r.first, b << 8), end = min(r.second, (b << 8) | 0xFF);
+					for (unsigned int c = start; c <= end && start <= end; c++)
+					{
+						bm[(c >> 3) & 31] |= 1 << (c & 7);
+					}
+				}
+				auto it = index.find(bm);
+				if (it == index.end())
+				{
+					it = index.insert(make_pair(bm, blocks.size())).first;
+					blocks.push_back(bm);
+				}
+				st1[b] = it->second;
+			}
+			t << "  static const unsigned " << (blocks.size() <= 256 ? "char" : "short") << " st1[4352] = ";
+			initializer(t, st1);
+			t << ";"																			"\n"
+				 "  static const unsigned char st2[" << blocks.size() << "][32] = {";
+			for (unsigned int i = 0; i < blocks.size(); i++)
+			{
+				if (i > 0) t << ",";
+				t << "\n   ";
+				initializer(t, blocks[i]);
+			}
+			t << "};"																			"\n";
+			s << "(st2[st1[c >> 8]][(c >> 3) & 31] >> (c & 7)) & 1";
+		}
+		s << " : " << compares(others, 0x110000, UINT_MAX) << ")";
+		tables += t.str();
+		return s.str();
 	}
 
 	/**
 	 * compiled code:
 	 * %cprototype()% {
+	 *  %tables (see CharClass::membership())%
 	 *  int pos = 0, pchain = 0;
-	 *  unsigned int c = next_utf8(text, pos);
-	 *  %for each range r[n]:%
-	 *  if (c >= %r[n].start% && c <= %r[n].end%) {
+	 *  unsigned int c = %decode()%;
+	 *  if (%membership()%) {
 	 *   pchain = chain_next(text + pos, chain);
 	 *   if (pchain >= 0) return pchain + pos;
 	 *  }
-	 *  %end for%
 	 *  return -1;
+	 * }
 	 */
 	string CharClass::ccompile() 
 	{
 		stringstream s;
+		string tables;
+		string test = this->membership(tables);
 		s << 
 			this->cprototype() << " {" 												"\n"
+		 << tables <<
 			" int pos = 0, pchain = 0;"												"\n"
-			" unsigned int c = next_utf8(text, &pos);"								"\n";
-		Range * r = this->range;
-		while (r != nullptr) 
-		{
-			s << 
-				" if (c >= " << r->start << " && " << "c <= " << r->end << ") {"	"\n"
-				"  pchain = chain_next(text + pos, chain);"							"\n"
-				"  if (pchain >= 0) return pchain + pos;"							"\n"
-				" }"																"\n";
-			r = r->next;
-		}
-		s << 
+			" unsigned int c = " << this->decode() << ";"							"\n"
+			" if (" << test << ") {"												"\n"
+			"  pchain = chain_next(text + pos, chain);"								"\n"
+			"  if (pchain >= 0) return pchain + pos;"								"\n"
+			" }"																	"\n"
 			" return -1;" 															"\n"
 			"}"																		"\n\n";
 		return s.str();
@@ -482,29 +586,106 @@ namespace pgen
 	/**
 	 * compiled code:
 	 * %prototype()% {
+	 *  %tables (see CharClass::membership())%
 	 *  int pos = 0;
-	 *  unsigned int c = next_utf8(text, pos);
-	 *  %for each range r[n]:%
-	 *  if (c >= %r[n].start% && c <= %r[n].end%) return pos;
-	 *  %end for%
+	 *  unsigned int c = %decode()%;
+	 *  if (%membership()%) return pos;
 	 *  return -1;
+	 * }
 	 */
 	string CharClass::compile() 
 	{
 		stringstream s;
+		string tables;
+		string test = this->membership(tables);
 		s << 
-			this->prototype() << " {"														"\n"
-			" int pos = 0;"																	"\n"
-			" unsigned int c = next_utf8(text, &pos);"										"\n";
-		Range * r = this->range;
-		while (r != nullptr) 
+			this->prototype() << " {"												"\n"
+		 << tables <<
+			" int pos = 0;"															"\n"
+			" unsigned int c = " << this->decode() << ";"							"\n"
+			" if (" << test << ") return pos;"										"\n"
+			" return -1;" 															"\n"
+			"}"																		"\n";
+		return s.str();
+	}
+
+	string CharClass::decode()
+	{
+		for (auto& r: ranges)
 		{
-			s << " if (c >= " << r->start << " && " << "c <= " << r->end << ") return pos;"	"\n";
-			r = r->next;
+			if (r.second > 0x7F)
+			{
+				return "next_utf8(text, &pos)";
+			}
 		}
-		s << 
-			" return -1;" 																	"\n"
-			"}"																				"\n";
+		return "(unsigned char)text[pos++]";
+	}
+
+	bool CharClass::deterministic()
+	{
+		return true;
+	}
+
+	/**
+	 * inlined code:
+	 *  {
+	 *   %tables (see CharClass::membership())%
+	 *   unsigned int c = %decode()%;
+	 *   if (!(%membership()%)) return -1;
+	 *  }
+	 */
+	string CharClass::icompile()
+	{
+		stringstream s;
+		string tables;
+		string test = this->membership(tables);
+		s << " {"																	"\n"
+		  << tables <<
+			 "  unsigned int c = " << this->decode() << ";"						"\n"
+			 "  if (!(" << test << ")) return -1;"									"\n"
+			 " }"																	"\n";
+		return s.str();
+	}
+
+	void CharClass::first(IntervalSet& set)
+	{
+		if (negated)
+		{
+			IntervalSet inverted(ranges);
+			inverted.invert(1, UINT_MAX);
+			set.add(inverted);
+		}
+		else
+		{
+			set.add(ranges);
+		}
+	}
+
+	string CharClass::str()
+	{
+		IntervalSet all;
+		this->first(all);
+		if (all.size() == 1 && all.begin()->first <= 1 && all.begin()->second == UINT_MAX)
+		{
+			return ".";
+		}
+		stringstream s;
+		s << (negated ? "[^" : "[");
+		unsigned int count = 0;
+		for (auto& r: ranges)
+		{
+			if (count++ == 8)
+			{
+				s << "...";
+				break;
+			}
+			s << Util::int2regex(r.first);
+			if (r.second != r.first)
+			{
+				s << "-" << Util::int2regex(r.second);
+			}
+		}
+		s << "]";
 		return s.str();
 	}
 
@@ -512,11 +693,13 @@ namespace pgen
 	{
 		stringstream s;
 		s << "cl";
-		Range * r = this->range;
-		while (r != nullptr) 
+		for (auto& r: ranges)
+		{
+			s << "_" << r.first << "_" << r.second;
+		}
+		if (ranges.size() > MAX_COMPARES)
 		{
-			s << "_" << r->start << "_" << r->end;
-			r = r->next;
+			return intern("cl", s.str());
 		}
 		return s.str();
 	}
@@ -532,22 +715,15 @@ namespace pgen
 	#ifdef _DEBUG
 	void CharClass::print(int level)
 	{
-		int sz = 0;
 		for (int i = 0; i < level; i++) 
 		{
 			cout << '.';
 		}
-		Range* r = range;
-		while (r != nullptr)
-		{
-			++sz;
-			r = r->next;
-		}
-		cout << "CLASS(@" << hex << this << ", SZ=" << dec << sz << ")" << endl;
+		cout << "CLASS(@" << hex << this << ", SZ=" << dec << ranges.size() << ")" << endl;
 		level++;
-		for (r = range; r != nullptr; r = r->next)
+		for (auto& r: ranges)
 		{
-			r->print(level);
+			Range(r.first, r.second).print(level);
 		}
 	}
 	#endif
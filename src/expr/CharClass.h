@@ -42,6 +42,7 @@ namespace pgen
 // pgen
 #include "Range.h"
 #include "ICompilable.h"
+#include "../misc/IntervalSet.h"
 #include "../parser/NamedClassManager.h"
 
 using namespace std;
@@ -49,9 +50,35 @@ namespace pgen {
 	class CharClass 
 	 : public ICompilable {
 	private:
-		Range * range;
+		IntervalSet ranges;		//< Accepted characters.
 		bool negated;
+
+		/**
+		 * Returns a C expression that is true when the unsigned int variable "c" belongs to the class. The technique
+		 * used to test the membership depends on the size of the class (see CharClass.cpp).
+		 * \param tables string to append the declarations of the lookup tables used by the expression to. They are
+		 * block-scope static constants, so they must be declared inside the same block as the expression.
+		 * \return the C expression that tests the membership of "c".
+		 */
+		string membership(string& tables);
+		/**
+		 * Returns a C expression that reads the next character of the text (at "text + pos") and advances "pos". 
+		 * Classes of ASCII characters read a single byte: any byte that is not ASCII starts a character that does
+		 * not belong to the class, so there is no need to decode it.
+		 * \return the C expression that reads the next character.
+		 */
+		string decode();
 	public:
+		/**
+		 * Maximum number of ranges of a class that are tested with comparisons, instead of lookup tables.
+		 */
+		static const unsigned int MAX_COMPARES = 4;
+		/**
+		 * Maximum number of ranges above the Latin-1 characters that are found by a binary search, instead of a 
+		 * two-level table.
+		 */
+		static const unsigned int MAX_SEARCH = 64;
+
 		/**
 		 * \brief returns a CharClass that matches all characters
 		 * \return a CharClass pointer that matches all characters.
@@ -69,9 +96,11 @@ namespace pgen {
 		 * Parses a regular expression class definiton.
 		 * \param expression the regular expression
 		 * \param pos the index of the next character to read on the regular expression
+		 * \param ignoreCase when true, the case variants of the characters of the class are added to it (see
+		 * CharClass::fold()), before the class is negated.
 		 * \return CharClass the parsed class.
 		 */
-		static CharClass* parse(string& expression, unsigned int& pos, NamedClassManager& ncm);
+		static CharClass* parse(string& expression, unsigned int& pos, NamedClassManager& ncm, bool ignoreCase = false);
 		/**
 		 * Adds a character to the interval if it does not belong to the interval yet.
 		 * \param c unicode character to add to the interval.
@@ -102,17 +131,24 @@ namespace pgen {
 		 */
 		void add(CharClass* c);
 		/**
-		 * Merges(joins) all the intervals that can be merged, starting from the provided interval.
-		 * i.e. If the interval intersects with the next interval, they are joined and the current
-		 * interval is deleted. This process is repeated until no intervals need to be joined
-		 * forward or backwards.
-		 * \param v Interval to join with others.
+		 * Adds all the characters of a set of intervals to this CharClass (e.g. a Unicode property, see UnicodeData).
+		 * \param set the intervals of characters to add.
+		 */
+		void add(const IntervalSet& set);
+		/**
+		 * Removes all the characters that do not belong to another Class of Characters (intersection).
+		 * \param c the reference to the charclass to intersect with.
 		 */
-		void merge(Range * v);
+		void intersect(const CharClass& c);
 		/**
 		 * Inverts the accepted character intervals of a class (i.e. negates the accepted ranges).
 		 */
 		void invert();
+		/**
+		 * Adds the case variants of all the characters of the class to it (see UnicodeData::fold()), so that the
+		 * class matches the characters regardless of their case.
+		 */
+		void fold();
 		/**
 		 * Normalizes a class, i.e. if it is negated, it gets inverted and non-negated.
 		 */
@@ -151,10 +187,28 @@ namespace pgen {
 		 * \return the compiled C code that parses the expression.
 		 */
 		virtual string compile();
+		/**
+		 * \returns true, a class of characters always matches a single character.
+		 */
+		virtual bool deterministic();
+		/**
+		 * Returns C statements that match the class inline (see ICompilable::icompile()).
+		 * \return the inlined C statements that match the class.
+		 */
+		virtual string icompile();
+		/**
+		 * Adds all the accepted characters of the class to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the class of characters, e.g. "[0-9A-Fa-f]". Long classes are abbreviated with "...".
+		 */
+		virtual string str();
 		/**
 		 * Returns the name of the expression. The returned name must be usable as a function
 		 * name in the standard C (C99). i.e. it has to match the following format:
 		 * [a-zA-Z][A-Za-z0-9_]*
+		 * Classes with more than MAX_COMPARES ranges are named by the id of their ranges (see ICompilable::intern()).
 		 * \return The name of the expression (usable as function names).
 		 */
 		virtual string name();
@@ -32,6 +32,8 @@
 #include <sstream>
 // Other
 #include "Character.h"
+#include "Text.h"
+#include "../misc/Util.h"
 using namespace std;
 
 namespace pgen 
@@ -97,6 +99,52 @@ namespace pgen
 		return s.str();
 	}
 
+	bool Character::deterministic()
+	{
+		return true;
+	}
+
+	/**
+	 * The character is compared byte by byte with its utf-8 representation, which avoids decoding the text (see 
+	 * Text::compare). The invalid character replacement (0xFFFD) is also returned by next_utf8 on invalid sequences,
+	 * so it must be decoded.
+	 * inlined code (valid characters):
+	 *  %Text::compare(bytes)%
+	 * inlined code (0 and 0xFFFD):
+	 *  if (next_utf8(text, &pos) != %c%) return -1;
+	 */
+	string Character::icompile()
+	{
+		string bytes;
+		if (this->literal(bytes))
+		{
+			return Text::compare(bytes);
+		}
+		stringstream s;
+		s << " if (next_utf8(text, &pos) != " << c << ") return -1;"				"\n";
+		return s.str();
+	}
+
+	bool Character::literal(string& bytes)
+	{
+		if (c == 0 || c == 0xFFFD)
+		{
+			return false;
+		}
+		bytes += Util::int2utf8(c);
+		return true;
+	}
+
+	void Character::first(IntervalSet& set)
+	{
+		set.add(c, c);
+	}
+
+	string Character::str()
+	{
+		return Util::int2regex(c);
+	}
+
 	/**
 	 * \returns the name "chr_" + the integer value of the character.
 	 */
@@ -80,6 +80,28 @@ namespace pgen
 		 * \return the compiled C code that parses the expression.
 		 */
 		virtual string compile();
+		/**
+		 * \returns true, a single character can only be matched in a single way.
+		 */
+		virtual bool deterministic();
+		/**
+		 * Returns C statements that match the character inline (see ICompilable::icompile()).
+		 * \return the inlined C statements that match the character.
+		 */
+		virtual string icompile();
+		/**
+		 * Appends the utf-8 bytes of the character to "bytes" (see ICompilable::literal()).
+		 * \returns true unless the character is 0 or the invalid character replacement (0xFFFD).
+		 */
+		virtual bool literal(string& bytes);
+		/**
+		 * Adds the character to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the character, escaped when it is not printable or when it is a meta-character.
+		 */
+		virtual string str();
 		/**
 		 * Returns the name of the expression. The returned name must be usable as a function
 		 * name in the standard C (C99). i.e. it has to match the following format:
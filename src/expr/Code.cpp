@@ -51,6 +51,34 @@ namespace pgen
 		" struct _ast_node* firstChild;"																			"\n"
 		"} ast_node;"																								"\n"
 		""																											"\n"
+		"typedef struct _ast_block {"																				"\n"
+		" struct _ast_block* next;"																					"\n"
+		" int size;"																								"\n"
+		" ast_node* nodes;"																							"\n"
+		"} ast_block;"																								"\n"
+		""																											"\n"
+		"typedef struct _ast_arena {"																				"\n"
+		" ast_block* first;"																						"\n"
+		" ast_block* block;"																						"\n"
+		" int used;"																								"\n"
+		"} ast_arena;"																								"\n"
+		""																											"\n"
+		"typedef struct _ast_mark {"																				"\n"
+		" ast_block* block;"																						"\n"
+		" int used;"																								"\n"
+		"} ast_mark;"																								"\n"
+		""																											"\n"
+		/** The following type is a node of the array to which ast_flatten converts an AST: the nodes are stored in 
+		 *  pre-order and linked by indices (-1 when there is none), start and end are the indices of the tokens covered
+		 *  by the node. */
+		"typedef struct _ast_flat_node {"																			"\n"
+		" int tokenId;"																								"\n"
+		" int firstChild;"																							"\n"
+		" int nextSibling;"																							"\n"
+		" int start;"																								"\n"
+		" int end;"																									"\n"
+		"} ast_flat_node;"																							"\n"
+		""																											"\n"
 		"typedef struct _token {"																					"\n"
 		" int type;"																								"\n"
 		" char* value;"																								"\n"
@@ -61,11 +89,19 @@ namespace pgen
 		" char* data;"																								"\n"
 		" int count;"																								"\n"
 		" char* data_ptr;"																							"\n"
+		" ast_arena arena;"																							"\n"
 		"} token_list;"																								"\n"
 		""																											"\n"
+		"typedef struct _token_match {"																				"\n"
+		" int start;"																								"\n"
+		" int length;"																								"\n"
+		"} token_match;"																							"\n"
+		""																											"\n"
 		"typedef struct _parse_result {"																			"\n"
 		" token_list* tokens;"																						"\n"
 		" ast_node* ast;"																							"\n"
+		" ast_flat_node* flat;"																						"\n"
+		" int flat_count;"																							"\n"
 		"} parse_result;"																							"\n"
 		""																											"\n"
 		"ast_node* ast_new_node();"																					"\n"
@@ -73,17 +109,81 @@ namespace pgen
 		"void ast_add_sibling(ast_node* sibling, ast_node* sibling_new);"											"\n"
 		"void ast_free(ast_node* node);"																			"\n"
 		"void ast_clear(ast_node* node);"																			"\n"
-		"ast_node* ast_invert_siblings(ast_node* node, ast_node* newNextSibling);"									"\n"
+		"ast_node* ast_arena_new_node(ast_arena* arena);"															"\n"
+		"ast_mark ast_arena_mark(ast_arena* arena);"																"\n"
+		"void ast_arena_reset(ast_arena* arena, ast_mark mark);"													"\n"
+		"void ast_arena_free(ast_arena* arena);"																	"\n"
 		"void token_list_free(token_list* tokens);"																	"\n"
 		"parse_result* parse_result_new();"																			"\n"
 		"void parse_result_free(parse_result* pr);"																	"\n"
 	);
-	const string Code::helperCode(
+	const string Code::internalCode(
 		"#include <stdlib.h>"																						"\n"
 		"#include <stdio.h>"																						"\n"
 		"#include <errno.h>"																						"\n"
 		"#include <string.h>"																						"\n"
+		"#include <stdint.h>"																						"\n"
+		""																											"\n"
+		"unsigned int next_utf8(char * text, int * pos);"															"\n"
+		"unsigned int strlen_utf8(char * text);"																	"\n"
+		"int in_ranges(unsigned int c, const unsigned int* r, int n);"												"\n"
+		""																											"\n"
+		/** The following union makes sure that the space used by the function pointer array
+		 * also allows saving data pointers on them.
+		 */
+		"typedef union _chainptr {"																					"\n"
+		" int (*func)();"																							"\n"
+		" union _chainptr * subchain;"																				"\n"
+		"} chainptr;"																								"\n"
+		"int CHAIN_JUMP();"																							"\n"
+		/** the next lines defines a macro called chain_next(text,chain) which is equivalent of a function as follows:
+		 * if (chain[0].func == CHAIN_JUMP) {
+		 *   if (chain[1].subchain[0].func != NULL) {
+		 *   	if (chain[1].subchain[1].func != NULL) {
+		 *   		return (int (*)(char*, chainptr*))(chain[1].subchain[0].func)(text, &chain[1].subchain[1]);
+		 *   	} else {
+		 *   		return (int (*)(char*))(chain[1].subchain[0].func)(text);
+		 *   	}
+		 *   } else {
+		 *   	return 0;
+		 *   }
+		 * } else if (chain[0].func != NULL) { // the next function in the chain should be called
+		 *   if (chain[1].func != NULL) { // the next function in the chain is not the last one
+		 *     return (int (*)(char*, int (*)()))(chain[0].func) (text, &chain[1]); // return what the next chain function returns.
+		 *   } else { // the next function i the chain is the last one
+		 *     return (int (*)(char*))(chain[0].func) (text); // return what the last chain function returns.
+		 *   }
+		 * } else { // there are no chain functions left to be called.
+		 *   return 0;
+		 * }
+		 * As such, this macro must be used to call the next chain function on the chained version of the compiled methods.
+		 * this macro can be interpreted as a value an must be summed with the methods' own index increment.
+		 */
+		"#define chain_next(text, chain) \\"																		"\n"
+		"( \\"																										"\n"
+		"	chain[0].func == CHAIN_JUMP ? \\"																		"\n"
+		"	( \\"																									"\n"
+		"		chain[1].subchain[0].func != NULL ? \\"																"\n"
+		"		( \\"																								"\n"
+		"			chain[1].subchain[1].func != NULL ? \\"															"\n"
+		"				((int (*)(char*, chainptr*))chain[1].subchain[0].func)(text, &chain[1].subchain[1]) : \\"	"\n"
+		"				((int (*)(char*))chain[1].subchain[0].func)(text) \\"										"\n"
+		"		) : 0 \\"																							"\n"
+		"	) : ( \\"																								"\n"
+		"		chain[0].func != NULL ? \\"																			"\n"
+		"		( \\"																								"\n"
+		"			chain[1].func != NULL ? \\"																		"\n"
+		"				((int (*)(char*, chainptr*))chain[0].func)(text, &chain[1]) : \\"							"\n"
+		"				((int (*)(char*))chain[0].func)(text) \\"													"\n"
+		"		) : 0 \\"																							"\n"
+		"	) \\"																									"\n"
+		")"																											"\n"
+		""																											"\n"
+		"token_list* token_list_init(int num_tokens, int data_len);"												"\n"
+		"void token_list_add(token_list* tokens, int type, char* value, int value_len);"							"\n"
 		""																											"\n"
+	);
+	const string Code::runtimeCode(
 		"unsigned int next_utf8(char * text, int * pos) {"															"\n"
 		" register unsigned int c,d;"																				"\n"
 		" c = text[(*pos)++];"																						"\n"
@@ -134,98 +234,27 @@ namespace pgen
 		" return (pos-1);"																							"\n"
 		"}"																											"\n"
 		""																											"\n"
-		"typedef struct _stack_int {"																				"\n"
-		" int* data;"																								"\n"
-		" unsigned int size;"																						"\n"
-		" int top;"																									"\n"
-		"} stack_int;"																								"\n"
-		""																											"\n"
-		"void stack_int_init(stack_int* s) {"																		"\n"
-		" s->size = 32;"																							"\n"
-		" s->data = (int*) malloc(sizeof(int) * s->size);"															"\n"
-		" s->top = 0;"																								"\n"
-		"}"																											"\n"
-		""																											"\n"
-		"void stack_int_free(stack_int* s) {"																		"\n"
-		" if (s != NULL && s->data != NULL) free(s->data);"															"\n"
-		"}"																											"\n"
-		""																											"\n"
-		"int stack_int_grow(stack_int* s) {"																		"\n"
-		" s->size *= 2;"																							"\n"
-		" void* ndata = realloc(s->data, sizeof(int) * s->size);"													"\n"
-		" if (ndata == NULL) s->size /= 2;"																			"\n"
-		" else s->data = (int*) ndata;"																				"\n"
-		" return (s->data == ndata);"																				"\n"
-		"}"																											"\n"
-		""																											"\n"
-		"void stack_int_push(stack_int* s, int val) {"																"\n"
-		" if (s->top >= s->size && !stack_int_grow(s)) {"															"\n"
-		"  printf(\"Could not allocate enough memory for a regex stack.\");"										"\n"
-		"  abort();"																								"\n"
+		/** The following function checks if a character belongs to a sorted list of "n" ranges (binary search). The
+		 * list "r" holds the start and the end of each range, i.e. {start0, end0, start1, end1, ...}. It is used by
+		 * the code of large classes of characters (see CharClass::membership()).
+		 */
+		"int in_ranges(unsigned int c, const unsigned int* r, int n) {"												"\n"
+		" int lo = 0, hi = n - 1;"																					"\n"
+		" while (lo <= hi) {"																						"\n"
+		"  int mid = (lo + hi) >> 1;"																				"\n"
+		"  if (c < r[mid << 1]) hi = mid - 1;"																		"\n"
+		"  else if (c > r[(mid << 1) + 1]) lo = mid + 1;"															"\n"
+		"  else return 1;"																							"\n"
 		" }"																										"\n"
-		" s->data[s->top++] = val;"																					"\n"
-		"}"																											"\n"
-		""																											"\n"
-		"int stack_int_pop(stack_int *s) {"																			"\n"
-		" if (s->top > 0) return s->data[--s->top];"																"\n"
 		" return 0;"																								"\n"
 		"}"																											"\n"
 		""																											"\n"
-		/** The following union makes sure that the space used by the function pointer array
-		 * also allows saving data pointers on them.
-		 */
-		"typedef union _chainptr {"																					"\n"
-		" int (*func)();"																							"\n"
-		" union _chainptr * subchain;"																				"\n"
-		"} chainptr;"																								"\n"
 		/**
 		 * The following function is a dummy function to be used as an indicator that the
 		 * next pointer in the chain function array is a pointer to the next chain array
 		 * instead of the next chain function.
 		 */
 		"int CHAIN_JUMP() { return -1; }"																			"\n"
-		/** the next lines defines a macro called chain_next(text,chain) which is equivalent of a function as follows:
-		 * if (chain[0].func == CHAIN_JUMP) {
-		 *   if (chain[1].subchain[0].func != NULL) {
-		 *   	if (chain[1].subchain[1].func != NULL) {
-		 *   		return (int (*)(char*, chainptr*))(chain[1].subchain[0].func)(text, &chain[1].subchain[1]);
-		 *   	} else {
-		 *   		return (int (*)(char*))(chain[1].subchain[0].func)(text);
-		 *   	}
-		 *   } else {
-		 *   	return 0;
-		 *   }
-		 * } else if (chain[0].func != NULL) { // the next function in the chain should be called
-		 *   if (chain[1].func != NULL) { // the next function in the chain is not the last one
-		 *     return (int (*)(char*, int (*)()))(chain[0].func) (text, &chain[1]); // return what the next chain function returns.
-		 *   } else { // the next function i the chain is the last one
-		 *     return (int (*)(char*))(chain[0].func) (text); // return what the last chain function returns.
-		 *   }
-		 * } else { // there are no chain functions left to be called.
-		 *   return 0;
-		 * }
-		 * As such, this macro must be used to call the next chain function on the chained version of the compiled methods.
-		 * this macro can be interpreted as a value an must be summed with the methods' own index increment.
-		 */
-		"#define chain_next(text, chain) \\"																		"\n"
-		"( \\"																										"\n"
-		"	chain[0].func == CHAIN_JUMP ? \\"																		"\n"
-		"	( \\"																									"\n"
-		"		chain[1].subchain[0].func != NULL ? \\"																"\n"
-		"		( \\"																								"\n"
-		"			chain[1].subchain[1].func != NULL ? \\"															"\n"
-		"				((int (*)(char*, chainptr*))chain[1].subchain[0].func)(text, &chain[1].subchain[1]) : \\"	"\n"
-		"				((int (*)(char*))chain[1].subchain[0].func)(text) \\"										"\n"
-		"		) : 0 \\"																							"\n"
-		"	) : ( \\"																								"\n"
-		"		chain[0].func != NULL ? \\"																			"\n"
-		"		( \\"																								"\n"
-		"			chain[1].func != NULL ? \\"																		"\n"
-		"				((int (*)(char*, chainptr*))chain[0].func)(text, &chain[1]) : \\"							"\n"
-		"				((int (*)(char*))chain[0].func)(text) \\"													"\n"
-		"		) : 0 \\"																							"\n"
-		"	) \\"																									"\n"
-		")"																											"\n"
 		""																											"\n"
 		"ast_node* ast_new_node() {"																				"\n"
 		" ast_node* node = (ast_node*)malloc(sizeof(ast_node));"													"\n"
@@ -260,29 +289,76 @@ namespace pgen
 		" node->nextSibling = 0;"																					"\n"
 		"}"																											"\n"
 		""																											"\n"
-		"ast_node* ast_invert_siblings(ast_node* node, ast_node* newNextSibling) {"									"\n"
-		" ast_node* next;"																							"\n"
-		" while (node != 0) {"																						"\n"
-		"  node->firstChild = ast_invert_siblings(node->firstChild, NULL);"											"\n"
-		"  next = node->nextSibling;"																				"\n"
-		"  node->nextSibling = newNextSibling;"																		"\n"
-		"  newNextSibling = node;"																					"\n"
-		"  node = next;"																							"\n"
+		/**
+		 * The nodes built by the parsers are allocated from an arena that belongs to the token list, since their data
+		 * points to the token list anyway. The arena is a list of blocks of nodes, each one twice as big as the
+		 * previous one, and it only grows: the blocks after a mark are kept when the arena is reset to the mark, and 
+		 * reused by the next nodes. The parsers reset the arena when they backtrack, and all the nodes are freed by
+		 * token_list_free (ast_free is only for the nodes allocated by ast_new_node).
+		 */
+		"ast_node* ast_arena_new_node(ast_arena* arena) {"															"\n"
+		" ast_block* block = arena->block;"																			"\n"
+		" ast_block* next;"																							"\n"
+		" ast_node* node;"																							"\n"
+		" if (block == NULL || arena->used == block->size) {"														"\n"
+		"  next = (block == NULL ? arena->first : block->next);"													"\n"
+		"  if (next == NULL) {"																						"\n"
+		"   int size = (block == NULL ? 256 : block->size * 2);"													"\n"
+		"   next = (ast_block*) malloc(sizeof(ast_block) + size * sizeof(ast_node));"								"\n"
+		"   next->next = NULL;"																						"\n"
+		"   next->size = size;"																						"\n"
+		"   next->nodes = (ast_node*) (next + 1);"																	"\n"
+		"   if (block == NULL) arena->first = next;"																"\n"
+		"   else block->next = next;"																				"\n"
+		"  }"																										"\n"
+		"  arena->block = block = next;"																			"\n"
+		"  arena->used = 0;"																						"\n"
 		" }"																										"\n"
-		" return newNextSibling;"																					"\n"
+		" node = &block->nodes[arena->used++];"																		"\n"
+		" node->tokenId = -1;"																						"\n"
+		" node->data = NULL;"																						"\n"
+		" node->nextSibling = NULL;"																				"\n"
+		" node->firstChild = NULL;"																					"\n"
+		" return node;"																								"\n"
+		"}"																											"\n"
+		""																											"\n"
+		"ast_mark ast_arena_mark(ast_arena* arena) {"																"\n"
+		" ast_mark mark;"																							"\n"
+		" mark.block = arena->block;"																				"\n"
+		" mark.used = arena->used;"																					"\n"
+		" return mark;"																								"\n"
+		"}"																											"\n"
+		""																											"\n"
+		"void ast_arena_reset(ast_arena* arena, ast_mark mark) {"													"\n"
+		" arena->block = mark.block;"																				"\n"
+		" arena->used = mark.used;"																					"\n"
 		"}"																											"\n"
-		/** token_list_init(int num_tokens, int data_len) */
+		""																											"\n"
+		"void ast_arena_free(ast_arena* arena) {"																	"\n"
+		" ast_block* next;"																							"\n"
+		" while (arena->first != NULL) {"																			"\n"
+		"  next = arena->first->next;"																				"\n"
+		"  free(arena->first);"																						"\n"
+		"  arena->first = next;"																					"\n"
+		" }"																										"\n"
+		" arena->block = NULL;"																						"\n"
+		" arena->used = 0;"																							"\n"
+		"}"																											"\n"
+		/** token_list_init(int num_tokens, int data_len): the item after the last token has the type -1 (end of list) */
 		"token_list* token_list_init(int num_tokens, int data_len) {"      											"\n"
 		" token_list* tokens = (token_list*) malloc(sizeof(token_list));"  											"\n"
-		" tokens->items = (token*) malloc(num_tokens * sizeof(token));"    											"\n"
+		" tokens->items = (token*) malloc((num_tokens + 1) * sizeof(token));"										"\n"
 		" tokens->data = (char*) malloc(data_len + num_tokens);"           											"\n"	// data_len + space for num_token times 0x00
 		" tokens->data_ptr = tokens->data;"                                											"\n"
 		" tokens->count = 0;"                                              											"\n"
+		" tokens->items[0].type = -1;"																				"\n"
+		" memset(&tokens->arena, 0, sizeof(ast_arena));"															"\n"
 		" return tokens;"																							"\n"
 		"}"																											"\n"
 		""																											"\n"
 		/** Add the token_list_free(token_list* tokens) */
 		"void token_list_free(token_list* tokens) {"                       											"\n"
+		" ast_arena_free(&tokens->arena);"																			"\n"
 		" free(tokens->items);"                                            											"\n"
 		" free(tokens->data);"                                             											"\n"
 		" free(tokens);"                                                   											"\n"
@@ -297,6 +373,7 @@ namespace pgen
 		" tok->value[value_len] = 0;"                               	    										"\n"
 		" tokens->data_ptr += value_len+1;"                               											"\n"
 		" tokens->count++;"																							"\n"
+		" tokens->items[tokens->count].type = -1;"																	"\n"
 		"}"                                                                											"\n"
 		""																											"\n"
 		"parse_result* parse_result_new() {"																		"\n"
@@ -306,18 +383,312 @@ namespace pgen
 		"}"																											"\n"
 		""																											"\n"
 		"void parse_result_free(parse_result* pr) {"																"\n"
-		" if (pr->ast != NULL) ast_free(pr->ast);"																	"\n"
 		" if (pr->tokens != NULL) token_list_free(pr->tokens);"														"\n"
+		" if (pr->flat != NULL) free(pr->flat);"																	"\n"
 		" free(pr);"																								"\n"
 		"}"																											"\n"
 		""																											"\n"
 		);
+	/**
+	 * The helpers of the linear-time engine (see Linear), of the bit-parallel engine (see BitParallel), of the stacks
+	 * of the quantifiers that can not be counted (see Quantified), and of the parsers (copies of the memoized nodes, 
+	 * inlined rules and flat AST) are only written when the generated code calls them (see Code::optionalCode).
+	 */
+	const string Code::linearInternal(
+		/** The following type is an instruction of the programs run by nfa_match (see Linear.cpp). */
+		"#define NFA_CLASS 0"																						"\n"
+		"#define NFA_SPLIT 1"																						"\n"
+		"#define NFA_JMP 2"																							"\n"
+		"#define NFA_MATCH 3"																						"\n"
+		""																											"\n"
+		"typedef struct _nfa_inst {"																				"\n"
+		" int op;"																									"\n"
+		" int x, y;"																								"\n"
+		"} nfa_inst;"																								"\n"
+		""																											"\n"
+		"int nfa_add(const nfa_inst* prog, int* list, int n, int* mark, int gen, int* stack, int pc);"				"\n"
+		"int nfa_match(const nfa_inst* prog, int count, const unsigned int* ranges, char* text);"					"\n"
+		""																											"\n"
+		);
+	const string Code::linearRuntime(
+		/** The following functions run a program of the linear-time engine (see Linear.cpp) with a Pike VM, i.e. 
+		 * they simulate all the threads of the automaton in lockstep, reading each character of the text only once.
+		 * The threads are kept in order of priority, and a thread that reaches NFA_MATCH discards all the threads of
+		 * lower priority (the match may still differ from the backtracking code, see Linear.h). nfa_add adds a thread 
+		 * and the threads it splits into to a list, skipping the instructions that were already added for the 
+		 * current character (marked with "gen"). Each instruction is added at most once per character, so the time 
+		 * is O(count) per character and the space is O(count), regardless of the expression.
+		 */
+		"int nfa_add(const nfa_inst* prog, int* list, int n, int* mark, int gen, int* stack, int pc) {"			"\n"
+		" int top = 0;"																								"\n"
+		" stack[top++] = pc;"																						"\n"
+		" while (top > 0) {"																						"\n"
+		"  pc = stack[--top];"																						"\n"
+		"  if (mark[pc] == gen) continue;"																			"\n"
+		"  mark[pc] = gen;"																							"\n"
+		"  if (prog[pc].op == NFA_SPLIT) {"																			"\n"
+		"   stack[top++] = prog[pc].y;"																				"\n"
+		"   stack[top++] = prog[pc].x;"																				"\n"
+		"  }"																										"\n"
+		"  else if (prog[pc].op == NFA_JMP) stack[top++] = prog[pc].x;"												"\n"
+		"  else list[n++] = pc;"																					"\n"
+		" }"																										"\n"
+		" return n;"																								"\n"
+		"}"																											"\n"
+		""																											"\n"
+		"int nfa_match(const nfa_inst* prog, int count, const unsigned int* ranges, char* text) {"					"\n"
+		" int list0[count], list1[count], mark[count], stack[2 * count + 1];"										"\n"
+		" int *clist = list0, *nlist = list1, *tmp;"																"\n"
+		" int cn, nn, i, pos = 0, next, gen = 1, match = -1;"														"\n"
+		" for (i = 0; i < count; i++) mark[i] = 0;"																	"\n"
+		" cn = nfa_add(prog, clist, 0, mark, gen, stack, 0);"														"\n"
+		" while (cn > 0) {"																							"\n"
+		"  unsigned int c = 0;"																						"\n"
+		"  next = pos;"																								"\n"
+		"  if (text[pos] != 0) c = next_utf8(text, &next);"															"\n"
+		"  gen++;"																									"\n"
+		"  nn = 0;"																									"\n"
+		"  for (i = 0; i < cn; i++) {"																				"\n"
+		"   const nfa_inst* in = &prog[clist[i]];"																	"\n"
+		"   if (in->op == NFA_MATCH) {"																				"\n"
+		"    match = pos;"																							"\n"
+		"    break;"																								"\n"
+		"   }"																										"\n"
+		"   if (c != 0 && in_ranges(c, ranges + in->x, in->y)) nn = nfa_add(prog, nlist, nn, mark, gen, stack, clist[i] + 1);" "\n"
+		"  }"																										"\n"
+		"  tmp = clist; clist = nlist; nlist = tmp;"																"\n"
+		"  cn = nn;"																								"\n"
+		"  pos = next;"																								"\n"
+		" }"																										"\n"
+		" return match;"																							"\n"
+		"}"																											"\n"
+		""																											"\n"
+		);
+	const string Code::bitParallelInternal(
+		/** The following type is an automaton of the bit-parallel engine (see BitParallel.cpp). */
+		"typedef struct _bp_automaton {"																			"\n"
+		" uint64_t first;"																							"\n"
+		" uint64_t last;"																							"\n"
+		" int nullable;"																							"\n"
+		" int count;"																								"\n"
+		" const uint64_t* follow;"																					"\n"
+		" const uint64_t* ascii;"																					"\n"
+		" const unsigned int* ranges;"																				"\n"
+		" const int* index;"																						"\n"
+		"} bp_automaton;"																							"\n"
+		""																											"\n"
+		"int bp_match(const bp_automaton* a, char* text);"															"\n"
+		""																											"\n"
+		);
+	const string Code::bitParallelRuntime(
+		/** The following function runs an automaton of the bit-parallel engine (see BitParallel.cpp). The set of
+		 * positions that can read the next character is kept in a single word, and each character only costs a table
+		 * lookup (for ASCII characters) and an AND. The automaton is deterministic, so at most one position reads each
+		 * character; its index is found with a de Bruijn multiplication and selects the positions that can follow it.
+		 */
+		"int bp_match(const bp_automaton* a, char* text) {"															"\n"
+		" static const unsigned char debruijn[64] = {"																"\n"
+		"  0,1,48,2,57,49,28,3,61,58,50,42,38,29,17,4,62,55,59,36,53,51,43,22,45,39,33,30,24,18,12,5,"				"\n"
+		"  63,47,56,27,60,41,37,16,54,35,52,21,44,32,23,11,46,26,40,15,34,20,31,10,25,14,19,9,13,8,7,6};"			"\n"
+		" uint64_t d = a->first, reach;"																			"\n"
+		" int pos = 0, next, i, match = (a->nullable ? 0 : -1);"													"\n"
+		" while (d != 0 && text[pos] != 0) {"																		"\n"
+		"  unsigned int c;"																							"\n"
+		"  next = pos;"																								"\n"
+		"  c = next_utf8(text, &next);"																				"\n"
+		"  if (c < 128) reach = d & a->ascii[c];"																	"\n"
+		"  else {"																									"\n"
+		"   reach = 0;"																								"\n"
+		"   for (i = 0; i < a->count; i++) {"																		"\n"
+		"    if (((d >> i) & 1) && in_ranges(c, a->ranges + 2 * a->index[i], a->index[i + 1] - a->index[i])) {"		"\n"
+		"     reach |= (uint64_t)1 << i;"																			"\n"
+		"    }"																										"\n"
+		"   }"																										"\n"
+		"  }"																										"\n"
+		"  if (reach == 0) break;"																					"\n"
+		"  pos = next;"																								"\n"
+		"  if (reach & a->last) match = pos;"																		"\n"
+		"  d = a->follow[debruijn[((reach & -reach) * 0x03F79D71B4CB0A89ULL) >> 58]];"								"\n"
+		" }"																										"\n"
+		" return match;"																							"\n"
+		"}"																											"\n"
+		""																											"\n"
+		);
+	const string Code::stackInternal(
+		"typedef struct _stack_int {"																				"\n"
+		" int* data;"																								"\n"
+		" unsigned int size;"																						"\n"
+		" int top;"																									"\n"
+		"} stack_int;"																								"\n"
+		""																											"\n"
+		"void stack_int_init(stack_int* s);"																		"\n"
+		"void stack_int_free(stack_int* s);"																		"\n"
+		"int stack_int_grow(stack_int* s);"																			"\n"
+		"void stack_int_push(stack_int* s, int val);"																"\n"
+		"int stack_int_pop(stack_int *s);"																			"\n"
+		""																											"\n"
+		);
+	const string Code::stackRuntime(
+		"void stack_int_init(stack_int* s) {"																		"\n"
+		" s->size = 32;"																							"\n"
+		" s->data = (int*) malloc(sizeof(int) * s->size);"															"\n"
+		" s->top = 0;"																								"\n"
+		"}"																											"\n"
+		""																											"\n"
+		"void stack_int_free(stack_int* s) {"																		"\n"
+		" if (s != NULL && s->data != NULL) free(s->data);"															"\n"
+		"}"																											"\n"
+		""																											"\n"
+		"int stack_int_grow(stack_int* s) {"																		"\n"
+		" s->size *= 2;"																							"\n"
+		" void* ndata = realloc(s->data, sizeof(int) * s->size);"													"\n"
+		" if (ndata == NULL) s->size /= 2;"																			"\n"
+		" else s->data = (int*) ndata;"																				"\n"
+		" return (s->data == ndata);"																				"\n"
+		"}"																											"\n"
+		""																											"\n"
+		"void stack_int_push(stack_int* s, int val) {"																"\n"
+		" if (s->top >= s->size && !stack_int_grow(s)) {"															"\n"
+		"  printf(\"Could not allocate enough memory for a regex stack.\");"										"\n"
+		"  abort();"																								"\n"
+		" }"																										"\n"
+		" s->data[s->top++] = val;"																					"\n"
+		"}"																											"\n"
+		""																											"\n"
+		"int stack_int_pop(stack_int *s) {"																			"\n"
+		" if (s->top > 0) return s->data[--s->top];"																"\n"
+		" return 0;"																								"\n"
+		"}"																											"\n"
+		""																											"\n"
+		);
+	const string Code::copyInternal(
+		"ast_node* ast_copy(ast_arena* arena, ast_node* node);"														"\n"
+		);
+	const string Code::copyRuntime(
+		"ast_node* ast_copy(ast_arena* arena, ast_node* node) {"													"\n"
+		" ast_node* copy;"																							"\n"
+		" ast_node* child;"																							"\n"
+		" ast_node** last;"																							"\n"
+		" if (node == NULL) return NULL;"																			"\n"
+		" copy = ast_arena_new_node(arena);"																		"\n"
+		" copy->tokenId = node->tokenId;"																			"\n"
+		" copy->data = node->data;"																					"\n"
+		" last = &copy->firstChild;"																				"\n"
+		" for (child = node->firstChild; child != NULL; child = child->nextSibling) {"								"\n"
+		"  *last = ast_copy(arena, child);"																			"\n"
+		"  last = &(*last)->nextSibling;"																			"\n"
+		" }"																										"\n"
+		" return copy;"																								"\n"
+		"}"																											"\n"
+		""																											"\n"
+		);
+	const string Code::wrapInternal(
+		"void ast_wrap(ast_arena* arena, ast_node* parent, int tokenId, int count);"								"\n"
+		);
+	const string Code::wrapRuntime(
+		/** ast_wrap(ast_arena* arena, ast_node* parent, int tokenId, int count): moves the first children into a new child */
+		"void ast_wrap(ast_arena* arena, ast_node* parent, int tokenId, int count) {"								"\n"
+		" ast_node* node = ast_arena_new_node(arena);"																"\n"
+		" ast_node** last = &parent->firstChild;"																	"\n"
+		" node->tokenId = tokenId;"																					"\n"
+		" for (; count > 0; count--) last = &(*last)->nextSibling;"													"\n"
+		" node->firstChild = (last == &parent->firstChild ? NULL : parent->firstChild);"							"\n"
+		" node->nextSibling = *last;"																				"\n"
+		" *last = NULL;"																							"\n"
+		" parent->firstChild = node;"																				"\n"
+		"}"																											"\n"
+		""																											"\n"
+		);
+	const string Code::flattenInternal(
+		"ast_flat_node* ast_flatten(ast_node* root, int start, int* count);"										"\n"
+		);
+	const string Code::flattenRuntime(
+		/** ast_flatten(ast_node* root, int start, int* count): copies the tree to an array after parsing; the tokens are
+		 *  numbered from start in the order of the tree */
+		"ast_flat_node* ast_flatten(ast_node* root, int start, int* count) {"										"\n"
+		" ast_flat_node* nodes;"																					"\n"
+		" ast_node** pending;"																						"\n"
+		" ast_node* node;"																							"\n"
+		" int* last;"																								"\n"
+		" int size = 256, depth = 16, top = 0, n = 0, i, c;"														"\n"
+		" *count = 0;"																								"\n"
+		" if (root == NULL) return NULL;"																			"\n"
+		" nodes = (ast_flat_node*) malloc(size * sizeof(ast_flat_node));"											"\n"
+		" pending = (ast_node**) malloc(depth * sizeof(ast_node*));"												"\n"
+		" last = (int*) malloc(depth * sizeof(int));"																"\n"
+		" pending[0] = root;"																						"\n"
+		" last[0] = -1;"																							"\n"
+		" while (top >= 0) {"																						"\n"
+		"  node = pending[top];"																					"\n"
+		"  if (node == NULL) {"																						"\n"
+		"   top--;"																									"\n"
+		"   continue;"																								"\n"
+		"  }"																										"\n"
+		"  pending[top] = (top > 0 ? node->nextSibling : NULL);"													"\n"
+		"  if (n == size) {"																						"\n"
+		"   size *= 2;"																								"\n"
+		"   nodes = (ast_flat_node*) realloc(nodes, size * sizeof(ast_flat_node));"									"\n"
+		"  }"																										"\n"
+		"  nodes[n].tokenId = node->tokenId;"																		"\n"
+		"  nodes[n].firstChild = (node->firstChild != NULL ? n + 1 : -1);"											"\n"
+		"  nodes[n].nextSibling = -1;"																				"\n"
+		"  nodes[n].start = start;"																					"\n"
+		"  if (last[top] >= 0) nodes[last[top]].nextSibling = n;"													"\n"
+		"  last[top] = n++;"																						"\n"
+		"  if (node->tokenId < 1000000000) start++;"																"\n"
+		"  if (node->firstChild != NULL) {"																			"\n"
+		"   if (++top == depth) {"																					"\n"
+		"    depth *= 2;"																							"\n"
+		"    pending = (ast_node**) realloc(pending, depth * sizeof(ast_node*));"									"\n"
+		"    last = (int*) realloc(last, depth * sizeof(int));"														"\n"
+		"   }"																										"\n"
+		"   pending[top] = node->firstChild;"																		"\n"
+		"   last[top] = -1;"																						"\n"
+		"  }"																										"\n"
+		" }"																										"\n"
+		" for (i = n - 1; i >= 0; i--) {"																			"\n"
+		"  c = nodes[i].firstChild;"																				"\n"
+		"  if (c < 0) {"																							"\n"
+		"   nodes[i].end = nodes[i].start + (nodes[i].tokenId < 1000000000 ? 1 : 0);"								"\n"
+		"   continue;"																								"\n"
+		"  }"																										"\n"
+		"  while (nodes[c].nextSibling >= 0) c = nodes[c].nextSibling;"												"\n"
+		"  nodes[i].end = nodes[c].end;"																			"\n"
+		" }"																										"\n"
+		" free(pending);"																							"\n"
+		" free(last);"																								"\n"
+		" *count = n;"																								"\n"
+		" return (ast_flat_node*) realloc(nodes, n * sizeof(ast_flat_node));"										"\n"
+		"}"																											"\n"
+		""																											"\n"
+		);
+	const vector<Code::Optional> Code::optionalCode({
+		{ "nfa_match(", &Code::linearInternal, &Code::linearRuntime },
+		{ "bp_match(", &Code::bitParallelInternal, &Code::bitParallelRuntime },
+		{ "stack_int_", &Code::stackInternal, &Code::stackRuntime },
+		{ "ast_copy(", &Code::copyInternal, &Code::copyRuntime },
+		{ "ast_wrap(", &Code::wrapInternal, &Code::wrapRuntime },
+		{ "ast_flatten(", &Code::flattenInternal, &Code::flattenRuntime }
+	});
+	const string Code::helperCode(Code::getInternal() + Code::getRuntime());
 		
 	Code::Code() 
 	{
 	}
 
 	void Code::add(ICompilable* obj) 
+	{
+		rootList.insert(obj->funcname());
+		include(obj);
+	}
+
+	void Code::cadd(ICompilable* obj) 
+	{
+		rootList.insert(obj->cfuncname());
+		cinclude(obj);
+	}
+
+	void Code::include(ICompilable* obj) 
 	{
 		string funcname = obj->funcname();
 		if (methodList.find(funcname) == methodList.end()) 
@@ -325,37 +696,45 @@ namespace pgen
 			// Add dependences of non-trivial types (types which depend on sub-objects or sequences of objects).
 			switch (obj->type()) 
 			{
-			// Types in which all dependences are used by funcname
+			// Types in which all dependences are used by funcname, except for literal alternatives, which are matched
+			// by a trie and have no dependences.
 			case Alternative::TYPE:
 			case Quantified::TYPE: 
 				{
+					if (obj->type() == Alternative::TYPE && reinterpret_cast<Alternative*>(obj)->literals())
+					{
+						break;
+					}
 					vector<ICompilable*> deps = obj->dependences();
 					for (ICompilable* dep: deps) 
 					{
-						add(dep);
+						include(dep);
 					}
 					break;
 				}
-			// Sequence type, all dependences are used by cfuncname except for the last one which is used by funcname
+			// Sequence type, the fused dependences are inlined, the other dependences are used by cfuncname except 
+			// for the last one which is used by funcname
 			case Sequence::TYPE: 
 				{
 					vector<ICompilable*> deps = obj->dependences();
-					for (unsigned int i = 0; i < deps.size()-1; i++) 
+					unsigned int fused = reinterpret_cast<Sequence*>(obj)->fused();
+					for (unsigned int i = fused; i+1 < deps.size(); i++) 
 					{
-						cadd(deps[i]);
+						cinclude(deps[i]);
+					}
+					if (fused < deps.size())
+					{
+						include(deps.back());
 					}
-					add(deps.back());
 					break;
 				}
 			}
 			// Add the method name for the object
-			_code << obj->compile();
-			methodList.insert(funcname);
-			prototypeList.insert(obj->prototype());
+			store(funcname, obj->prototype(), obj->compile());
 		}
 	}
 
-	void Code::cadd(ICompilable* obj) 
+	void Code::cinclude(ICompilable* obj) 
 	{
 		string cfuncname = obj->cfuncname();
 		if (methodList.find(cfuncname) == methodList.end()) 
@@ -363,43 +742,107 @@ namespace pgen
 			// Add dependences of non-trivial types (types which depend on sub-objects or sequences of objects).
 			switch (obj->type())
 			{
-			// Types in which all dependences are used by funcname
+			// Types in which all dependences are used by funcname, except for literal alternatives, which are matched
+			// by a trie and have no dependences.
 			case Alternative::TYPE:
 			case Quantified::TYPE: 
 				{
+					if (obj->type() == Alternative::TYPE && reinterpret_cast<Alternative*>(obj)->literals())
+					{
+						break;
+					}
 					vector<ICompilable*> deps = obj->dependences();
 					for (ICompilable* dep: deps) 
 					{
-						add(dep);
+						include(dep);
 					}
 					break;
 				}
-			// Sequence type, all dependences are used by cfuncname
+			// Sequence type, the fused dependences are inlined, the other dependences are used by cfuncname
 			case Sequence::TYPE: 
 				{
 					vector<ICompilable*> deps = obj->dependences();
-					for (ICompilable* dep: deps) 
+					unsigned int fused = reinterpret_cast<Sequence*>(obj)->fused();
+					for (unsigned int i = fused; i < deps.size(); i++) 
 					{
-						cadd(dep);
+						cinclude(deps[i]);
 					}
 					break;
 				}
 			}
 			// Add the method name for the object
-			_code << obj->ccompile();
-			methodList.insert(cfuncname);
-			prototypeList.insert(obj->cprototype());
+			store(cfuncname, obj->cprototype(), obj->ccompile());
 		}
 	}
 
+	void Code::store(const string& funcname, const string& prototype, const string& code)
+	{
+		methodList.insert(funcname);
+		functionList.push_back(funcname);
+		functionCode[funcname] = code;
+		prototypeList[funcname] = prototype;
+	}
+
+	/**
+	 * The dependences added by Code::include() and Code::cinclude() are the ones that an expression may call, but 
+	 * many of them are inlined instead (e.g. deterministic expressions, see ICompilable::icompile()). The calls are 
+	 * found by looking for the names of the stored functions on the code of each reachable function, which includes
+	 * its chain tables.
+	 */
+	unordered_set<string> Code::reachable()
+	{
+		unordered_set<string> found(rootList);
+		vector<string> pending(rootList.begin(), rootList.end());
+		while (!pending.empty())
+		{
+			auto code = functionCode.find(pending.back());
+			pending.pop_back();
+			if (code == functionCode.end())
+			{
+				continue;
+			}
+			const string& text = code->second;
+			unsigned int i = 0;
+			while (i < text.length())
+			{
+				if (!isalpha(text[i]) && text[i] != '_')
+				{
+					i++;
+					continue;
+				}
+				unsigned int start = i;
+				while (i < text.length() && (isalnum(text[i]) || text[i] == '_'))
+				{
+					i++;
+				}
+				string id = text.substr(start, i - start);
+				if (functionCode.find(id) != functionCode.end() && found.insert(id).second)
+				{
+					pending.push_back(id);
+				}
+			}
+		}
+		return found;
+	}
+
 	const std::string Code::code() 
 	{
 		stringstream s;
-		for (auto proto: prototypeList)
+		unordered_set<string> used = reachable();
+		for (const string& funcname: functionList)
+		{
+			if (used.find(funcname) != used.end())
+			{
+				s << prototypeList[funcname] << ";\n";
+			}
+		}
+		for (const string& funcname: functionList)
 		{
-			s << proto << ";\n";
+			if (used.find(funcname) != used.end())
+			{
+				s << functionCode[funcname];
+			}
 		}
-		s << _code.str();
 		return s.str();
 	}
 
@@ -418,4 +861,42 @@ namespace pgen
 		return Code::headerCode;
 	}
 
+	std::string Code::getHelper(const string& code)
+	{
+		return Code::getInternal(code) + Code::getRuntime(code);
+	}
+
+	std::string Code::getInternal()
+	{
+		return Code::internalCode + Code::optional(nullptr, false);
+	}
+
+	std::string Code::getInternal(const string& code)
+	{
+		return Code::internalCode + Code::optional(&code, false);
+	}
+
+	std::string Code::getRuntime()
+	{
+		return Code::runtimeCode + Code::optional(nullptr, true);
+	}
+
+	std::string Code::getRuntime(const string& code)
+	{
+		return Code::runtimeCode + Code::optional(&code, true);
+	}
+
+	string Code::optional(const string* code, bool runtime)
+	{
+		string s;
+		for (const Optional& helpers: optionalCode)
+		{
+			if (code == nullptr || code->find(helpers.call) != string::npos)
+			{
+				s += (runtime ? *helpers.runtime : *helpers.internal);
+			}
+		}
+		return s;
+	}
+
 }; /* namespace pgen */
@@ -34,6 +34,8 @@
 #include <string>
 #include <sstream>
 #include <unordered_set>
+#include <unordered_map>
+#include <vector>
 // pgen
 #include "ICompilable.h"
 
@@ -45,10 +47,57 @@ namespace pgen
 	{
 	private:
 		unordered_set<string> methodList;
-		unordered_set<string> prototypeList;
+		unordered_set<string> rootList;						//< Functions added directly (see Code::add()).
+		vector<string> functionList;						//< Functions in the order they were compiled.
+		unordered_map<string, string> functionCode;			//< Code of each function (and of its chain table).
+		unordered_map<string, string> prototypeList;		//< Prototype of each function.
+		static const string internalCode;
+		static const string runtimeCode;
 		static const string helperCode;
 		static const string headerCode;
-		stringstream _code;
+		static const string linearInternal, linearRuntime;
+		static const string bitParallelInternal, bitParallelRuntime;
+		static const string stackInternal, stackRuntime;
+		static const string copyInternal, copyRuntime;
+		static const string wrapInternal, wrapRuntime;
+		static const string flattenInternal, flattenRuntime;
+
+		/**
+		 * A group of helpers that is only needed by some expressions or parsers.
+		 */
+		struct Optional
+		{
+			string call;				//< The text found on the generated code that calls the helpers.
+			const string* internal;		//< The declarations of the helpers.
+			const string* runtime;		//< The definitions of the helpers.
+		};
+		static const vector<Optional> optionalCode;
+
+		/**
+		 * Returns the declarations or the definitions of the optional helpers (see Code::optionalCode).
+		 * \param code the generated code, only the helpers it calls are returned, or nullptr to return all of them.
+		 * \param runtime true to return the definitions, false to return the declarations.
+		 */
+		static string optional(const string* code, bool runtime);
+
+		/**
+		 * Compiles the non-chained function of an expression and the functions it depends on (see Code::add()).
+		 */
+		void include(ICompilable* obj);
+		/**
+		 * Compiles the chained function of an expression and the functions it depends on (see Code::cadd()).
+		 */
+		void cinclude(ICompilable* obj);
+		/**
+		 * Stores the code of a function.
+		 */
+		void store(const string& funcname, const string& prototype, const string& code);
+		/**
+		 * Finds the functions that can be called from the functions added directly (see Code::add()), following 
+		 * the calls and the chain tables on the code of each function.
+		 * \return the names of the reachable functions.
+		 */
+		unordered_set<string> reachable();
 	protected:
 
 	public:
@@ -62,6 +111,8 @@ namespace pgen
 		 * \author Dimas Melo Filho
 		 * \param obj the ICompilable object to add to the Lexicon.
 		 * \remark This method adds the NON-CHAINED version of the matching function
+		 * \remark The function is called by code outside of the repository, so it is a root of the call graph (see 
+		 * Code::code()).
 		 */
 		void add(ICompilable* obj);	
 		
@@ -74,6 +125,8 @@ namespace pgen
 		 * \author Dimas Melo Filho
 		 * \param obj the ICompilable object to add to the Lexicon.
 		 * \remark This method adds the CHAINED version of the matching function.
+		 * \remark The function is called by code outside of the repository, so it is a root of the call graph (see 
+		 * Code::code()).
 		 */
 		void cadd(ICompilable* obj);
 
@@ -82,6 +135,8 @@ namespace pgen
 		 * \author Dimas Melo Filho
 		 * \return All the functions needed to parse all added regular expressions, except for
 		 * a main function. The main must be provided by another class.
+		 * \remark Only the functions that can be reached from the added expressions are returned. For instance, 
+		 * the function of an expression that is always inlined by the expressions that contain it is dropped.
 		 */
 		const string code();
 
@@ -93,6 +148,38 @@ namespace pgen
 		const string & helper();
 		static const string & getHelper();
 		static const string & getHeader();
+
+		/**
+		 * Returns the helper code needed by the generated code: the optional helpers (e.g. nfa_match, see 
+		 * Code::optionalCode) are left out when the code does not call them.
+		 * \param code the generated code (tokenizer, parser and parse helpers).
+		 * \return C++ helper code that is used by the generated code.
+		 */
+		static string getHelper(const string& code);
+
+		/**
+		 * Returns the declarations of the helper code (types, macros and prototypes), without the definitions of the
+		 * helper functions. It is meant to be written to a header that is shared by multiple translation units.
+		 * \return C declarations of the helper code.
+		 */
+		static string getInternal();
+		/**
+		 * Returns the declarations of the helper code needed by the generated code (see Code::getHelper(const 
+		 * string&)).
+		 */
+		static string getInternal(const string& code);
+
+		/**
+		 * Returns the definitions of the helper functions, without their declarations (see Code::getInternal()).
+		 * The helper code (see Code::getHelper()) is the internal code followed by the runtime code.
+		 * \return C definitions of the helper functions.
+		 */
+		static string getRuntime();
+		/**
+		 * Returns the definitions of the helper functions needed by the generated code (see Code::getHelper(const 
+		 * string&)).
+		 */
+		static string getRuntime(const string& code);
 	}; /* class Code */
 } /* namespace pgen */
 
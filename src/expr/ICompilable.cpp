@@ -28,6 +28,7 @@
 // STL
 #include <string>
 #include <sstream>
+#include <unordered_map>
 // pgen
 #include "ICompilable.h"
 
@@ -37,6 +38,11 @@ namespace pgen
 
 	vector<ICompilable*> ICompilable::_dependences;
 
+	/**
+	 * Interned structures of the expressions and their ids (see ICompilable::intern()).
+	 */
+	static unordered_map<string, unsigned int> structures;
+
 	ICompilable::~ICompilable()
 	{
 	}
@@ -79,5 +85,57 @@ namespace pgen
 		s << "int " << this->cfuncname() << "(char* text, chainptr *chain)";
 		return s.str();
 	}
+
+	bool ICompilable::deterministic()
+	{
+		return false;
+	}
+
+	/**
+	 * inlined code:
+	 *  {
+	 *   int p = %funcname()%(text + pos);
+	 *   if (p == -1) return -1;
+	 *   pos += p;
+	 *  }
+	 */
+	string ICompilable::icompile()
+	{
+		stringstream s;
+		s << " {"													"\n"
+			 "  int p = " << this->funcname() << "(text + pos);"	"\n"
+			 "  if (p == -1) return -1;"							"\n"
+			 "  pos += p;"											"\n"
+			 " }"													"\n";
+		return s.str();
+	}
+
+	bool ICompilable::literal(string& bytes)
+	{
+		return false;
+	}
+
+	bool ICompilable::nullable()
+	{
+		return false;
+	}
+
+	void ICompilable::first(IntervalSet& set)
+	{
+	}
+
+	string ICompilable::str()
+	{
+		return this->name();
+	}
+
+	string ICompilable::intern(const string& prefix, const string& structure)
+	{
+		unsigned int id = structures.size();
+		auto it = structures.insert(make_pair(prefix + ":" + structure, id)).first;
+		stringstream s;
+		s << prefix << it->second;
+		return s.str();
+	}
 	
 } /* namespace pgen */
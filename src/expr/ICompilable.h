@@ -32,6 +32,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+// pgen
+#include "../misc/IntervalSet.h"
 
 using namespace std;
 namespace pgen 
@@ -100,6 +102,45 @@ namespace pgen
 		 * code.
 		 */
 		virtual string cprototype();
+		/**
+		 * \returns true when the expression can match the text in a single way only (i.e. it never needs to
+		 * backtrack). Deterministic expressions can be fused into the compiled code of their parents through the
+		 * icompile() method instead of being called through function pointers.
+		 */
+		virtual bool deterministic();
+		/**
+		 * Returns C statements that match the expression inline, inside the body of another compiled function.
+		 * The statements read the text starting at "text + pos", advance the "pos" variable by the number of
+		 * consumed bytes and "return -1;" from the enclosing function on failure.
+		 * The default implementation calls the non-chained function, deterministic expressions should override it
+		 * with code that does not depend on any other compiled function.
+		 * \returns the inlined C statements that match the expression.
+		 */
+		virtual string icompile();
+		/**
+		 * Checks if the expression matches a single fixed text (e.g. a character or a sequence of characters), in
+		 * which case it can be matched by comparing bytes instead of decoding characters.
+		 * \param bytes the string to append the utf-8 bytes of the matched text to.
+		 * \returns true when the expression is a literal text. When false is returned, the contents of "bytes" are
+		 * undefined.
+		 */
+		virtual bool literal(string& bytes);
+		/**
+		 * \returns true when the expression can match an empty text.
+		 */
+		virtual bool nullable();
+		/**
+		 * Adds the characters that can be the first character of a text matched by the expression to a set (the
+		 * FIRST set of the expression). Nullable expressions add only the characters of their non-empty matches.
+		 * \param set the set of unicode characters to add the first characters to.
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * Returns the expression written with the regular expression syntax. It is not required to be the same text
+		 * that was parsed, it is meant to be shown on messages (e.g. warnings) to identify sub-expressions.
+		 * \returns the regular expression of the expression.
+		 */
+		virtual string str();
 		/**
 		 * \returns the type identifier of this class.
 		 */
@@ -111,6 +152,18 @@ namespace pgen
 		virtual void print(int level = 0) = 0;
 		#endif
 
+	protected:
+		/**
+		 * Interns the structure of an expression, returning a short name that is shared by all the structurally
+		 * equal expressions (hash-consing). Composite expressions use it so that their names do not grow with the
+		 * names of their sub-expressions, since those names identify the functions on the generated code.
+		 * \param prefix the prefix of the returned name, it must not contain digits nor underscores.
+		 * \param structure a text that identifies the structure of the expression, usually built from the names
+		 * of its sub-expressions.
+		 * \returns prefix followed by the numeric id of the structure, e.g. "sq12".
+		 */
+		static string intern(const string& prefix, const string& structure);
+
 	}; /* class ICompilable */
 } /* namespace pgen */
 
@@ -0,0 +1,293 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-23
+ * \file
+ * This file contains the implementation of the Linear class, which compiles an expression into a program of the
+ * linear-time engine (see Linear.h).
+ */
+
+// STL
+#include <string>
+#include <sstream>
+#include <iostream>
+// pgen
+#include "Linear.h"
+#include "Alternative.h"
+#include "Quantified.h"
+#include "Sequence.h"
+#include "Text.h"
+#include "../misc/Util.h"
+
+using namespace std;
+namespace pgen
+{
+
+	Linear::Linear(ICompilable* expression)
+	 : expr(expression)
+	{
+		emit(expr);
+		emit(NFA_MATCH);
+	}
+
+	Linear::~Linear()
+	{
+	}
+
+	int Linear::emit(int op, int x, int y)
+	{
+		program.push_back({op, x, y});
+		return program.size() - 1;
+	}
+
+	void Linear::emit(const IntervalSet& set)
+	{
+		emit(NFA_CLASS, ranges.size(), set.size());
+		for (auto& r: set)
+		{
+			ranges.push_back(r.first);
+			ranges.push_back(r.second);
+		}
+	}
+
+	/**
+	 * Each type of expression is compiled as follows (where "e" is a sub-expression):
+	 *  - characters, ranges and classes: CLASS [characters];
+	 *  - texts: a CLASS instruction for each character;
+	 *  - sequences: the instructions of each expression, in order;
+	 *  - alternatives (e1|e2|...|en):
+	 *         SPLIT L1, L2
+	 *     L1: e1
+	 *         JMP END
+	 *     L2: SPLIT L3, L4
+	 *     ...
+	 *     Ln: en
+	 *    END:
+	 *  - quantified expressions: "e" is repeated "min" times, followed by (for e{min,} and e{min,max}):
+	 *      L: SPLIT L+1, END             SPLIT L1, END
+	 *         e                      L1: e
+	 *         JMP L                      SPLIT L2, END
+	 *    END:                        ...
+	 *                                    e
+	 *                               END:
+	 *    The targets of SPLIT are swapped on lazy quantifiers, so that matching fewer occurrences has the priority.
+	 */
+	void Linear::emit(ICompilable* expression)
+	{
+		switch (expression->type())
+		{
+		case Sequence::TYPE:
+			{
+				for (ICompilable* e: expression->dependences())
+				{
+					emit(e);
+				}
+				break;
+			}
+		case Alternative::TYPE:
+			{
+				vector<ICompilable*>& alternatives = expression->dependences();
+				vector<int> jumps;
+				for (unsigned int i = 0; i < alternatives.size(); i++)
+				{
+					if (i + 1 < alternatives.size())
+					{
+						int split = emit(NFA_SPLIT, program.size() + 1);
+						emit(alternatives[i]);
+						jumps.push_back(emit(NFA_JMP));
+						program[split].y = program.size();
+					}
+					else
+					{
+						emit(alternatives[i]);
+					}
+				}
+				for (int jump: jumps)
+				{
+					program[jump].x = program.size();
+				}
+				break;
+			}
+		case Quantified::TYPE:
+			{
+				Quantified* q = reinterpret_cast<Quantified*>(expression);
+				ICompilable* e = q->dependences()[0];
+				for (unsigned int i = 0; i < q->getMin(); i++)
+				{
+					emit(e);
+				}
+				vector<int> splits;
+				if (q->getMax() == Quantified::INF)
+				{
+					int loop = emit(NFA_SPLIT, program.size() + 1);
+					splits.push_back(loop);
+					emit(e);
+					emit(NFA_JMP, loop);
+				}
+				else
+				{
+					for (unsigned int i = q->getMin(); i < q->getMax(); i++)
+					{
+						splits.push_back(emit(NFA_SPLIT, program.size() + 1));
+						emit(e);
+					}
+				}
+				for (int split: splits)
+				{
+					program[split].y = program.size();
+					if (!q->greedy)
+					{
+						swap(program[split].x, program[split].y);
+					}
+				}
+				break;
+			}
+		case Text::TYPE:
+			{
+				const string& text = reinterpret_cast<Text*>(expression)->getText();
+				unsigned int len = Util::strlen_utf8(text);
+				unsigned int i = 0;
+				while (i < len)
+				{
+					unsigned int c = Util::next_utf8(text, i);
+					IntervalSet set;
+					set.add(c, c);
+					emit(set);
+				}
+				break;
+			}
+		default:
+			{
+				// Characters, ranges and classes of characters match a single character of their first set.
+				IntervalSet set;
+				expression->first(set);
+				emit(set);
+				break;
+			}
+		}
+	}
+
+	unsigned int Linear::size()
+	{
+		return program.size();
+	}
+
+	/**
+	 * compiled code:
+	 * %cprototype()% {
+	 *  int pos = %funcname()%(text), pchain;
+	 *  if (pos == -1) return -1;
+	 *  pchain = chain_next(text + pos, chain);
+	 *  if (pchain == -1) return -1;
+	 *  return pos + pchain;
+	 * }
+	 */
+	string Linear::ccompile()
+	{
+		stringstream s;
+		s << this->cprototype() << " {"										"\n"
+			 " int pos = " << this->funcname() << "(text), pchain;"			"\n"
+			 " if (pos == -1) return -1;"									"\n"
+			 " pchain = chain_next(text + pos, chain);"						"\n"
+			 " if (pchain == -1) return -1;"								"\n"
+			 " return pos + pchain;"										"\n"
+			 "}"															"\n\n";
+		return s.str();
+	}
+
+	/**
+	 * compiled code:
+	 * %prototype()% {
+	 *  static const nfa_inst prog[] = {{%op%,%x%,%y%},...};
+	 *  static const unsigned int ranges[] = {%start%,%end%,...};
+	 *  return nfa_match(prog, %program.size()%, ranges, text);
+	 * }
+	 */
+	string Linear::compile()
+	{
+		stringstream s;
+		s << this->prototype() << " {"										"\n"
+			 " static const nfa_inst prog[] = {";
+		for (unsigned int i = 0; i < program.size(); i++)
+		{
+			if (i > 0) s << ",";
+			if (program.size() > 8 && i % 8 == 0) s << "\n   ";
+			s << "{" << program[i].op << "," << program[i].x << "," << program[i].y << "}";
+		}
+		s << "};"															"\n"
+			 " static const unsigned int ranges[] = {";
+		for (unsigned int i = 0; i < ranges.size(); i++)
+		{
+			if (i > 0) s << ",";
+			if (ranges.size() > 32 && i % 32 == 0) s << "\n   ";
+			s << ranges[i];
+		}
+		if (ranges.empty())
+		{
+			s << "0";
+		}
+		s << "};"															"\n"
+			 " return nfa_match(prog, " << program.size() << ", ranges, text);"	"\n"
+			 "}"															"\n\n";
+		return s.str();
+	}
+
+	bool Linear::nullable()
+	{
+		return expr->nullable();
+	}
+
+	void Linear::first(IntervalSet& set)
+	{
+		expr->first(set);
+	}
+
+	string Linear::str()
+	{
+		return expr->str();
+	}
+
+	string Linear::name()
+	{
+		return intern("ln", expr->name());
+	}
+
+	/**
+	 * \returns the type identifier of this class.
+	 */
+	int Linear::type()
+	{
+		return TYPE;
+	}
+
+	#ifdef _DEBUG
+	void Linear::print(int level)
+	{
+		for (int i = 0; i < level; i++)
+		{
+			cout << '.';
+		}
+		cout << "LINEAR(@" << hex << this << ", SIZE=" << dec << program.size() << ")" << endl;
+		this->expr->print(level+1);
+	}
+	#endif
+
+} /* namespace pgen */
@@ -0,0 +1,162 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-23
+ * \file
+ * The Linear class matches an expression with the linear-time engine instead of the backtracking code generated by
+ * the other ICompilable classes. The expression is compiled into a program of a non-deterministic automaton (a list
+ * of instructions), which is run by the nfa_match function (see Code::linearRuntime). The instructions are:
+ *  - NFA_CLASS x, y: reads a character that belongs to one of the "y" ranges that start at "ranges[x]";
+ *  - NFA_SPLIT x, y: continues on both "x" and "y", "x" having the highest priority;
+ *  - NFA_JMP x: continues on "x";
+ *  - NFA_MATCH: the expression was matched.
+ * For instance, the expression "(a|b)*c" is compiled as follows:
+ *  0: SPLIT 1, 6
+ *  1: SPLIT 2, 4
+ *  2: CLASS [a]
+ *  3: JMP 5
+ *  4: CLASS [b]
+ *  5: JMP 0
+ *  6: CLASS [c]
+ *  7: MATCH
+ * The engine runs in time proportional to the length of the text times the number of instructions. The threads are
+ * kept in the order of priority of the backtracking code, but the engine tries every way of matching the quantified
+ * sub-expressions, while the backtracking code does not retry all of them. So the engine may accept texts that the
+ * backtracking code rejects, or find another match (e.g. "(ab|a)+b" matches 5 characters of "ababb" instead of 4).
+ * It is only used for the expressions that may backtrack catastrophically, and only when the language enables it 
+ * (see Language::linear and TokenType).
+ */
+
+#ifndef LINEAR_H_
+#define LINEAR_H_
+
+// STL
+#include <string>
+#include <vector>
+// pgen
+#include "ICompilable.h"
+
+using namespace std;
+namespace pgen
+{
+	class Linear
+	 : public ICompilable
+	{
+	private:
+		/**
+		 * An instruction of the program (see nfa_inst on Code::linearInternal).
+		 */
+		struct Instruction
+		{
+			int op;
+			int x, y;
+		};
+
+		ICompilable* expr;					//< The expression (not owned by the Linear object).
+		vector<Instruction> program;		//< The compiled program.
+		vector<unsigned int> ranges;		//< The ranges of the NFA_CLASS instructions ({start0, end0, ...}).
+
+		/**
+		 * Appends the instructions that match an expression to the program.
+		 * \param expression the expression to compile.
+		 */
+		void emit(ICompilable* expression);
+		/**
+		 * Appends an NFA_CLASS instruction to the program.
+		 * \param set the characters that are accepted by the instruction.
+		 */
+		void emit(const IntervalSet& set);
+		/**
+		 * Appends an instruction to the program.
+		 * \return the index of the instruction.
+		 */
+		int emit(int op, int x = 0, int y = 0);
+	public:
+		static const int NFA_CLASS = 0;
+		static const int NFA_SPLIT = 1;
+		static const int NFA_JMP = 2;
+		static const int NFA_MATCH = 3;
+
+		/**
+		 * Compiles an expression to be matched by the linear-time engine.
+		 * \param expression the expression. It is not owned by the Linear object, so it must outlive it.
+		 */
+		Linear(ICompilable* expression);
+		virtual ~Linear();
+
+		/**
+		 * \return the number of instructions of the program.
+		 */
+		unsigned int size();
+
+		// ICompilable Methods Implementation
+		/**
+		 * Returns C code that can parse the regular expression.
+		 * The returned code should be a function with the following
+		 * prototype: int expr_name(char *text, int (*chain[])());
+		 * the function must return the numbers of consumed bytes on success or -1 on failure.
+		 * The linear-time engine does not backtrack, so the chain is only called with the text that follows the
+		 * match of the expression.
+		 * \return the chainable compiled C code that parses the expression.
+		 */
+		virtual string ccompile();
+		/**
+		 * Returns C code that can parse the regular expression.
+		 * the returned code shuld be a function with the following prototype:
+		 * int expr_name(char *text);
+		 * The function must return the numbers of consumed bytes on success or -1 on failure.
+		 * This version of the function is not chainable.
+		 * \return the compiled C code that parses the expression.
+		 */
+		virtual string compile();
+		/**
+		 * \returns true when the expression is nullable (see ICompilable::nullable()).
+		 */
+		virtual bool nullable();
+		/**
+		 * Adds the first characters of the expression to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the regular expression of the expression (see ICompilable::str()).
+		 */
+		virtual string str();
+		/**
+		 * Returns the name of the expression. The returned name must be usable as a function
+		 * name in the standard C (C99). i.e. it has to match the following format:
+		 * [a-zA-Z][A-Za-z0-9_]*
+		 * \return The text "ln" followed by the id of the expression (see ICompilable::intern()).
+		 */
+		virtual string name();
+		/**
+		 * \returns the type identifier of this class.
+		 */
+		virtual int type();
+
+		#ifdef _DEBUG
+		virtual void print(int level = 0);
+		#endif
+
+		static const int TYPE = 8;
+	}; /* class Linear */
+} /* namespace pgen */
+
+#endif /* LINEAR_H_ */
@@ -0,0 +1,287 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-25
+ * \file
+ * This file contains the implementation of the Prefilter class, which compiles the functions that search a buffer for
+ * the first match of an expression (see Prefilter.h).
+ */
+
+// STL
+#include <string>
+#include <sstream>
+#include <algorithm>
+// pgen
+#include "Prefilter.h"
+#include "Quantified.h"
+#include "Sequence.h"
+#include "Alternative.h"
+#include "../misc/IntervalSet.h"
+
+using namespace std;
+namespace pgen
+{
+
+	Prefilter::Prefilter(ICompilable* expr)
+	 : literal(false)
+	 , nullable(expr->nullable())
+	{
+		literal = collect(expr, bytes);
+		IntervalSet first;
+		expr->first(first);
+		fill(starts, starts + 256, false);
+		for (auto& r: first)
+		{
+			for (unsigned int c = lead(r.first); c <= lead(r.second) && c < 256; c++)
+			{
+				starts[c] = true;
+			}
+		}
+	}
+
+	bool Prefilter::collect(ICompilable* expr, string& bytes)
+	{
+		string text;
+		if (expr->literal(text))
+		{
+			bytes += text;
+			return true;
+		}
+		switch (expr->type())
+		{
+		case Sequence::TYPE:
+			{
+				for (ICompilable* e: expr->dependences())
+				{
+					if (!collect(e, bytes))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		case Alternative::TYPE:
+			{
+				// the common prefix of the alternatives
+				vector<ICompilable*>& alternatives = expr->dependences();
+				string common;
+				for (unsigned int i = 0; i < alternatives.size(); i++)
+				{
+					string prefix;
+					collect(alternatives[i], prefix);
+					if (i == 0)
+					{
+						common = prefix;
+						continue;
+					}
+					unsigned int n = 0;
+					while (n < common.length() && n < prefix.length() && common[n] == prefix[n])
+					{
+						n++;
+					}
+					common.resize(n);
+				}
+				bytes += common;
+				return false;
+			}
+		case Quantified::TYPE:
+			{
+				Quantified* q = reinterpret_cast<Quantified*>(expr);
+				if (q->getMin() > 0)
+				{
+					collect(q->dependences()[0], bytes);
+				}
+				return false;
+			}
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * The first byte of the UTF-8 encoding grows with the character, so the first bytes of the characters of a range 
+	 * are the range of the first bytes of its limits.
+	 */
+	unsigned int Prefilter::lead(unsigned int c)
+	{
+		if (c < 0x80) return c;
+		if (c < 0x800) return 0xC0 | (c >> 6);
+		if (c < 0x10000) return 0xE0 | (c >> 12);
+		if (c < 0x200000) return 0xF0 | (c >> 18);
+		return 0xFF;
+	}
+
+	const string& Prefilter::prefix()
+	{
+		return bytes;
+	}
+
+	/**
+	 * The matching functions read a null-terminated text, so the search is done by %name%_from on a text that ends 
+	 * at len, from a start position, without copying it. Searching every match of a text only costs its length 
+	 * (plus the matches), since each search starts after the previous match. %name% searches a buffer that does not
+	 * have to be null-terminated: it is copied once to a null-terminated text, so the matches are cut at the end of
+	 * the buffer and nothing after it is read. The expressions that only match a single text never read past len, so 
+	 * their buffer is searched in place.
+	 * compiled code: (when every match starts with the same bytes)
+	 * int %name%_from(char* text, int len, int start, token_match* match) {
+	 *  int found = -1, length;
+	 *  char* p;
+	 *  while (start + %bytes.length()% <= len) {
+	 *   p = (char*)memchr(text + start, %bytes[0]%, len - start);
+	 *   if (p == NULL) break;
+	 *   start = p - text;
+	 *   if (start + %bytes.length()% <= len && memcmp(p + 1, "%bytes[1..]%", %bytes.length()-1%) == 0) {
+	 *    length = %literal ? bytes.length() : matcher + "(p)"%;
+	 *    if (length != -1) {
+	 *     match->start = start;
+	 *     match->length = length;
+	 *     found = start;
+	 *     break;
+	 *    }
+	 *   }
+	 *   start++;
+	 *  }
+	 *  return found;
+	 * }
+	 * compiled code: (otherwise)
+	 * int %name%_from(char* text, int len, int start, token_match* match) {
+	 *  static const unsigned char starts[256] = {[%byte%] = 1, ...};
+	 *  int found = -1, length;
+	 *  for (; start %nullable ? "<=" : "<"% len; start++) {
+	 *   if (!starts[(unsigned char)text[start]]) continue;
+	 *   length = %matcher%(text + start);
+	 *   if (length != -1) {
+	 *    match->start = start;
+	 *    match->length = length;
+	 *    found = start;
+	 *    break;
+	 *   }
+	 *  }
+	 *  return found;
+	 * }
+	 * The table of the bytes that can start a match is not used when the expression matches the empty text, which is
+	 * also matched at the end of the buffer.
+	 * compiled code: (the search of a buffer)
+	 * int %name%(char* buf, int len, token_match* match) {
+	 *  int found;
+	 *  char* text = (char*) malloc(len + 1);
+	 *  if (text == NULL) return -1;
+	 *  memcpy(text, buf, len);
+	 *  text[len] = 0;
+	 *  found = %name%_from(text, len, 0, match);
+	 *  free(text);
+	 *  return found;
+	 * }
+	 * (when the expression only matches the bytes: return %name%_from(buf, len, 0, match);)
+	 */
+	string Prefilter::compile(const string& name, const string& matcher)
+	{
+		stringstream s;
+		s << "int " << name << "_from(char* text, int len, int start, token_match* match) {"		"\n";
+		if (!bytes.empty())
+		{
+			stringstream rest;
+			for (unsigned int i = 1; i < bytes.length(); i++)
+			{
+				rest << "\\" << oct << (unsigned int)(unsigned char)bytes[i];
+			}
+			s << " int found = -1, length;"																"\n"
+				 " char* p;"																			"\n"
+				 " while (start + " << bytes.length() << " <= len) {"									"\n"
+				 "  p = (char*)memchr(text + start, " << (unsigned int)(unsigned char)bytes[0] << ", len - start);\n"
+				 "  if (p == NULL) break;"																"\n"
+				 "  start = p - text;"																	"\n"
+				 "  if (start + " << bytes.length() << " <= len";
+			if (bytes.length() > 1)
+			{
+				s << " && memcmp(p + 1, \"" << rest.str() << "\", " << bytes.length()-1 << ") == 0";
+			}
+			s << ") {"																					"\n"
+				 "   length = " << (literal ? to_string(bytes.length()) : matcher + "(p)") << ";"			"\n"
+				 "   if (length != -1) {"																"\n"
+				 "    match->start = start;"															"\n"
+				 "    match->length = length;"															"\n"
+				 "    found = start;"																	"\n"
+				 "    break;"																			"\n"
+				 "   }"																					"\n"
+				 "  }"																					"\n"
+				 "  start++;"																			"\n"
+				 " }"																					"\n";
+		}
+		else
+		{
+			if (!nullable)
+			{
+				s << " static const unsigned char starts[256] = {";
+				unsigned int n = 0;
+				for (unsigned int c = 0; c < 256; c++)
+				{
+					if (!starts[c]) continue;
+					if (n > 0) s << ",";
+					if (n % 16 == 0) s << "\n   ";
+					s << "[" << c << "] = 1";
+					n++;
+				}
+				if (n == 0)
+				{
+					s << "0";
+				}
+				s << "};"																				"\n";
+			}
+			s << " int found = -1, length;"																"\n"
+				 " for (; start " << (nullable ? "<=" : "<") << " len; start++) {"						"\n";
+			if (!nullable)
+			{
+				s << "  if (!starts[(unsigned char)text[start]]) continue;"								"\n";
+			}
+			s << "  length = " << matcher << "(text + start);"											"\n"
+				 "  if (length != -1) {"																"\n"
+				 "   match->start = start;"																"\n"
+				 "   match->length = length;"															"\n"
+				 "   found = start;"																	"\n"
+				 "   break;"																			"\n"
+				 "  }"																					"\n"
+				 " }"																					"\n";
+		}
+		s << " return found;"																			"\n"
+			 "}"																						"\n\n"
+			 "int " << name << "(char* buf, int len, token_match* match) {"								"\n";
+		if (!bytes.empty() && literal)
+		{
+			s << " return " << name << "_from(buf, len, 0, match);"										"\n";
+		}
+		else
+		{
+			s << " int found;"																			"\n"
+				 " char* text = (char*) malloc(len + 1);"												"\n"
+				 " if (text == NULL) return -1;"														"\n"
+				 " memcpy(text, buf, len);"																"\n"
+				 " text[len] = 0;"																		"\n"
+				 " found = " << name << "_from(text, len, 0, match);"									"\n"
+				 " free(text);"																			"\n"
+				 " return found;"																		"\n";
+		}
+		s << "}"																						"\n\n";
+		return s.str();
+	}
+
+} /* namespace pgen */
@@ -0,0 +1,98 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-25
+ * \file
+ * The Prefilter class compiles a function that searches a buffer for the first match of an expression. Trying the
+ * matching function of the expression at every position of the buffer is slow, so the positions are first filtered
+ * with one of the following methods:
+ *  - when every match starts with the same bytes (e.g. "0x[0-9a-f]+" starts with "0x"), the first byte is found with
+ *    memchr (which is vectorized by most C libraries) and the other bytes are compared with memcmp. Expressions that 
+ *    only match a single text (e.g. "\^\^") are found without calling the matching function at all;
+ *  - otherwise, only the positions whose byte can start a match are tried (e.g. the digits for "[0-9]+\.[0-9]+"),
+ *    using a table of 256 flags.
+ */
+
+#ifndef PREFILTER_H_
+#define PREFILTER_H_
+
+// STL
+#include <string>
+// pgen
+#include "ICompilable.h"
+
+using namespace std;
+namespace pgen
+{
+	class Prefilter
+	{
+	private:
+		string bytes;				//< The bytes that start every match of the expression.
+		bool literal;				//< True when the expression only matches the bytes.
+		bool nullable;				//< True when the expression matches the empty text.
+		bool starts[256];			//< The bytes that can start a match of the expression.
+
+		/**
+		 * Appends the bytes that start every match of an expression.
+		 * \param expr the expression.
+		 * \param bytes the string to append the bytes to.
+		 * \return true when the expression only matches the appended bytes, so the bytes that start the matches of
+		 * the expressions that follow it can also be appended.
+		 */
+		static bool collect(ICompilable* expr, string& bytes);
+		/**
+		 * \return the first byte of the UTF-8 encoding of a character.
+		 */
+		static unsigned int lead(unsigned int c);
+	public:
+		/**
+		 * Analyzes an expression.
+		 * \param expr the expression.
+		 */
+		Prefilter(ICompilable* expr);
+
+		/**
+		 * \return the bytes that start every match of the expression (it may be empty).
+		 */
+		const string& prefix();
+
+		/**
+		 * Returns the C code of the functions that find the first match of the expression on a buffer, with the
+		 * following prototypes:
+		 * int %name%(char* buf, int len, token_match* match);
+		 * int %name%_from(char* text, int len, int start, token_match* match);
+		 * The buffer of %name% does not have to be null-terminated: the bytes after buf[len - 1] are never read, and 
+		 * the matches are cut at the end of the buffer as if the text ended there. The text of %name%_from must be 
+		 * null-terminated (text[len] == 0), and it is searched from the start position without being copied, so all 
+		 * the matches of a text are found by searching again after each match. The functions return the position of
+		 * the first match, or -1 when there are no matches, and store the position and the length of the match on the
+		 * token_match structure.
+		 * \param name the name of the function.
+		 * \param matcher the name of the non-chained matching function of the expression (see ICompilable::funcname).
+		 * It is not called when the expression only matches a single text.
+		 * \return the C code of the function.
+		 */
+		string compile(const string& name, const string& matcher);
+	}; /* class Prefilter */
+} /* namespace pgen */
+
+#endif /* PREFILTER_H_ */
@@ -49,6 +49,10 @@
 // pgen
 #include "Quantified.h"
 #include "ICompilable.h"
+#include "Text.h"
+#include "Character.h"
+#include "Range.h"
+#include "CharClass.h"
 
 using namespace std;
 namespace pgen 
@@ -77,8 +81,67 @@ namespace pgen
 		delete expr;
 	}
 
+	unsigned int Quantified::getMin()
+	{
+		return min;
+	}
+
+	unsigned int Quantified::getMax()
+	{
+		return max;
+	}
+
+	ICompilable* Quantified::release()
+	{
+		ICompilable* e = expr;
+		expr = nullptr;
+		deps.clear();
+		return e;
+	}
+
 	/**
-	 * compiled code:
+	 * The greedy chained code has to undo the occurrences one by one, from the last one, until the rest of the chain
+	 * matches. It counts the occurrences and finds out the length of the last one as follows:
+	 *  - Literal expressions always have the same length (see Quantified::literal()), so the count is enough. They
+	 *    are also compared inline (see Text::mismatch()), without calling the function of the expression;
+	 *  - Expressions with up to MAX_COUNTED optional occurrences (max - min) save the lengths of those occurrences
+	 *    on an array in automatic storage. The mandatory occurrences are never undone, so they are only counted;
+	 *  - Otherwise, the lengths are pushed to a stack_int, which grows on the heap.
+	 * compiled code (literal expressions):
+	 * %cprototype()% {
+	 *  int pos = 0, p = 0, count = 0;
+	 *  while (%if (max != INF) "count < " + max + " && "%!(%Text::mismatch(bytes)%)) {
+	 *   pos += %n%;
+	 *   count++;
+	 *  }
+	 *  while (count >= %min%) {
+	 *   p = chain_next(text + pos, chain);
+	 *   if (p >= 0) return pos + p;
+	 *   if (count == 0) break;
+	 *   pos -= %n%;
+	 *   count--;
+	 *  }
+	 *  return -1;
+	 * }
+	 * compiled code (up to MAX_COUNTED optional occurrences):
+	 * %cprototype()% {
+	 *  int pos = 0, p = 0, count = 0, n = 0;
+	 *  int len[%max - min%];
+	 *  len[0] = 0;
+	 *  while (count < %max% && (p = %expr->funcname()%(text + pos)) != -1) {
+	 *   pos += p;
+	 *   if (count++ >= %min%) len[n++] = p;
+	 *  }
+	 *  while (count >= %min%) {
+	 *   p = chain_next(text + pos, chain);
+	 *   if (p >= 0) return pos + p;
+	 *   if (n == 0) break;
+	 *   pos -= len[--n];
+	 *  }
+	 *  (when min == max, the array is omitted and the loop breaks after the first try)
+	 *  return -1;
+	 * }
+	 * compiled code (other expressions):
 	 * %cprototype()% {
 	 *  int pos = 0, p = 0;
 	 *  stack_int stack;
@@ -103,6 +166,75 @@ namespace pgen
 	string Quantified::ccompile_greedy() 
 	{
 		stringstream s;
+		string bytes;
+		if (expr->literal(bytes) && bytes.length() > 0)
+		{
+			s << this->cprototype() << " {"									"\n"
+				 " int pos = 0, p = 0, count = 0;"							"\n"
+				 " while (";
+			if (max != INF) 
+			{
+				s << "count < " << max << " && ";
+			}
+			s << "!(" << Text::mismatch(bytes) << ")) {"					"\n"
+				 "  pos += " << bytes.length() << ";"						"\n"
+				 "  count++;"												"\n"
+				 " }"														"\n"
+				 " while (count >= " << min << ") {"						"\n"
+				 "  p = chain_next(text + pos, chain);"						"\n"
+				 "  if (p >= 0) return pos + p;"							"\n"
+				 "  if (count == 0) break;"									"\n"
+				 "  pos -= " << bytes.length() << ";"						"\n"
+				 "  count--;"												"\n"
+				 " }"														"\n"
+				 " return -1;"												"\n"
+				 "}"														"\n\n";
+			return s.str();
+		}
+		if (max != INF && max - min <= MAX_COUNTED)
+		{
+			s << this->cprototype() << " {"									"\n"
+				 " int pos = 0, p = 0, count = 0" << (max > min ? ", n = 0;" : ";") << "\n";
+			if (max > min)
+			{
+				// the first item is set so that the compilers do not assume that it may be read uninitialized
+				s << " int len[" << (max - min) << "];"						"\n"
+					 " len[0] = 0;"											"\n";
+			}
+			s << " while (count < " << max << " && (p = " << expr->funcname() << "(text + pos)) != -1) {"	"\n"
+				 "  pos += p;"												"\n";
+			// only the optional occurrences are recorded, so that they can be given back
+			if (max > min && min > 0)
+			{
+				s << "  if (count++ >= " << min << ") len[n++] = p;"		"\n";
+			}
+			else if (max > min)
+			{
+				s << "  len[n++] = p;"										"\n"
+					 "  count++;"											"\n";
+			}
+			else
+			{
+				s << "  count++;"											"\n";
+			}
+			s << " }"														"\n"
+				 " while (count >= " << min << ") {"						"\n"
+				 "  p = chain_next(text + pos, chain);"						"\n"
+				 "  if (p >= 0) return pos + p;"							"\n";
+			if (max > min)
+			{
+				s << "  if (n == 0) break;"									"\n"
+					 "  pos -= len[--n];"									"\n";
+			}
+			else
+			{
+				s << "  break;"												"\n";
+			}
+			s << " }"														"\n"
+				 " return -1;"												"\n"
+				 "}"														"\n\n";
+			return s.str();
+		}
 		s << this->cprototype() << " {"									"\n"
 			 " int pos = 0, p = 0;"										"\n"
 			 " stack_int stack;"										"\n"
@@ -171,7 +303,7 @@ namespace pgen
 	 *  	pos += p;
 	 *  	count++;
 	 *  }
-	 *  while (%max != INF ? "count <= " + max : "true"%) {
+	 *  while (%max != INF ? "count <= " + max : "1"%) {
 	 *   p = chain_next(text + pos, chain);
 	 *   if (p >= 0) return pos + p;
 	 *   p = %expr->funcname()%(text + pos);
@@ -198,7 +330,7 @@ namespace pgen
 		}
 		else 
 		{ 
-			s << "true";
+			s << "1";
 		}
 		s << ") {"																						"\n"
 			 "  p = chain_next(text + pos, chain);"														"\n"
@@ -270,11 +402,103 @@ namespace pgen
 		return (greedy ? compile_greedy() : compile_lazy());
 	}
 
+	bool Quantified::deterministic()
+	{
+		return (min == max && expr->deterministic());
+	}
+
+	/**
+	 * Literal quantified expressions (see Quantified::literal()) are compared at once (see Text::compare).
+	 * inlined code:
+	 *  {
+	 *   int count;
+	 *   for (count = 0; count < %min%; count++) {
+	 *    %expr->icompile()%
+	 *   }
+	 *  }
+	 */
+	string Quantified::icompile()
+	{
+		if (!this->deterministic())
+		{
+			return ICompilable::icompile();
+		}
+		string bytes;
+		if (this->literal(bytes))
+		{
+			return Text::compare(bytes);
+		}
+		stringstream s;
+		s << " {"													"\n"
+			 "  int count;"											"\n"
+			 "  for (count = 0; count < " << min << "; count++) {"	"\n"
+		  << expr->icompile() <<
+			 "  }"													"\n"
+			 " }"													"\n";
+		return s.str();
+	}
+
+	bool Quantified::literal(string& bytes)
+	{
+		if (min != max || max == INF)
+		{
+			return false;
+		}
+		string lit;
+		if (!expr->literal(lit))
+		{
+			return false;
+		}
+		for (unsigned int i = 0; i < min; i++)
+		{
+			bytes += lit;
+		}
+		return true;
+	}
+
 	vector<ICompilable*> & Quantified::dependences() 
 	{
 		return this->deps;
 	}
 
+	bool Quantified::nullable()
+	{
+		return min == 0 || expr->nullable();
+	}
+
+	void Quantified::first(IntervalSet& set)
+	{
+		if (max > 0)
+		{
+			expr->first(set);
+		}
+	}
+
+	string Quantified::str()
+	{
+		stringstream s;
+		int t = expr->type();
+		if (t == Character::TYPE || t == Range::TYPE || t == CharClass::TYPE)
+		{
+			s << expr->str();
+		}
+		else
+		{
+			s << "(" << expr->str() << ")";
+		}
+		if (min == 0 && max == INF) s << "*";
+		else if (min == 1 && max == INF) s << "+";
+		else if (min == 0 && max == 1) s << "?";
+		else if (min == max) s << "{" << min << "}";
+		else if (max == INF) s << "{" << min << ",}";
+		else s << "{" << min << "," << max << "}";
+		if (!greedy)
+		{
+			s << "?";
+		}
+		return s.str();
+	}
+
 	string Quantified::name() 
 	{
 		stringstream s;
@@ -79,6 +79,11 @@ namespace pgen
 		 * Used to refer to an infinite amount.
 		 */
 		static const unsigned int INF = UINT_MAX;
+		/**
+		 * Maximum number of optional occurrences (max - min) of a bounded expression whose lengths are saved on an 
+		 * array in automatic storage by the chained code, instead of a stack_int (see Quantified::ccompile_greedy()).
+		 */
+		static const unsigned int MAX_COUNTED = 1024;
 		/**
 		 * Constructor. Requires an ICompilable expression, the minimum and maximum occurrence.
 		 * \param pExpr an ICompilable expression to quantify.
@@ -98,6 +103,21 @@ namespace pgen
 		Quantified(ICompilable* pExpr, unsigned int min, unsigned int max, bool greedy);
 		virtual ~Quantified();
 
+		/**
+		 * \return the minimum occurrence of the expression.
+		 */
+		unsigned int getMin();
+		/**
+		 * \return the maximum occurrence of the expression (INF when it is unbounded).
+		 */
+		unsigned int getMax();
+		/**
+		 * Detaches the quantified expression from the quantifier, so that it is not deleted with it (e.g. when the 
+		 * quantifier is replaced by an equivalent expression, see Simplifier).
+		 * \return the quantified expression, which is now owned by the caller.
+		 */
+		ICompilable* release();
+
 		/**
 		 * Returns C code that can parse the greedy quantified expression.
 		 * The returned code should be a function with the following prototype:
@@ -149,12 +169,39 @@ namespace pgen
 		 * \return the compiled C code that parses the expression.
 		 */
 		virtual string compile();
+		/**
+		 * \returns true when the quantifier has a fixed number of occurrences (i.e. {n}) and the quantified
+		 * expression is deterministic.
+		 */
+		virtual bool deterministic();
+		/**
+		 * Returns C statements that match the quantified expression inline (see ICompilable::icompile()).
+		 * \return the inlined C statements that match the quantified expression.
+		 */
+		virtual string icompile();
+		/**
+		 * Appends the bytes of the expression, repeated "min" times, to "bytes" (see ICompilable::literal()).
+		 * \returns true when the expression is literal and has a fixed number of occurrences (min == max).
+		 */
+		virtual bool literal(string& bytes);
 		/**
 		 * Returns a vector<ICompilable> of dependences in case of using the chained version
 		 * of the algorithm. It can also return NULL when there are no dependences.
 		 * \return A vector of ICompilable dependences of the code.
 		 */
 		virtual vector<ICompilable*> & dependences();
+		/**
+		 * \returns true when the minimum occurrence is zero or the quantified expression is nullable.
+		 */
+		virtual bool nullable();
+		/**
+		 * Adds the first characters of the quantified expression to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the quantified expression followed by its quantifier, e.g. "(ab)+?".
+		 */
+		virtual string str();
 		/**
 		 * Returns the name of the expression. The returned name must be usable as a function
 		 * name in the standard C (C99). i.e. it has to match the following format:
@@ -30,6 +30,7 @@
 #include <iostream>
 // pgen
 #include "Range.h"
+#include "../misc/Util.h"
 
 using namespace std;
 namespace pgen {
@@ -104,8 +105,6 @@ namespace pgen {
 	}
 
 	Range::Range(unsigned int start, unsigned int end)
-	 : next(nullptr)
-	 , prev(nullptr) 
 	{
 		if (start < end) 
 		{
@@ -179,6 +178,38 @@ namespace pgen {
 		return s.str();
 	}
 
+	bool Range::deterministic()
+	{
+		return true;
+	}
+
+	/**
+	 * inlined code:
+	 *  {
+	 *   unsigned int c = next_utf8(text, &pos);
+	 *   if (c < %start% || c > %end%) return -1;
+	 *  }
+	 */
+	string Range::icompile()
+	{
+		stringstream s;
+		s << " {"																	"\n"
+			 "  unsigned int c = next_utf8(text, &pos);"							"\n"
+			 "  if (c < " << this->start << " || c > " << this->end << ") return -1;"	"\n"
+			 " }"																	"\n";
+		return s.str();
+	}
+
+	void Range::first(IntervalSet& set)
+	{
+		set.add(start, end);
+	}
+
+	string Range::str()
+	{
+		return "[" + Util::int2regex(start) + "-" + Util::int2regex(end) + "]";
+	}
+
 	string Range::name() 
 	{
 		stringstream s;
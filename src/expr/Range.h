@@ -21,8 +21,8 @@
  * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
  * \date 2014-06-13
  * \file
- * The Range class represents a single range of characters, e.g. A-Z. This class is not used directly. It is currently 
- * used by the CharClass to deal with character range definitions inside the character class definition.
+ * The Range class represents a single range of characters, e.g. A-Z. This class is not used directly. The CharClass 
+ * keeps its ranges on an IntervalSet instead.
  */
 
 #ifndef RANGE_H_
@@ -46,8 +46,6 @@ namespace pgen
 	public:
 		unsigned int start;			//< First character of the interval
 		unsigned int end;			//< Last character of the interval
-		Range * next;				//< Pointer to the next interval on the list
-		Range * prev;				//< Pointer to the previous interval on the list
 
 		/**
 		 * Checks if a given character is in the interval limits.
@@ -148,6 +146,23 @@ namespace pgen
 		 * \return the compiled C code that parses the expression.
 		 */
 		virtual string compile();
+		/**
+		 * \returns true, a range of characters always matches a single character.
+		 */
+		virtual bool deterministic();
+		/**
+		 * Returns C statements that match the range inline (see ICompilable::icompile()).
+		 * \return the inlined C statements that match the range.
+		 */
+		virtual string icompile();
+		/**
+		 * Adds the range to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the range written as a class of characters, e.g. "[a-z]".
+		 */
+		virtual string str();
 		/**
 		 * Returns the name of the class. The returned name must be usable as a function
 		 * name in the standard C (C99). i.e. it has to match the following format:
@@ -42,13 +42,16 @@
 #include "RegexEscape.h"
 #include "../parser/NamedClassManager.h"
 #include "../misc/Util.h"
+#include "../misc/IntervalSet.h"
+#include "../misc/UnicodeData.h"
 #include "../misc/RegexException.h"
 
 using namespace std;
 namespace pgen 
 {
 	
-	Regex::Regex(string expression, NamedClassManager& ncm) 
+	Regex::Regex(string expression, NamedClassManager& ncm, bool ignoreCase) 
+	 : ignoreCase(ignoreCase)
 	{
 		this->parse(expression, ncm);
 	}
@@ -75,6 +78,7 @@ namespace pgen
 		ICompilable* top = nullptr;
 		string error;
 		unsigned int codeChar, codeCount, min;
+		bool outerIgnoreCase = this->ignoreCase;	//< the inline flags only last until the end of the group.
 		while (pos < expression.length()) 
 		{
 			unsigned int c = Util::next_utf8(expression, pos);
@@ -86,7 +90,7 @@ namespace pgen
 				{
 				// 1.1. Escape start on alternative state
 				case '\\':
-					seqStack.push_back(RegexEscape::parse(expression, pos));
+					seqStack.push_back(caseless(RegexEscape::parse(expression, pos)));
 					break;
 				// 1.2. 0-N Quantifier on alternative state
 				case '*':
@@ -143,7 +147,7 @@ namespace pgen
 					break;
 				// 1.6. Class start on Alternative State
 				case '[':
-					seqStack.push_back(CharClass::parse(expression, pos, ncm));
+					seqStack.push_back(CharClass::parse(expression, pos, ncm, this->ignoreCase));
 					break;
 				// 1.7. New alternative on Alternative State
 				case '|':
@@ -157,7 +161,34 @@ namespace pgen
 					seq = nullptr;
 					break;
 				// 1.8. New Group (subset of alternatives) on Alternative State
+				// The inline flags (?i) and (?-i) change the case sensitivity until the end of the current group, while
+				// (?i:...) and (?-i:...) start a new group with the flag. (?:...) is the same as a plain group.
 				case '(':
+					if (expression.compare(pos, 1, "?") == 0)
+					{
+						bool flag = (expression.compare(pos + 1, 1, "-") != 0);
+						unsigned int p = (flag ? pos + 1 : pos + 2);
+						bool hasFlag = (expression.compare(p, 1, "i") == 0);
+						p += (hasFlag ? 1 : 0);
+						if (hasFlag && expression.compare(p, 1, ")") == 0)
+						{
+							this->ignoreCase = flag;
+							pos = p + 1;
+							break;
+						}
+						if ((hasFlag || flag) && expression.compare(p, 1, ":") == 0)
+						{
+							bool outer = this->ignoreCase;
+							this->ignoreCase = (hasFlag ? flag : outer);
+							pos = p + 1;
+							this->group++;
+							seqStack.push_back(this->parse(expression, pos, new Alternative(), ncm));
+							this->ignoreCase = outer;
+							break;
+						}
+						error = "Invalid inline flag, expected (?i), (?-i), (?i:...), (?-i:...) or (?:...).";
+						goto parse_throw_exception;
+					}
 					this->group++;
 					seqStack.push_back(this->parse(expression, pos, new Alternative(), ncm));
 					break;
@@ -180,7 +211,7 @@ namespace pgen
 					break;
 				// 1.12. Any other character is pushed as a character to be matched.
 				default:
-					seqStack.push_back(new Character(c));
+					seqStack.push_back(caseless(new Character(c)));
 					break;
 				}
 				break;
@@ -261,6 +292,7 @@ namespace pgen
 		}
 	// Exit gracefully (makes sure everything is deleted properly).
 	parse_exit:
+		this->ignoreCase = outerIgnoreCase;
 		// If the expression ends by length, check if it ended on an accepted state
 		if (state != RegexState::MakeAlternative) 
 		{
@@ -296,6 +328,34 @@ namespace pgen
 	#undef STATE_CALL
 	}
 
+	ICompilable* Regex::caseless(ICompilable* expression)
+	{
+		if (!this->ignoreCase)
+		{
+			return expression;
+		}
+		if (expression->type() == Character::TYPE)
+		{
+			IntervalSet variants;
+			unsigned int c = reinterpret_cast<Character*>(expression)->getChar();
+			variants.add(c, c);
+			UnicodeData::fold(variants);
+			if (variants.size() == 1 && variants.begin()->first == variants.begin()->second)
+			{
+				return expression;
+			}
+			CharClass* cClass = new CharClass();
+			cClass->add(variants);
+			delete expression;
+			return cClass;
+		}
+		if (expression->type() == CharClass::TYPE)
+		{
+			reinterpret_cast<CharClass*>(expression)->fold();
+		}
+		return expression;
+	}
+
 	#ifdef _DEBUG
 	void Regex::print(int level)
 	{
@@ -54,10 +54,26 @@ namespace pgen
 	{
 	private:
 		int group;				//< Group count, for parsing.
+		bool ignoreCase;		//< Case insensitive flag, for parsing (see the inline flag "(?i)").
 		ICompilable* parse(string& expression, NamedClassManager& ncm);
 		ICompilable* parse(string& expression, unsigned int &pos, Alternative* alt, NamedClassManager& ncm);	
+		/**
+		 * Makes a character or a class of characters case insensitive, when the ignoreCase flag is set. Characters 
+		 * that have case variants are replaced by the class of their variants (e.g. 'a' becomes [aA]).
+		 * \param expression the parsed character or class of characters.
+		 * \return the expression that matches the case variants (it may be the same object).
+		 */
+		ICompilable* caseless(ICompilable* expression);
 	public:
-		Regex(string expression, NamedClassManager &ncm);
+		/**
+		 * Parses a regular expression.
+		 * \param expression the regular expression.
+		 * \param ncm the named classes that can be used by the expression.
+		 * \param ignoreCase when true, the expression matches the text regardless of the case of the letters. The case
+		 * sensitivity can also be changed by the expression itself, with the inline flags "(?i)" and "(?-i)" (until 
+		 * the end of the current group) or "(?i:...)" and "(?-i:...)" (inside the group).
+		 */
+		Regex(string expression, NamedClassManager &ncm, bool ignoreCase = false);
 		virtual ~Regex();
 		
 		#ifdef _DEBUG
@@ -34,6 +34,7 @@
 #include "RegexState.h"
 #include "RegexEscape.h"
 #include "../misc/Util.h"
+#include "../misc/UnicodeData.h"
 #include "../misc/RegexException.h"
 
 
@@ -96,6 +97,41 @@ namespace pgen
 		return new Character(charCode);
 	}
 	
+	ICompilable* RegexEscape::property(string& expression, unsigned int& pos, bool negated)
+	{
+		string name;
+		unsigned int c = Util::next_utf8(expression, pos);
+		if (c == '{')
+		{
+			c = Util::next_utf8(expression, pos);
+			while (c != '}')
+			{
+				if (pos >= expression.length())
+				{
+					throw RegexException(expression, pos, "Unexpected end of expression, expecting '}' at the end of a Unicode property.");
+				}
+				name += Util::int2utf8(c);
+				c = Util::next_utf8(expression, pos);
+			}
+		}
+		else
+		{
+			name = Util::int2utf8(c);
+		}
+		IntervalSet set;
+		if (!UnicodeData::get(name, set))
+		{
+			throw RegexException(expression, pos, "Unknown Unicode property '" + name + "'.");
+		}
+		CharClass* cClass = new CharClass();
+		cClass->add(set);
+		if (negated)
+		{
+			cClass->invert();
+		}
+		return cClass;
+	}
+	
 	ICompilable* RegexEscape::parse(string& expression, unsigned int& pos)
 	{
 		unsigned int c = 0;
@@ -132,6 +168,12 @@ namespace pgen
 		// \S = the class of all kinds of non-space characters. Equivalent to [^ \t\r\n\v\f]
 		case 'S': 
 			return RegexEscape::nonSpacesClass();
+		// \p = the class of characters that have an Unicode property (\p{Greek}, \p{Lu}, \pL)
+		case 'p':
+			return RegexEscape::property(expression, pos, false);
+		// \P = the class of characters that don't have an Unicode property (\P{Greek}, \P{Lu}, \PL)
+		case 'P':
+			return RegexEscape::property(expression, pos, true);
 		// \u = the beggining of an unicode escape sequence (\uXXXX)
 		case 'u': 
 			return RegexEscape::Hex(expression, pos, 4);
@@ -44,6 +44,7 @@ namespace pgen
 		static ICompilable* nonSpacesClass();
 		static ICompilable* Hex(string& expression, unsigned int& pos, int len);
 		static ICompilable* Octal(string& expression, unsigned int& pos, int len);
+		static ICompilable* property(string& expression, unsigned int& pos, bool negated);
 	public:
 		static ICompilable* parse(string& text, unsigned int& pos);
 	};
@@ -37,6 +37,8 @@
 // pgen
 #include "ICompilable.h"
 #include "Sequence.h"
+#include "Text.h"
+#include "Alternative.h"
 
 using namespace std;
 namespace pgen 
@@ -60,89 +62,256 @@ namespace pgen
 		expr.push_back(expression);
 	}
 
+	unsigned int Sequence::fused()
+	{
+		unsigned int count = 0;
+		while (count < expr.size() && expr[count]->deterministic())
+		{
+			count++;
+		}
+		return count;
+	}
+
 	/**
+	 * The leading deterministic expressions (see Sequence::fused()) are inlined on the compiled function, only the 
+	 * remaining expressions are called through the chain of function pointers.
 	 * compiled code: (chained version)
+	 * %if (fused() < expr.size())%
 	 * chainptr fc%name()%[] = {
-	 * %for (int i=0; i<expr->size(); i++)%
+	 * %for (int i=fused(); i<expr.size(); i++)%
 	 *   {(int (*)())(%expr[i]->cfuncname()%)},
 	 * %end for%
 	 *   {CHAIN_JUMP},
 	 *   {NULL}
 	 * };
+	 * %end if%
 	 *
 	 * %cprototype()% {
-	 *  fc%name()%[%expr.size()+1%].subchain = chain;
-	 *  return next_chain(text, fc%name()%);
+	 *  int pos = 0, p;
+	 * %for (int i=0; i<fused(); i++)%
+	 *  %expr[i]->icompile()%
+	 * %end for%
+	 * %if (fused() < expr.size())%
+	 *  fc%name()%[%expr.size()-fused()+1%].subchain = chain;
+	 *  p = chain_next(text + pos, fc%name()%);
+	 * %else%
+	 *  p = chain_next(text + pos, chain);
+	 * %end if%
+	 *  if (p == -1) return -1;
+	 *  return pos + p;
 	 * }
 	 */
 	string Sequence::ccompile() 
 	{
 		stringstream s;
 		string name = this->name();
-		s << "chainptr fc" << name << "[] = {" 								"\n";
-		for (unsigned int i=0; i < expr.size(); i++) 
-		{
-			s << " {(int (*)())(" << expr[i]->cfuncname() << ")},"			"\n";
-		}
-		s << " {CHAIN_JUMP},"												"\n"
-			 " {NULL}" 														"\n"
-			 "};" 															"\n\n"
-		  << cprototype() << " {" 											"\n"
-			 " fc" << name << "[" << expr.size()+1 << "].subchain = chain;" "\n"
-			 " return next_chain(text, fc" << name << ");"					"\n"
-			 "}" 															"\n\n";
+		unsigned int fused = this->fused();
+		if (fused < expr.size())
+		{
+			s << "chainptr fc" << name << "[] = {" 								"\n";
+			for (unsigned int i = fused; i < expr.size(); i++) 
+			{
+				s << " {(int (*)())(" << expr[i]->cfuncname() << ")},"			"\n";
+			}
+			s << " {CHAIN_JUMP},"												"\n"
+				 " {NULL}" 														"\n"
+				 "};" 															"\n\n";
+		}
+		s << cprototype() << " {" 												"\n"
+			 " int pos = 0, p;"													"\n";
+		s << this->icompile(fused);
+		if (fused < expr.size())
+		{
+			s << " fc" << name << "[" << expr.size()-fused+1 << "].subchain = chain;"	"\n"
+				 " p = chain_next(text + pos, fc" << name << ");"				"\n";
+		}
+		else
+		{
+			s << " p = chain_next(text + pos, chain);"							"\n";
+		}
+		s << " if (p == -1) return -1;"											"\n"
+			 " return pos + p;"													"\n"
+			 "}" 																"\n\n";
 		return s.str();
 	}
 
 	/**
+	 * The leading deterministic expressions (see Sequence::fused()) are inlined on the compiled function, only the 
+	 * remaining expressions are called through the chain of function pointers. When at most the last expression is
+	 * not deterministic, it is called directly and no chain is needed at all.
 	 * compiled code: (non-chained version)
+	 * %if (fused()+1 < expr.size())%
 	 * chainptr f%name()%[] = {
-	 * %for (int i=0; i<expr.size()-1; i++)%
+	 * %for (int i=fused(); i<expr.size()-1; i++)%
 	 *   {(int (*)())(%expr[i]->cfuncname()%)},
 	 * %end for%
-	 * %if (expr.size() > 0)%
 	 *   {(int (*)())(%expr[expr.size()-1]->funcname()%)},
-	 * %end if%
 	 *   {NULL}
 	 * };
+	 * %end if%
 	 *
 	 * %prototype()% {
-	 *  return next_chain(text, f%name()%);
+	 *  int pos = 0;
+	 * %for (int i=0; i<fused(); i++)%
+	 *  %expr[i]->icompile()%
+	 * %end for%
+	 * %if (fused() == expr.size())%
+	 *  return pos;
+	 * %else%
+	 *  int p = %fused()+1 < expr.size() ? "chain_next(text + pos, f" + name() + ")" : expr.back()->funcname() + "(text + pos)"%;
+	 *  if (p == -1) return -1;
+	 *  return pos + p;
+	 * %end if%
 	 * }
 	 */
 	string Sequence::compile() 
 	{
 		stringstream s;
 		string name = this->name();
-		s << "chainptr f" << name << "[] = {"									"\n";
-		for (unsigned int i=0; i < expr.size()-1; i++) 
+		unsigned int fused = this->fused();
+		if (fused+1 < expr.size())
+		{
+			s << "chainptr f" << name << "[] = {"								"\n";
+			for (unsigned int i = fused; i < expr.size()-1; i++) 
+			{
+				s << " {(int (*)())(" << expr[i]->cfuncname() << ")},"			"\n";
+			}
+			s << " {(int (*)())(" << expr.back()->funcname() << ")},"			"\n"
+				 " {NULL}" 														"\n"
+				 "};"															"\n\n";
+		}
+		s << prototype() << " {"												"\n"
+			 " int pos = 0;"													"\n";
+		s << this->icompile(fused);
+		if (fused == expr.size())
 		{
-			s << " {(int (*)())(" << expr[i]->cfuncname() << ")},"				"\n";
+			s << " return pos;"													"\n";
 		}
-		if (expr.size() > 0) 
-		{ 
-			s << " {(int (*)())(" << expr[expr.size()-1]->funcname() << ")},"	"\n";
+		else
+		{
+			if (fused+1 < expr.size())
+			{
+				s << " int p = chain_next(text + pos, f" << name << ");"		"\n";
+			}
+			else
+			{
+				s << " int p = " << expr.back()->funcname() << "(text + pos);"	"\n";
+			}
+			s << " if (p == -1) return -1;"										"\n"
+				 " return pos + p;"												"\n";
 		}
-		s << " {NULL}" 															"\n"
-			 "};"																"\n\n"
-		  << prototype() << " {"												"\n"
-			 " return chain_next(text, f" << name << ");"						"\n"
-			 "}"																"\n\n";
+		s << "}"																"\n\n";
 		return s.str();
 	}
 
+	bool Sequence::deterministic()
+	{
+		return (this->fused() == expr.size());
+	}
+
+	/**
+	 * Consecutive literal expressions (see ICompilable::literal()) are merged and compared at once.
+	 * inlined code:
+	 * %for (int i=0; i<count; i++)%
+	 * %if (expr[i] starts a run of literal expressions)%
+	 *  %Text::compare(bytes of the run)%
+	 * %else%
+	 *  %expr[i]->icompile()%
+	 * %end if%
+	 * %end for%
+	 */
+	string Sequence::icompile(unsigned int count)
+	{
+		stringstream s;
+		string bytes;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			string lit;
+			if (expr[i]->literal(lit))
+			{
+				bytes += lit;
+				continue;
+			}
+			s << Text::compare(bytes) << expr[i]->icompile();
+			bytes.clear();
+		}
+		s << Text::compare(bytes);
+		return s.str();
+	}
+
+	string Sequence::icompile()
+	{
+		if (!this->deterministic())
+		{
+			return ICompilable::icompile();
+		}
+		return this->icompile(expr.size());
+	}
+
+	bool Sequence::literal(string& bytes)
+	{
+		for (ICompilable* c: expr)
+		{
+			if (!c->literal(bytes)) 
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
 	vector<ICompilable*> & Sequence::dependences()
 	{
 		return this->expr;
 	}
 
+	bool Sequence::nullable()
+	{
+		for (ICompilable* c: expr)
+		{
+			if (!c->nullable())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void Sequence::first(IntervalSet& set)
+	{
+		for (ICompilable* c: expr)
+		{
+			c->first(set);
+			if (!c->nullable())
+			{
+				break;
+			}
+		}
+	}
+
+	string Sequence::str()
+	{
+		stringstream s;
+		for (ICompilable* c: expr)
+		{
+			if (c->type() == Alternative::TYPE && c->dependences().size() > 1)
+			{
+				s << "(" << c->str() << ")";
+			}
+			else
+			{
+				s << c->str();
+			}
+		}
+		return s.str();
+	}
+
 	string Sequence::name() 
 	{
 		stringstream s;
-		s << "sq";
 		for (ICompilable* c: this->expr)
 			s << "_" << c->name();
-		return s.str();
+		return intern("sq", s.str());
 	}
 
 	/**
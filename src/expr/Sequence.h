@@ -50,6 +50,13 @@ namespace pgen
 	{
 	private:										// see "Test.h" for more info on tprivate
 		vector<ICompilable*> expr;					//< Sequence of expressions (vector of ICompilable shared pointers).
+
+		/**
+		 * Returns C statements that match the first "count" expressions of the sequence inline.
+		 * \param count the number of expressions to inline, they must all be deterministic.
+		 * \return the inlined C statements that match the expressions.
+		 */
+		string icompile(unsigned int count);
 	public:
 		Sequence();
 		virtual ~Sequence();
@@ -61,6 +68,14 @@ namespace pgen
 		 */
 		void add(ICompilable* expression);
 
+		/**
+		 * Returns the number of leading expressions of the sequence that are deterministic. Those expressions are 
+		 * fused (inlined) into the compiled code of the sequence, only the remaining ones are called through the 
+		 * chain of function pointers.
+		 * \return the number of fused expressions at the beggining of the sequence.
+		 */
+		unsigned int fused();
+
 		// ICompilable Methods Implementation
 		/**
 		 * Returns C code that can parse the regular expression.
@@ -83,17 +98,45 @@ namespace pgen
 		 * \return the compiled C code that parses the expression.
 		 */
 		virtual string compile();
+		/**
+		 * \returns true when all the expressions of the sequence are deterministic.
+		 */
+		virtual bool deterministic();
+		/**
+		 * Returns C statements that match the sequence inline (see ICompilable::icompile()).
+		 * \return the inlined C statements that match the sequence.
+		 */
+		virtual string icompile();
+		/**
+		 * Appends the bytes of every expression to "bytes" (see ICompilable::literal()).
+		 * \returns true when all the expressions of the sequence are literal.
+		 */
+		virtual bool literal(string& bytes);
 		/**
 		 * Returns a vector<ICompilable> of dependences in case of using the chained version
 		 * of the algorithm. It can also return NULL when there are no dependences.
 		 * \return A vector of ICompilable dependences of the code.
 		 */
 		virtual vector<ICompilable*> & dependences();
+		/**
+		 * \returns true when all the expressions of the sequence are nullable.
+		 */
+		virtual bool nullable();
+		/**
+		 * Adds the first characters of the expressions of the sequence to the set, up to the first expression that
+		 * is not nullable (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the concatenation of the expressions of the sequence.
+		 */
+		virtual string str();
 		/**
 		 * Returns the name of the expression. The returned name must be usable as a function
 		 * name in the standard C (C99). i.e. it has to match the following format:
 		 * [a-zA-Z][A-Za-z0-9_]*
-		 * \return The text "chr_" + the text corresponding to the integer value of the character.
+		 * Structurally equal sequences share the same name (see ICompilable::intern()).
+		 * \return The text "sq" followed by the id of the sequence.
 		 */
 		virtual string name();
 		/**
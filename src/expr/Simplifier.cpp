@@ -0,0 +1,497 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-24
+ * \file
+ * This file contains the implementation of the Simplifier class, which rewrites expression trees into simpler 
+ * equivalent ones (see Simplifier.h).
+ */
+
+// STL
+#include <string>
+#include <vector>
+// pgen
+#include "Simplifier.h"
+#include "Character.h"
+#include "CharClass.h"
+#include "Range.h"
+#include "Text.h"
+#include "../misc/Util.h"
+#include "../misc/IntervalSet.h"
+
+using namespace std;
+namespace pgen
+{
+
+	ICompilable* Simplifier::simplify(ICompilable* expr)
+	{
+		return simplify(expr, IntervalSet());
+	}
+
+	void Simplifier::simplify(Alternative& alt)
+	{
+		alternatives(alt.expr, IntervalSet());
+	}
+
+	ICompilable* Simplifier::simplify(ICompilable* expr, const IntervalSet& follow)
+	{
+		switch (expr->type())
+		{
+		case Sequence::TYPE:
+			return sequence(reinterpret_cast<Sequence*>(expr), follow);
+		case Alternative::TYPE:
+			return alternative(reinterpret_cast<Alternative*>(expr), follow);
+		case Quantified::TYPE:
+			return quantified(reinterpret_cast<Quantified*>(expr), follow);
+		default:
+			return expr;
+		}
+	}
+
+	/**
+	 * The items are simplified from the last to the first one: the characters that can follow an item are the first
+	 * characters of the next items, up to the first item that is not nullable, plus the characters that can follow 
+	 * the whole sequence when all the next items are nullable (see Backtracking::analyze()).
+	 */
+	ICompilable* Simplifier::sequence(Sequence* seq, const IntervalSet& follow)
+	{
+		vector<ICompilable*>& expr = seq->dependences();
+		IntervalSet next(follow);
+		for (unsigned int i = expr.size(); i-- > 0; )
+		{
+			expr[i] = simplify(expr[i], next);
+			if (!expr[i]->nullable())
+			{
+				next.clear();
+			}
+			expr[i]->first(next);
+		}
+		flatten(expr, Sequence::TYPE);
+		repetitions(expr);
+		literals(expr);
+		if (expr.size() == 1)
+		{
+			ICompilable* e = expr[0];
+			expr.clear();
+			delete seq;
+			return e;
+		}
+		return seq;
+	}
+
+	/**
+	 * A group of two alternatives where one of them is the empty text is an optional expression: greedy when the empty
+	 * text has the lowest priority ("x|") and lazy otherwise ("|x").
+	 */
+	ICompilable* Simplifier::alternative(Alternative* alt, const IntervalSet& follow)
+	{
+		vector<ICompilable*>& expr = alt->expr;
+		alternatives(expr, follow);
+		if (expr.size() == 2 && (empty(expr[0]) != empty(expr[1])))
+		{
+			bool greedy = empty(expr[1]);
+			ICompilable* e = expr[greedy ? 0 : 1];
+			delete expr[greedy ? 1 : 0];
+			expr.clear();
+			delete alt;
+			return quantified(new Quantified(e, 0, 1, greedy), follow);
+		}
+		if (expr.size() == 1)
+		{
+			ICompilable* e = expr[0];
+			expr.clear();
+			delete alt;
+			return e;
+		}
+		return alt;
+	}
+
+	/**
+	 * Nested greedy quantifiers of the kinds "?", "*" and "+" over a deterministic expression are merged into a single
+	 * quantifier: the result is "+" when both are "+", "?" when both are "?" and "*" otherwise.
+	 * The body of a quantifier is matched without the text that follows it, so the inner quantifier takes all the
+	 * occurrences it can and the outer one can only give them back all at once, while the merged quantifier gives
+	 * them back one by one. That only makes a difference when the text that follows can start with the first 
+	 * characters of the repeated expression (e.g. "(a+)?a"), so the quantifiers are not merged in that case.
+	 */
+	ICompilable* Simplifier::quantified(Quantified* q, const IntervalSet& follow)
+	{
+		unsigned int min = q->getMin(), max = q->getMax();
+		bool greedy = q->greedy;
+		ICompilable* body = simplify(q->release(), IntervalSet());
+		delete q;
+		if (max == 0)
+		{
+			delete body;
+			return new Sequence();
+		}
+		if (body->type() == Quantified::TYPE)
+		{
+			Quantified* inner = reinterpret_cast<Quantified*>(body);
+			unsigned int imin = inner->getMin(), imax = inner->getMax();
+			IntervalSet first;
+			inner->dependences()[0]->first(first);
+			first.intersect(follow);
+			if (greedy && inner->greedy && inner->dependences()[0]->deterministic() && first.empty() &&
+				min <= 1 && (max == 1 || max == Quantified::INF) && imin <= 1 && (imax == 1 || imax == Quantified::INF))
+			{
+				body = inner->release();
+				delete inner;
+				min *= imin;
+				max = (max == Quantified::INF || imax == Quantified::INF) ? Quantified::INF : 1;
+			}
+		}
+		if (min == 1 && max == 1)
+		{
+			return body;
+		}
+		return new Quantified(body, min, max, greedy);
+	}
+
+	void Simplifier::alternatives(vector<ICompilable*>& expr, const IntervalSet& follow)
+	{
+		for (ICompilable*& e: expr)
+		{
+			e = simplify(e, follow);
+		}
+		flatten(expr, Alternative::TYPE);
+		classes(expr);
+		factor(expr, follow);
+	}
+
+	void Simplifier::flatten(vector<ICompilable*>& expr, int type)
+	{
+		vector<ICompilable*> result;
+		for (ICompilable* e: expr)
+		{
+			if (e->type() == type)
+			{
+				vector<ICompilable*>& sub = e->dependences();
+				result.insert(result.end(), sub.begin(), sub.end());
+				sub.clear();
+				delete e;
+			}
+			else
+			{
+				result.push_back(e);
+			}
+		}
+		expr.swap(result);
+	}
+
+	bool Simplifier::repetition(ICompilable* e, ICompilable*& body, unsigned int& min, unsigned int& max)
+	{
+		if (e->type() == Quantified::TYPE)
+		{
+			Quantified* q = reinterpret_cast<Quantified*>(e);
+			body = q->dependences()[0];
+			min = q->getMin();
+			max = q->getMax();
+			return q->greedy && body->deterministic();
+		}
+		body = e;
+		min = max = 1;
+		return e->deterministic();
+	}
+
+	/**
+	 * Two greedy repetitions "x{a,b}x{c,d}" match the same texts as "x{a+c,b+d}" in the same order of priority (the
+	 * longest first) when "x" is deterministic and the second repetition is unbounded, or has at most two choices
+	 * (d-c <= 1), or the first one has a single choice (a = b). Otherwise, the backtracking code would try "x{b+c}" 
+	 * before "x{b+c+1}".
+	 */
+	void Simplifier::repetitions(vector<ICompilable*>& expr)
+	{
+		unsigned int i = 1;
+		while (i < expr.size())
+		{
+			ICompilable *first, *second;
+			unsigned int a, b, c, d;
+			if (
+				(expr[i-1]->type() == Quantified::TYPE || expr[i]->type() == Quantified::TYPE) &&
+				repetition(expr[i-1], first, a, b) && repetition(expr[i], second, c, d) && 
+				first->name() == second->name() &&
+				(d == Quantified::INF || d - c <= 1 || a == b) &&
+				(b == Quantified::INF || d == Quantified::INF || b < Quantified::INF - d) &&
+				a < Quantified::INF - c
+			)
+			{
+				unsigned int max = (b == Quantified::INF || d == Quantified::INF) ? Quantified::INF : b + d;
+				if (expr[i-1]->type() == Quantified::TYPE)
+				{
+					first = reinterpret_cast<Quantified*>(expr[i-1])->release();
+					delete expr[i-1];
+				}
+				delete expr[i];
+				expr[i-1] = new Quantified(first, a + c, max);
+				expr.erase(expr.begin() + i);
+				continue;
+			}
+			i++;
+		}
+	}
+
+	void Simplifier::literals(vector<ICompilable*>& expr)
+	{
+		vector<ICompilable*> result;
+		unsigned int i = 0;
+		while (i < expr.size())
+		{
+			string bytes;
+			unsigned int j = i;
+			while (j < expr.size() && expr[j]->literal(bytes))
+			{
+				j++;
+			}
+			if (j - i > 1)
+			{
+				for (unsigned int k = i; k < j; k++)
+				{
+					delete expr[k];
+				}
+				result.push_back(text(bytes));
+				i = j;
+			}
+			else
+			{
+				result.push_back(expr[i++]);
+			}
+		}
+		expr.swap(result);
+	}
+
+	void Simplifier::classes(vector<ICompilable*>& expr)
+	{
+		vector<ICompilable*> result;
+		unsigned int i = 0;
+		while (i < expr.size())
+		{
+			unsigned int j = i;
+			while (j < expr.size() && 
+				(expr[j]->type() == Character::TYPE || expr[j]->type() == Range::TYPE || expr[j]->type() == CharClass::TYPE))
+			{
+				j++;
+			}
+			if (j - i > 1)
+			{
+				IntervalSet set;
+				for (unsigned int k = i; k < j; k++)
+				{
+					expr[k]->first(set);
+					delete expr[k];
+				}
+				CharClass* cClass = new CharClass();
+				cClass->add(set);
+				result.push_back(cClass);
+				i = j;
+			}
+			else
+			{
+				result.push_back(expr[i++]);
+			}
+		}
+		expr.swap(result);
+	}
+
+	/**
+	 * The alternatives are grouped by their first character (when they start with a literal text) or by their first
+	 * expression (when it is deterministic). Literal alternatives are not factored, since they are already matched
+	 * by a Trie (see Alternative::literals()).
+	 */
+	void Simplifier::factor(vector<ICompilable*>& expr, const IntervalSet& follow)
+	{
+		string bytes;
+		bool literal = true;
+		for (ICompilable* e: expr)
+		{
+			literal = literal && e->literal(bytes);
+		}
+		if (literal)
+		{
+			return;
+		}
+		vector<string> keys;
+		for (ICompilable* e: expr)
+		{
+			vector<ICompilable*> elements = (e->type() == Sequence::TYPE ? e->dependences() : vector<ICompilable*>{e});
+			string lit;
+			if (!elements.empty() && elements[0]->literal(lit) && !lit.empty())
+			{
+				unsigned int pos = 0;
+				Util::next_utf8(lit, pos);
+				keys.push_back("'" + lit.substr(0, pos));
+			}
+			else if (!elements.empty() && elements[0]->deterministic())
+			{
+				keys.push_back("#" + elements[0]->name());
+			}
+			else
+			{
+				keys.push_back("");
+			}
+		}
+		vector<ICompilable*> result;
+		unsigned int i = 0;
+		while (i < expr.size())
+		{
+			unsigned int j = i + 1;
+			while (j < expr.size() && !keys[i].empty() && keys[j] == keys[i])
+			{
+				j++;
+			}
+			if (j - i > 1)
+			{
+				result.push_back(factor(vector<ICompilable*>(expr.begin() + i, expr.begin() + j), follow));
+			}
+			else
+			{
+				result.push_back(expr[i]);
+			}
+			i = j;
+		}
+		expr.swap(result);
+	}
+
+	/**
+	 * The prefix is made of the longest common literal text at the beginning of the alternatives (cut at a character
+	 * boundary) and, when all the alternatives start with the same text, the following deterministic expressions 
+	 * that are equal on all the alternatives.
+	 */
+	ICompilable* Simplifier::factor(const vector<ICompilable*>& expr, const IntervalSet& follow)
+	{
+		vector<vector<ICompilable*>> elements;
+		vector<string> texts;
+		vector<unsigned int> counts;
+		for (ICompilable* e: expr)
+		{
+			elements.push_back(e->type() == Sequence::TYPE ? e->dependences() : vector<ICompilable*>{e});
+			string bytes;
+			unsigned int count = 0;
+			while (count < elements.back().size() && elements.back()[count]->literal(bytes))
+			{
+				count++;
+			}
+			texts.push_back(bytes);
+			counts.push_back(count);
+		}
+		// common literal text
+		string prefix = texts[0];
+		for (const string& t: texts)
+		{
+			unsigned int len = 0;
+			while (len < prefix.size() && len < t.size() && prefix[len] == t[len])
+			{
+				len++;
+			}
+			prefix.resize(len);
+		}
+		for (const string& t: texts)
+		{
+			while (!prefix.empty() && prefix.size() < t.size() && (t[prefix.size()] & 0xC0) == 0x80)
+			{
+				prefix.resize(prefix.size() - 1);
+			}
+		}
+		// common deterministic expressions
+		unsigned int common = 0;
+		bool same = true;
+		for (const string& t: texts)
+		{
+			same = same && (t == prefix);
+		}
+		while (same)
+		{
+			for (unsigned int i = 0; i < expr.size() && same; i++)
+			{
+				unsigned int k = counts[i] + common;
+				same = (k < elements[i].size() && elements[i][k]->deterministic() && 
+					elements[i][k]->name() == elements[0][counts[0] + common]->name());
+			}
+			if (same)
+			{
+				common++;
+			}
+		}
+		// the prefix is followed by the group of the remaining expressions of each alternative
+		Sequence* seq = new Sequence();
+		if (!prefix.empty())
+		{
+			seq->add(text(prefix));
+		}
+		Alternative* alt = new Alternative();
+		for (unsigned int i = 0; i < expr.size(); i++)
+		{
+			// a sequence is replaced by the remaining expressions, any other alternative is the single element
+			if (expr[i]->type() == Sequence::TYPE)
+			{
+				expr[i]->dependences().clear();
+				delete expr[i];
+			}
+			Sequence* rest = new Sequence();
+			if (texts[i].size() > prefix.size())
+			{
+				rest->add(text(texts[i].substr(prefix.size())));
+			}
+			for (unsigned int k = 0; k < elements[i].size(); k++)
+			{
+				if (k < counts[i])
+				{
+					delete elements[i][k];
+				}
+				else if (k < counts[i] + common)
+				{
+					if (i == 0)
+					{
+						seq->add(elements[i][k]);
+					}
+					else
+					{
+						delete elements[i][k];
+					}
+				}
+				else
+				{
+					rest->add(elements[i][k]);
+				}
+			}
+			alt->add(rest);
+		}
+		seq->add(alt);
+		return sequence(seq, follow);
+	}
+
+	ICompilable* Simplifier::text(const string& bytes)
+	{
+		unsigned int pos = 0;
+		unsigned int c = Util::next_utf8(bytes, pos);
+		if (pos == bytes.size())
+		{
+			return new Character(c);
+		}
+		return new Text(bytes);
+	}
+
+	bool Simplifier::empty(ICompilable* e)
+	{
+		return (e->type() == Sequence::TYPE && e->dependences().empty());
+	}
+
+} /* namespace pgen */
@@ -0,0 +1,152 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ *
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-24
+ * \file
+ * The Simplifier class rewrites the expression trees built by the Regex parser into equivalent trees that compile to
+ * fewer functions and fewer backtracking points. The following rewrites are applied, bottom-up:
+ *  - nested sequences and nested alternatives are flattened, and groups with a single element are unwrapped;
+ *  - consecutive literal expressions of a sequence are merged into a single Text, e.g. "abc";
+ *  - consecutive alternatives that match a single character are merged into a CharClass, e.g. "a|b|[0-9]";
+ *  - the common prefix of consecutive alternatives is factored out, e.g. "abc|abd[0-9]" becomes "ab(c|d[0-9])";
+ *  - an alternative between an expression and the empty text becomes an optional quantifier, e.g. "ab|a" becomes 
+ *    "ab?" (and "a|ab" becomes "ab??");
+ *  - consecutive repetitions of the same expression are merged, e.g. "x*x*" becomes "x*" and "[0-9][0-9]*" becomes 
+ *    "[0-9]+";
+ *  - nested quantifiers are merged, e.g. "(x+)*" becomes "x*", and "x{1}" becomes "x", unless the text that follows
+ *    can start like "x" (e.g. "(a+)?a").
+ * The rewrites keep the priorities of the backtracking code: the same text is matched for every input, including the
+ * choice between alternatives and the number of occurrences of greedy and lazy quantifiers. That is why prefixes and 
+ * repetitions are only merged when the repeated expression is deterministic (see ICompilable::deterministic()), and 
+ * only adjacent alternatives are merged.
+ */
+
+#ifndef SIMPLIFIER_H_
+#define SIMPLIFIER_H_
+
+// STL
+#include <string>
+#include <vector>
+// pgen
+#include "ICompilable.h"
+#include "Alternative.h"
+#include "Sequence.h"
+#include "Quantified.h"
+#include "../misc/IntervalSet.h"
+
+using namespace std;
+namespace pgen
+{
+	class Simplifier
+	{
+	private:
+		/**
+		 * Simplifies an expression (see Simplifier::simplify()).
+		 * \param expr the expression to simplify.
+		 * \param follow the characters that can start the text matched after the expression, up to the end of the
+		 * enclosing quantifier body or of the whole expression.
+		 */
+		static ICompilable* simplify(ICompilable* expr, const IntervalSet& follow);
+		/**
+		 * Simplifies a sequence (see Simplifier::simplify()).
+		 */
+		static ICompilable* sequence(Sequence* seq, const IntervalSet& follow);
+		/**
+		 * Simplifies a group of alternatives (see Simplifier::simplify()).
+		 */
+		static ICompilable* alternative(Alternative* alt, const IntervalSet& follow);
+		/**
+		 * Simplifies a quantified expression (see Simplifier::simplify()).
+		 */
+		static ICompilable* quantified(Quantified* q, const IntervalSet& follow);
+		/**
+		 * Simplifies a list of alternatives in place.
+		 * \param expr the alternatives, in order of priority.
+		 * \param follow the characters that can follow the alternatives.
+		 */
+		static void alternatives(vector<ICompilable*>& expr, const IntervalSet& follow);
+		/**
+		 * Replaces the sub-sequences of a sequence by their expressions, and the sub-alternatives of a list of 
+		 * alternatives by their alternatives.
+		 * \param expr the expressions of the sequence or the alternatives.
+		 * \param type the type of the expressions that are flattened (Sequence::TYPE or Alternative::TYPE).
+		 */
+		static void flatten(vector<ICompilable*>& expr, int type);
+		/**
+		 * Merges the consecutive repetitions of the same deterministic expression of a sequence (e.g. "x*x+").
+		 */
+		static void repetitions(vector<ICompilable*>& expr);
+		/**
+		 * Merges the consecutive literal expressions of a sequence into a single Text.
+		 */
+		static void literals(vector<ICompilable*>& expr);
+		/**
+		 * Merges the consecutive alternatives that match a single character into a single CharClass.
+		 */
+		static void classes(vector<ICompilable*>& expr);
+		/**
+		 * Factors out the common prefix of consecutive alternatives.
+		 * \param follow the characters that can follow the alternatives.
+		 */
+		static void factor(vector<ICompilable*>& expr, const IntervalSet& follow);
+		/**
+		 * Factors out the common prefix of a group of consecutive alternatives.
+		 * \param expr the alternatives of the group. They are deleted or moved to the returned expression.
+		 * \param follow the characters that can follow the alternatives.
+		 * \return the prefix followed by the group of the remaining alternatives.
+		 */
+		static ICompilable* factor(const vector<ICompilable*>& expr, const IntervalSet& follow);
+		/**
+		 * Gets an expression as a repetition of a deterministic expression: a greedy quantifier or a single 
+		 * occurrence of the expression.
+		 * \param e the expression.
+		 * \param body is set to the repeated expression.
+		 * \param min is set to the minimum occurrence.
+		 * \param max is set to the maximum occurrence.
+		 * \return true when the expression is a repetition of a deterministic expression.
+		 */
+		static bool repetition(ICompilable* e, ICompilable*& body, unsigned int& min, unsigned int& max);
+		/**
+		 * \return a Character when the bytes are a single character, or a Text otherwise.
+		 */
+		static ICompilable* text(const string& bytes);
+		/**
+		 * \return true when the expression matches the empty text only (an empty sequence).
+		 */
+		static bool empty(ICompilable* e);
+	public:
+		/**
+		 * Simplifies an expression. The expression is owned by the simplifier: it may be modified, deleted, or 
+		 * reused on the returned expression.
+		 * \param expr the expression to simplify.
+		 * \return the simplified expression, which must be deleted by the caller.
+		 */
+		static ICompilable* simplify(ICompilable* expr);
+		/**
+		 * Simplifies the alternatives of a group in place (e.g. the alternatives of a Regex, which can not be 
+		 * replaced by another object).
+		 * \param alt the group of alternatives.
+		 */
+		static void simplify(Alternative& alt);
+	}; /* class Simplifier */
+} /* namespace pgen */
+
+#endif /* SIMPLIFIER_H_ */
@@ -52,61 +52,167 @@ namespace pgen
 	{
 	}
 
+	const string& Text::getText()
+	{
+		return text;
+	}
+
+	/**
+	 * The input is compared byte by byte, without knowing its length. Comparing every byte until the first 
+	 * difference (with a short-circuit expression or strncmp) guarantees that no byte after the end of the text
+	 * (the null character) is ever read. That is why memcmp and word-sized loads are not used.
+	 * inlined code:
+	 *  if (%mismatch(bytes)%) return -1;
+	 *  pos += %n%;
+	 */
+	string Text::compare(const string& bytes)
+	{
+		stringstream s;
+		if (bytes.length() == 0)
+		{
+			return s.str();
+		}
+		s << " if (" << mismatch(bytes) << ") return -1;"								"\n"
+			 " pos += " << bytes.length() << ";"										"\n";
+		return s.str();
+	}
+
+	/**
+	 * expression (up to MAX_UNROLLED bytes):
+	 *  (unsigned char)text[pos] != %bytes[0]% || ... || (unsigned char)text[pos+%n-1%] != %bytes[n-1]%
+	 * expression (longer texts):
+	 *  strncmp(text + pos, "%Util::cstr(bytes)%", %n%) != 0
+	 */
+	string Text::mismatch(const string& bytes)
+	{
+		stringstream s;
+		if (bytes.length() <= MAX_UNROLLED)
+		{
+			for (unsigned int i = 0; i < bytes.length(); i++)
+			{
+				if (i > 0) s << " || ";
+				s << "(unsigned char)text[pos";
+				if (i > 0) s << "+" << i;
+				s << "] != " << (unsigned int)(unsigned char)bytes[i];
+			}
+		}
+		else
+		{
+			s << "strncmp(text + pos, \"" << Util::cstr(bytes) << "\", " << bytes.length() << ") != 0";
+		}
+		return s.str();
+	}
+
 	/**
-	 * We use the text.length property instead of Util::strlen_utf8 because the "pos" variable
-	 * holds the position in number of bytes, not in utf8 characters.
 	 * compiled code (chained version):
 	 * %cprototype()% {
-	 * 	int pos = 0, posStr = 0;
-	 * 	char *str = "%Util::cstr(text)%";
-	 * 	do {
-	 * 		if (next_utf8(text, &pos) != next_utf8(str, &posStr)) return -1;
-	 * 	} while (pos < %text.length%);
-	 * 	int res = chain_next(text + pos, chain);
-	 * 	if (res == -1) return -1;
-	 * 	return res + pos;
+	 *  int pos = 0, p;
+	 *  %icompile()%
+	 *  p = chain_next(text + pos, chain);
+	 *  if (p == -1) return -1;
+	 *  return pos + p;
 	 * }
 	 */
 	string Text::ccompile() 
 	{
 		stringstream s;
 		s << cprototype() << " {"													"\n"
-			 " int pos = 0, posStr = 0;"											"\n"
-			 " char *str = \"" << Util::cstr(text) << "\";"							"\n"
-			 " do {"																"\n"
-			 "  if (next_utf8(text, &pos) != next_utf8(str, &posStr)) return -1;"	"\n"
-			 " } while (pos < " << text.length() << ");"							"\n"
-			 " int res = chain_next(text + pos, chain);"							"\n"
-			 " if (res == -1) return -1;"											"\n"
-			 " return res + pos;"													"\n"
+			 " int pos = 0, p;"														"\n"
+		  << this->icompile() <<
+			 " p = chain_next(text + pos, chain);"									"\n"
+			 " if (p == -1) return -1;"												"\n"
+			 " return pos + p;"														"\n"
 			 "}"																	"\n\n";
 		return s.str();
 	}
 
 	/**
-	 * We use the text.length property instead of Util::strlen_utf8 because the "pos" variable
-	 * holds the position in number of bytes, not in utf8 characters.
 	 * compiled code: (non-chained version)
 	 * %prototype()% {
-	 * 	int pos = 0, posStr = 0;
-	 * 	char* str = "%Util::cstr(text)%";
-	 * 	do {
-	 * 		if (next_utf8(text, &pos) != next_utf8(str, &posStr)) return -1;
-	 * 	} while (pos < %text.length%);
-	 * 	return pos;
+	 *  int pos = 0;
+	 *  %icompile()%
+	 *  return pos;
 	 * }
 	 */
 	string Text::compile() 
 	{
 		stringstream s;
 		s << this->prototype() << " {"												"\n"
-			 " int pos = 0, posStr = 0;"											"\n"
-			 " char* str = \"" << Util::cstr(text) << "\";"							"\n"
-			 " do {"																"\n"
-			 "  if (next_utf8(text, &pos) != next_utf8(str, &posStr)) return -1;"	"\n"
-			 " } while (pos < " << text.length() << ");"							"\n"
+			 " int pos = 0;"														"\n"
+		  << this->icompile() <<
 			 " return pos;"															"\n"
-			 "}"																	"\n";
+			 "}"																	"\n\n";
+		return s.str();
+	}
+
+	bool Text::deterministic()
+	{
+		return true;
+	}
+
+	/**
+	 * Literal texts are compared byte by byte (see Text::compare). The texts that contain the invalid character
+	 * replacement (0xFFFD) must be decoded, because next_utf8 also returns it for invalid utf-8 sequences.
+	 * We use the text.length property instead of Util::strlen_utf8 because the "posStr" variable
+	 * holds the position in number of bytes, not in utf8 characters.
+	 * inlined code (literal texts):
+	 *  %compare(text)%
+	 * inlined code (other texts):
+	 *  {
+	 *   int posStr = 0;
+	 *   char* str = "%Util::cstr(text)%";
+	 *   do {
+	 *    if (next_utf8(text, &pos) != next_utf8(str, &posStr)) return -1;
+	 *   } while (posStr < %text.length%);
+	 *  }
+	 */
+	string Text::icompile()
+	{
+		string bytes;
+		if (this->literal(bytes))
+		{
+			return Text::compare(bytes);
+		}
+		stringstream s;
+		s << " {"																	"\n"
+			 "  int posStr = 0;"													"\n"
+			 "  char* str = \"" << Util::cstr(text) << "\";"						"\n"
+			 "  do {"																"\n"
+			 "   if (next_utf8(text, &pos) != next_utf8(str, &posStr)) return -1;"	"\n"
+			 "  } while (posStr < " << text.length() << ");"						"\n"
+			 " }"																	"\n";
+		return s.str();
+	}
+
+	bool Text::literal(string& bytes)
+	{
+		if (text.find('\0') != string::npos || text.find("\xEF\xBF\xBD") != string::npos)
+		{
+			return false;
+		}
+		bytes += text;
+		return true;
+	}
+
+	void Text::first(IntervalSet& set)
+	{
+		if (!text.empty())
+		{
+			unsigned int pos = 0;
+			unsigned int c = Util::next_utf8(text, pos);
+			set.add(c, c);
+		}
+	}
+
+	string Text::str()
+	{
+		stringstream s;
+		unsigned int len = Util::strlen_utf8(text);
+		unsigned int i = 0;
+		while (i < len) 
+		{
+			s << Util::int2regex(Util::next_utf8(text, i));
+		}
 		return s.str();
 	}
 
@@ -48,9 +48,34 @@ namespace pgen
 	private:
 		string text;
 	public:
+		/**
+		 * Maximum number of bytes compared one by one on the compiled code, longer texts are compared with strncmp.
+		 */
+		static const unsigned int MAX_UNROLLED = 8;
+
 		Text(string text);
 		virtual ~Text();
 
+		/**
+		 * \return the (utf-8) text that will be matched by this object.
+		 */
+		const string& getText();
+
+		/**
+		 * Returns C statements that compare the text at "text + pos" with a sequence of bytes, advancing "pos" past
+		 * the bytes on success and executing "return -1;" on failure (see ICompilable::icompile()).
+		 * \param bytes the bytes to compare with (must not contain null characters).
+		 * \return the C statements that compare the bytes.
+		 */
+		static string compare(const string& bytes);
+		/**
+		 * Returns a C expression that is true when the text at "text + pos" does not start with a sequence of bytes
+		 * (see Text::compare()).
+		 * \param bytes the bytes to compare with (must not be empty nor contain null characters).
+		 * \return the C expression that compares the bytes.
+		 */
+		static string mismatch(const string& bytes);
+
 		// ICompilable Methods Implementation
 		/**
 		 * Returns C code that can parse the regular expression.
@@ -73,6 +98,28 @@ namespace pgen
 		 * \return the compiled C code that parses the expression.
 		 */
 		virtual string compile();
+		/**
+		 * \returns true, a text can only be matched in a single way.
+		 */
+		virtual bool deterministic();
+		/**
+		 * Returns C statements that match the text inline (see ICompilable::icompile()).
+		 * \return the inlined C statements that match the text.
+		 */
+		virtual string icompile();
+		/**
+		 * Appends the text to "bytes" (see ICompilable::literal()).
+		 * \returns true unless the text contains null characters or the invalid character replacement (0xFFFD).
+		 */
+		virtual bool literal(string& bytes);
+		/**
+		 * Adds the first character of the text to the set (see ICompilable::first()).
+		 */
+		virtual void first(IntervalSet& set);
+		/**
+		 * \returns the text, with its meta-characters escaped.
+		 */
+		virtual string str();
 		/**
 		 * Returns the name of the expression. The returned name must be usable as a function
 		 * name in the standard C (C99). i.e. it has to match the following format:
@@ -0,0 +1,125 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA. 
+ * 
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ * 
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-02
+ * \file
+ * The Trie class compiles a set of literal texts into nested switch statements that read each byte of the input at 
+ * most once.
+ */
+
+// STL
+#include <string>
+#include <sstream>
+#include <climits>
+// pgen
+#include "Trie.h"
+
+using namespace std;
+namespace pgen 
+{
+
+	Trie::Trie() 
+	 : nodes(1, Node{-1, INT_MAX, {}})
+	{
+	}
+
+	void Trie::add(const string& bytes, int item)
+	{
+		unsigned int node = 0;
+		if (item < nodes[node].minItem) nodes[node].minItem = item;
+		for (char c: bytes)
+		{
+			auto next = nodes[node].next.find((unsigned char)c);
+			if (next == nodes[node].next.end()) 
+			{
+				nodes.push_back(Node{-1, INT_MAX, {}});
+				nodes[node].next[(unsigned char)c] = nodes.size()-1;
+				node = nodes.size()-1;
+			}
+			else
+			{
+				node = next->second;
+			}
+			if (item < nodes[node].minItem) nodes[node].minItem = item;
+		}
+		if (nodes[node].item == -1 || item < nodes[node].item)
+		{
+			nodes[node].item = item;
+		}
+	}
+
+	/**
+	 * compiled code:
+	 * %if (node has no children worth reading)%
+	 *  %stop(matches)%
+	 * %else%
+	 *  switch ((unsigned char)text[%depth%]) {
+	 *  %for (each child)%
+	 *   case %byte%:
+	 *    %compile(child)%
+	 *  %end for%
+	 *   default:
+	 *    %stop(matches)%
+	 *  }
+	 * %end if%
+	 */
+	void Trie::compile(stringstream& s, unsigned int node, unsigned int depth, string tabs, bool all, 
+		vector<Match> matches, StopCode& stop)
+	{
+		if (nodes[node].item != -1)
+		{
+			vector<Match>::iterator it = matches.begin();
+			while (it != matches.end() && it->item < nodes[node].item) it++;
+			matches.insert(it, Match{nodes[node].item, depth});
+		}
+		int best = (matches.empty() ? INT_MAX : matches.front().item);
+		vector<pair<unsigned char, unsigned int>> next;
+		for (auto& n: nodes[node].next)
+		{
+			if (all || nodes[n.second].minItem < best)
+			{
+				next.push_back(n);
+			}
+		}
+		if (next.empty())
+		{
+			stop(s, tabs, matches);
+			return;
+		}
+		s << tabs << "switch ((unsigned char)text[" << depth << "]) {"			"\n";
+		for (auto& n: next)
+		{
+			s << tabs << " case " << (unsigned int)n.first << ":"				"\n";
+			compile(s, n.second, depth+1, tabs + "  ", all, matches, stop);
+		}
+		s << tabs << " default:"												"\n";
+		stop(s, tabs + "  ", matches);
+		s << tabs << "}"														"\n";
+	}
+
+	string Trie::compile(bool all, StopCode stop, const string& tabs)
+	{
+		stringstream s;
+		compile(s, 0, 0, tabs, all, vector<Match>(), stop);
+		return s.str();
+	}
+
+} /* namespace pgen */
@@ -0,0 +1,112 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA. 
+ * 
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ * 
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-02
+ * \file
+ * The Trie class compiles a set of literal texts into nested switch statements that read each byte of the input at 
+ * most once. For instance, the texts "if", "in" and "int" are compiled as follows:
+ *  switch ((unsigned char)text[0]) {
+ *   case 105:
+ *    switch ((unsigned char)text[1]) {
+ *     case 102:
+ *      %stop code for "if"%
+ *     case 110:
+ *      switch ((unsigned char)text[2]) {
+ *       case 116:
+ *        %stop code for "in" and "int"%
+ *       default:
+ *        %stop code for "in"%
+ *      }
+ *     default:
+ *      %stop code for no matches%
+ *    }
+ *   default:
+ *    %stop code for no matches%
+ *  }
+ */
+
+#ifndef TRIE_H_
+#define TRIE_H_
+
+// STL
+#include <string>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <functional>
+
+using namespace std;
+namespace pgen 
+{
+	class Trie 
+	{
+	public:
+		/**
+		 * A text of the trie that matches the input.
+		 */
+		struct Match 
+		{
+			int item;						//< Item of the text (see Trie::add()).
+			unsigned int length;			//< Length of the text, in bytes.
+		};
+		/**
+		 * Function that writes the code executed when the trie stops reading the input. The code receives the texts
+		 * that match the beggining of the input, sorted by item, and it must always return.
+		 */
+		typedef function<void(stringstream& s, const string& tabs, const vector<Match>& matches)> StopCode;
+	private:
+		struct Node 
+		{
+			int item;								//< Item of the text that ends on this node or -1.
+			int minItem;							//< Lowest item of the texts that end on this node or below.
+			map<unsigned char, unsigned int> next;	//< Indexes of the child nodes, by byte.
+		};
+		vector<Node> nodes;							//< Nodes of the trie, the first one is the root.
+
+		void compile(stringstream& s, unsigned int node, unsigned int depth, string tabs, bool all, 
+			vector<Match> matches, StopCode& stop);
+	public:
+		Trie();
+
+		/**
+		 * Adds a text to the trie.
+		 * \param bytes the bytes of the text, it must not contain null characters.
+		 * \param item identifier of the text. When more than one text match the input, the lowest item has the 
+		 * highest priority. If the same text is added twice, the lowest item is kept.
+		 */
+		void add(const string& bytes, int item);
+
+		/**
+		 * Returns C code that reads the input from the char* variable "text" and executes the stop code once no 
+		 * other text can be matched. The input is read byte by byte, so it never reads past the end of the text (the 
+		 * null character).
+		 * \param all when false, the trie stops as soon as no other text with higher priority than the longest one 
+		 * that was already matched can be matched. When true, all the texts that match the input are given to the 
+		 * stop code.
+		 * \param stop function that writes the code to execute once the trie stops.
+		 * \param tabs the indentation of the code.
+		 * \return the C code of the trie.
+		 */
+		string compile(bool all, StopCode stop, const string& tabs = " ");
+	}; /* class Trie */
+} /* namespace pgen */
+
+#endif /* TRIE_H_ */
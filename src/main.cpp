@@ -27,6 +27,9 @@
 // STL
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
 // yaml-cpp
 #include <yaml-cpp/yaml.h>
 // pgen
@@ -55,16 +58,69 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 	
-	ofstream output(*options.outputFileName + ".c");
-	output << "#include \"" << *options.outputFileName << ".h\"\n\n";
-	language.compileComments(output);
-	language.compileGetSymbolName(output);
-	output << pgen::Code::getHelper() << endl << endl;
-	language.compile(output);
-	output.close();
-	output.open(*options.outputFileName + ".h");
-	language.compileHeader(output);
-	output.close();
+	// The grammar is analyzed when it is compiled, so the grammars a parser does not support are reported here.
+	try
+	{
+		string fileName = *options.outputFileName;
+		ofstream output;
+		if (options.splitUnits > 0)
+		{
+			// The runtime helpers, the tokenizer and groups of grammar rules are written to separate translation units 
+			// that share an internal header, so that they can be compiled in parallel. The code is generated first, 
+			// since it selects the helpers that are written.
+			string include = "#include \"" + fileName + "_internal.h\"\n\n";
+			stringstream helpers, lexer;
+			vector<string> units;
+			language.compileParseHelpers(helpers);
+			language.compileLexer(lexer);
+			language.compileParser(units, options.splitUnits);
+			string code = helpers.str() + lexer.str();
+			for (const string& unit: units)
+			{
+				code += unit;
+			}
+			output.open(fileName + "_internal.h");
+			language.compileInternalHeader(output, fileName + ".h", code);
+			output.close();
+			output.open(fileName + ".c");
+			output << include;
+			language.compileComments(output);
+			language.compileGetSymbolName(output);
+			output << helpers.str();
+			output.close();
+			output.open(fileName + "_runtime.c");
+			output << include << pgen::Code::getRuntime(code);
+			output.close();
+			output.open(fileName + "_lexer.c");
+			output << include << lexer.str();
+			output.close();
+			for (unsigned int i = 0; i < units.size(); i++)
+			{
+				output.open(fileName + "_parser" + to_string(i) + ".c");
+				output << include << units[i];
+				output.close();
+			}
+		}
+		else
+		{
+			output.open(fileName + ".c");
+			output << "#include \"" << fileName << ".h\"\n\n";
+			language.compileComments(output);
+			language.compileGetSymbolName(output);
+			stringstream code;
+			language.compile(code);
+			output << pgen::Code::getHelper(code.str()) << endl << endl << code.str();
+			output.close();
+		}
+		output.open(fileName + ".h");
+		language.compileHeader(output);
+		output.close();
+	}
+	catch (const pgen::LanguageException& ex)
+	{
+		cout << "LanguageException: " << ex.what() << endl;
+		return 1;
+	}
 	
 	return 0;
 }
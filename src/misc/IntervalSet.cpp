@@ -0,0 +1,197 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA. 
+ * 
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ * 
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-09
+ * \file
+ * The IntervalSet class represents a set of unsigned integers as a sorted list of disjoint intervals.
+ */
+
+// STL
+#include <map>
+#include <vector>
+#include <algorithm>
+// pgen
+#include "IntervalSet.h"
+
+using namespace std;
+namespace pgen 
+{
+
+	void IntervalSet::add(unsigned int first, unsigned int last)
+	{
+		if (last < first) 
+		{
+			swap(first, last);
+		}
+		// the intervals are kept disjoint and non-adjacent, so only the interval that starts before "first" and the 
+		// ones that start inside [first, last+1] can be merged with the new interval.
+		map<unsigned int, unsigned int>::iterator it = intervals.upper_bound(first);
+		if (it != intervals.begin()) 
+		{
+			map<unsigned int, unsigned int>::iterator prev = it;
+			--prev;
+			if ((unsigned long long)prev->second + 1 >= first) 
+			{
+				it = prev;
+			}
+		}
+		while (it != intervals.end() && it->first <= (unsigned long long)last + 1)
+		{
+			first = min(first, it->first);
+			last = max(last, it->second);
+			it = intervals.erase(it);
+		}
+		intervals.insert(it, make_pair(first, last));
+	}
+
+	void IntervalSet::add(const IntervalSet& set)
+	{
+		if (set.size() < 8 || set.size() * 8 < this->size())
+		{
+			// small sets are added interval by interval (O(m log n))
+			for (auto& i: set.intervals)
+			{
+				add(i.first, i.second);
+			}
+			return;
+		}
+		// large sets are merged in a single pass (O(n + m))
+		vector<pair<unsigned int, unsigned int>> merged;
+		const_iterator a = intervals.begin(), b = set.intervals.begin();
+		while (a != intervals.end() || b != set.intervals.end())
+		{
+			pair<unsigned int, unsigned int> next;
+			if (b == set.intervals.end() || (a != intervals.end() && a->first < b->first)) 
+			{
+				next = *a++;
+			}
+			else 
+			{
+				next = *b++;
+			}
+			if (!merged.empty() && (unsigned long long)merged.back().second + 1 >= next.first) 
+			{
+				merged.back().second = max(merged.back().second, next.second);
+			}
+			else 
+			{
+				merged.push_back(next);
+			}
+		}
+		intervals.clear();
+		for (auto& i: merged)
+		{
+			intervals.insert(intervals.end(), i);
+		}
+	}
+
+	void IntervalSet::intersect(const IntervalSet& set)
+	{
+		map<unsigned int, unsigned int> result;
+		const_iterator a = intervals.begin(), b = set.intervals.begin();
+		while (a != intervals.end() && b != set.intervals.end())
+		{
+			unsigned int first = max(a->first, b->first), last = min(a->second, b->second);
+			if (first <= last) 
+			{
+				result.insert(result.end(), make_pair(first, last));
+			}
+			// advance the interval that ends first
+			if (a->second < b->second) 
+			{
+				++a;
+			}
+			else 
+			{
+				++b;
+			}
+		}
+		intervals.swap(result);
+	}
+
+	void IntervalSet::invert(unsigned int first, unsigned int last)
+	{
+		map<unsigned int, unsigned int> result;
+		unsigned long long next = first;		// first value of the universe that was not checked yet.
+		for (auto& i: intervals)
+		{
+			if (i.second < first) continue;
+			if (i.first > last) break;
+			if (i.first > next) 
+			{
+				result.insert(result.end(), make_pair((unsigned int)next, i.first - 1));
+			}
+			next = (unsigned long long)i.second + 1;
+		}
+		if (next <= last) 
+		{
+			result.insert(result.end(), make_pair((unsigned int)next, last));
+		}
+		intervals.swap(result);
+	}
+
+	bool IntervalSet::contains(unsigned int value) const
+	{
+		const_iterator it = intervals.upper_bound(value);
+		if (it == intervals.begin()) 
+		{
+			return false;
+		}
+		--it;
+		return (value <= it->second);
+	}
+
+	void IntervalSet::clear()
+	{
+		intervals.clear();
+	}
+
+	bool IntervalSet::empty() const
+	{
+		return intervals.empty();
+	}
+
+	unsigned int IntervalSet::size() const
+	{
+		return intervals.size();
+	}
+
+	IntervalSet::const_iterator IntervalSet::begin() const
+	{
+		return intervals.begin();
+	}
+
+	IntervalSet::const_iterator IntervalSet::end() const
+	{
+		return intervals.end();
+	}
+
+	bool IntervalSet::operator==(const IntervalSet& set) const
+	{
+		return (intervals == set.intervals);
+	}
+
+	bool IntervalSet::operator!=(const IntervalSet& set) const
+	{
+		return (intervals != set.intervals);
+	}
+
+} /* namespace pgen */
@@ -0,0 +1,108 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA. 
+ * 
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ * 
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-09
+ * \file
+ * The IntervalSet class represents a set of unsigned integers as a sorted list of disjoint intervals. It is used by
+ * the CharClass to store the characters of a class. The intervals are kept on a balanced tree indexed by their first
+ * value, so adding an interval takes O(log n) time (plus the time to merge the intervals it overlaps). The union,
+ * intersection and inversion of whole sets are done in a single pass over the sorted intervals.
+ */
+
+#ifndef INTERVALSET_H_
+#define INTERVALSET_H_
+
+// STL
+#include <map>
+
+using namespace std;
+namespace pgen 
+{
+	class IntervalSet 
+	{
+	private:
+		map<unsigned int, unsigned int> intervals;	//< Intervals indexed by their first value (first -> last).
+	public:
+		typedef map<unsigned int, unsigned int>::const_iterator const_iterator;
+
+		/**
+		 * Adds an interval to the set. Intervals that overlap or touch the new one are merged with it.
+		 * \param first the first value of the interval (inclusive).
+		 * \param last the last value of the interval (inclusive).
+		 * \remark if last < first, the bounds are swapped.
+		 */
+		void add(unsigned int first, unsigned int last);
+		/**
+		 * Adds all the intervals of another set to this set (union).
+		 * \param set the set to add.
+		 */
+		void add(const IntervalSet& set);
+		/**
+		 * Removes all the values that do not belong to another set (intersection).
+		 * \param set the set to intersect with.
+		 */
+		void intersect(const IntervalSet& set);
+		/**
+		 * Inverts the set inside the interval [first, last], i.e. after the inversion the set contains every value
+		 * of the interval that it did not contain before. Values outside of the interval are removed.
+		 * \param first the first value of the universe (inclusive).
+		 * \param last the last value of the universe (inclusive).
+		 */
+		void invert(unsigned int first, unsigned int last);
+		/**
+		 * Checks if a value belongs to the set.
+		 * \param value the value to look for.
+		 * \return true if the value belongs to one of the intervals.
+		 */
+		bool contains(unsigned int value) const;
+		/**
+		 * Removes all the intervals.
+		 */
+		void clear();
+		/**
+		 * \return true if the set has no intervals.
+		 */
+		bool empty() const;
+		/**
+		 * \return the number of (disjoint) intervals of the set.
+		 */
+		unsigned int size() const;
+		/**
+		 * \return an iterator to the first interval, sorted by their values. The key of the iterator is the first 
+		 * value of the interval and the mapped value is the last one.
+		 */
+		const_iterator begin() const;
+		/**
+		 * \return an iterator to the end of the intervals.
+		 */
+		const_iterator end() const;
+		/**
+		 * Check if two sets are equal, i.e. if they have the same intervals.
+		 */
+		bool operator==(const IntervalSet& set) const;
+		/**
+		 * Check if two sets are different. See the == operator for more information.
+		 */
+		bool operator!=(const IntervalSet& set) const;
+	}; /* class IntervalSet */
+} /* namespace pgen */
+
+#endif /* INTERVALSET_H_ */
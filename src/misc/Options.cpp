@@ -27,6 +27,7 @@
  
 // STL
 #include <unistd.h>
+#include <cstdlib>
 #include <string>
 #include <iostream>
 // pgen
@@ -43,6 +44,7 @@ namespace pgen
 		{"output",  required_argument,	0,	'o'},
 		{"defs",	required_argument,	0,	'd'},
 		{"symbol-name", no_argument,	0,	'n'},
+		{"split",	required_argument,	0,	's'},
 		{0,			0,					0,	0}
 	};
 	
@@ -51,11 +53,12 @@ namespace pgen
 	 , outputFileName(nullptr)
 	 , definitionFileName(nullptr)
 	 , writeGetSymbolNameMethod(false)
+	 , splitUnits(0)
 	 , valid(true)
 	{
 		int c;
 		int opt_index;
-		while ((c = getopt_long(argc, argv, "i:ho:d:n", long_options, &opt_index)) != -1) 
+		while ((c = getopt_long(argc, argv, "i:ho:d:ns:", long_options, &opt_index)) != -1) 
 		{
 			switch (c) 
 			{
@@ -85,6 +88,15 @@ namespace pgen
 			case 'n': // write the function "getSymbolName" that returns a string for each name.
 				this->writeGetSymbolNameMethod = true;
 				break;				
+			case 's': // split the generated code into multiple translation units.
+				if (atoi(optarg) <= 0)
+				{
+					cout << "The --split option requires a positive number of translation units." << endl;
+					this->printHelp();
+					return;
+				}
+				this->splitUnits = atoi(optarg);
+				break;
 			case '?': // something is wrong
 				if (optopt == 'i') 
 				{
@@ -122,6 +134,9 @@ namespace pgen
 		"  -o, --output=PREFIX     write the generated code PREFIX.c and PREFIX.h.\n"
 		"  -d, --defs=FILENAME	   write the definitions to this file.\n"
 		"  -n, --symbol-name       write the getSymbolName method.\n"
+		"  -s, --split=N           split the generated code into PREFIX.c, PREFIX_runtime.c,\n"
+		"                          PREFIX_lexer.c and N files PREFIX_parser<i>.c with the\n"
+		"                          grammar rules, sharing the PREFIX_internal.h header.\n"
 		"      --version           display the program's version information.\n\n";		
 		this->valid = false;
 	}
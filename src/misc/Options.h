@@ -42,6 +42,7 @@ namespace pgen
 		std::string* outputFileName;
 		std::string* definitionFileName;
 		bool writeGetSymbolNameMethod;
+		unsigned int splitUnits;		//< number of translation units for the grammar rules (0 = single file).
 		bool valid;
 		Options(int argc, char* argv[]);
 		virtual ~Options();
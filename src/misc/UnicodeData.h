@@ -0,0 +1,71 @@
+/**
+ * pgen, Parser Generator.
+ * Copyright (C) 2015 Dimas Melo Filho
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA. 
+ * 
+ * The author can be reached by e-mail: dldmf@cin.ufpe.br.
+ * 
+ * \author Dimas Melo Filho <dldmf@cin.ufpe.br>
+ * \date 2015-05-16
+ * \file
+ * The UnicodeData class gives access to the Unicode Character Database (UCD) tables embedded in pgen. They are used 
+ * by the Unicode property escapes (\p{...} and \P{...}) and by the named classes (e.g. [:Greek:]).
+ * The following properties are supported:
+ *  - General categories, by their short or long names (e.g. Lu or Uppercase_Letter), including the major categories
+ *    (L, M, N, P, S, Z, C and their long names) and LC (Cased_Letter);
+ *  - Scripts, by their short or long names (e.g. Grek or Greek);
+ *  - Any (all code points), Assigned (all assigned code points) and ASCII.
+ * The property may also be given explicitly: gc=Lu, General_Category=Lu, sc=Greek or Script=Greek. The names are 
+ * matched loosely, i.e. case, spaces, hyphens and underscores are ignored (e.g. "old italic" is Old_Italic).
+ */
+
+#ifndef UNICODEDATA_H_
+#define UNICODEDATA_H_
+
+// STL
+#include <string>
+// pgen
+#include "IntervalSet.h"
+
+using namespace std;
+namespace pgen 
+{
+	class UnicodeData 
+	{
+	public:
+		/**
+		 * Version of the Unicode Character Database of the embedded tables.
+		 */
+		static const char* const VERSION;
+
+		/**
+		 * Adds the code points that have a Unicode property to an IntervalSet.
+		 * \param name the name of the property (see UnicodeData.h).
+		 * \param set the set to add the code points to.
+		 * \return false if the property is unknown, in which case the set is not changed.
+		 */
+		static bool get(const string& name, IntervalSet& set);
+
+		/**
+		 * Adds the case variants of the code points of an IntervalSet to it, according to the simple case folding of
+		 * the Unicode database (e.g. 'k' adds 'K' and the Kelvin sign U+212A).
+		 * \param set the set to add the case variants to.
+		 */
+		static void fold(IntervalSet& set);
+	}; /* class UnicodeData */
+} /* namespace pgen */
+
+#endif /* UNICODEDATA_H_ */
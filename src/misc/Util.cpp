@@ -8,6 +8,7 @@
 // STL
 #include <string>
 #include <sstream>
+#include <iomanip>
 // pgen
 #include "Util.h"
 #include "InvalidCharacter.h"
@@ -159,6 +160,9 @@ namespace pgen
 		case 0x27:
 			s << "\\'";
 			break;
+		case 0x3F:
+			s << "\\?";
+			break;
 		case 0x5C:
 			s << "\\\\";
 			break;
@@ -167,15 +171,16 @@ namespace pgen
 			{
 				s << (char)(i);
 			} 
+			else if (i <= 0xFF)
+			{
+				// octal escapes have at most 3 digits, so they never absorb the characters that follow them.
+				s << '\\' << (char)('0' + ((i >> 6) & 0x3)) << (char)('0' + ((i >> 3) & 0x7)) << (char)('0' + (i & 0x7));
+			}
 			else 
 			{
-				while (i > 0) 
+				for (char byte: Util::int2utf8(i))
 				{
-					unsigned char d1 = i & 0xF; i >>= 4;
-					unsigned char d2 = i & 0xF; i >>= 4;
-					s << "\\x";
-					s << (char)((d2 < 0xA ? '0' : 'A') + d2);
-					s << (char)((d1 < 0xA ? '0' : 'A') + d1);
+					s << Util::int2cstr((unsigned char)byte);
 				}
 			}
 			break;
@@ -183,12 +188,61 @@ namespace pgen
 		return s.str();
 	}
 
+	string Util::int2regex(unsigned int i)
+	{
+		stringstream s;
+		if (i >= 0x20 && i <= 0x7E)
+		{
+			if (string("\\^$.|?*+()[]{}-/").find((char)i) != string::npos)
+			{
+				s << '\\';
+			}
+			s << (char)i;
+		}
+		else
+		{
+			s << uppercase << hex << setfill('0');
+			if (i <= 0xFF) s << "\\x" << setw(2) << i;
+			else if (i <= 0xFFFF) s << "\\u" << setw(4) << i;
+			else s << "\\U" << setw(8) << i;
+		}
+		return s.str();
+	}
+
+	string Util::int2utf8(unsigned int c)
+	{
+		string s;
+		if (c < 0x80)						// 1-byte character.
+		{
+			s += (char)c;
+		}
+		else if (c < 0x800)					// 2-bytes character.
+		{
+			s += (char)(0xC0 | (c >> 6));
+			s += (char)(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)				// 3-bytes character.
+		{
+			s += (char)(0xE0 | (c >> 12));
+			s += (char)(0x80 | ((c >> 6) & 0x3F));
+			s += (char)(0x80 | (c & 0x3F));
+		}
+		else								// 4-bytes character.
+		{
+			s += (char)(0xF0 | ((c >> 18) & 0x07));
+			s += (char)(0x80 | ((c >> 12) & 0x3F));
+			s += (char)(0x80 | ((c >> 6) & 0x3F));
+			s += (char)(0x80 | (c & 0x3F));
+		}
+		return s;
+	}
+
 	string Util::cstr(string str) 
 	{
 		stringstream s;
 		for (char c: str) 
 		{
-			s << Util::int2cstr((unsigned int) c);
+			s << Util::int2cstr((unsigned char) c);
 		}
 		return s.str();
 	}
@@ -70,17 +70,33 @@ namespace pgen
 		static unsigned int oct2int(unsigned int c);
 
 		/**
-		 * Converts an integer to a valid C string character. If the integer represents one of
-		 * [0-9A-Za-z_] it returns the character itself. If it represents other characters, it returns
-		 * hex representations "\x##" of the characters.
+		 * Converts an integer to a valid C string character. If the integer represents a printable
+		 * ASCII character it returns the character itself (escaped when needed). If it represents other
+		 * characters, it returns the octal representations "\###" of the bytes of the utf-8 character.
 		 * \param i the integer to convert to a C string.
 		 * \return an STL string containing the corresponding characters.
 		 */
 		static string int2cstr(unsigned int i);
 
+		/**
+		 * Converts an integer to its representation on a regular expression. Printable ASCII characters are returned
+		 * as is (escaped when they are meta-characters), other characters are returned as \xXX, \uXXXX or \UXXXXXXXX
+		 * escapes.
+		 * \param i the integer (character) to convert.
+		 * \return an STL string containing the regular expression that matches the character.
+		 */
+		static string int2regex(unsigned int i);
+
+		/**
+		 * Encodes an unicode character as an utf-8 sequence of bytes.
+		 * \param c the unicode character to encode.
+		 * \return an STL string containing the 1 to 4 bytes of the utf-8 representation of the character.
+		 */
+		static string int2utf8(unsigned int c);
+
 		/**
 		 * Returns a valid C representation of the string to be used between double quotes.
-		 * Like "myString\x08\n".
+		 * Like "myString\010\n". The string is converted byte by byte.
 		 * \param str the string to be converted.
 		 * \return a string containing a valid C representation of the string.
 		 */
@@ -9,6 +9,7 @@
 // STL
 #include <sstream>
 // pgen
+#include "../misc/LanguageException.h"
 #include "IGrammar.h"
 
 using namespace std;
@@ -31,4 +32,277 @@ namespace pgen
 		}
 	}
 	
+	void IGrammar::compile(vector<string>& units, unsigned int count)
+	{
+		units.push_back(this->compile());
+	}
+	
+	string IGrammar::declarations()
+	{
+		return "";
+	}
+
+	void IGrammar::eliminateLeftRecursion()
+	{
+		for (unsigned int i = rules.size(); i-- > 0; )
+		{
+			vector<vector<int>*>& alternatives = rules[i]->symbols;
+			// replaces the rules that lead back to this rule by their alternatives
+			bool changed = true;
+			while (changed)
+			{
+				changed = false;
+				for (unsigned int j = i + 1; j < rules.size() && !changed; j++)
+				{
+					vector<vector<int>*> rewritten;
+					for (vector<int>* option: alternatives)
+					{
+						if (option->empty() || option->front() != (int)j + 1000000000 || !leads(j, i))
+						{
+							rewritten.push_back(option);
+							continue;
+						}
+						if (!rules[j]->loops.empty())
+						{
+							throw LanguageException("The rule '" + rules[i]->name + "' is left-recursive through the "
+								"rule '" + rules[j]->name + "', which is also left-recursive.");
+						}
+						// the node of the rule j keeps the inlined symbols, inside the nodes it was already in
+						auto nodes = rules[i]->inlined.find(option);
+						for (vector<int>* inlined: rules[j]->symbols)
+						{
+							vector<int>* replacement = new vector<int>(*inlined);
+							replacement->insert(replacement->end(), option->begin() + 1, option->end());
+							rewritten.push_back(replacement);
+							vector<pair<int, unsigned int>>& wrapped = rules[i]->inlined[replacement];
+							auto inner = rules[j]->inlined.find(inlined);
+							if (inner != rules[j]->inlined.end())
+							{
+								wrapped = inner->second;
+							}
+							wrapped.push_back(make_pair(j + 1000000000, inlined->size()));
+							if (nodes != rules[i]->inlined.end())
+							{
+								for (auto& node: nodes->second)
+								{
+									wrapped.push_back(make_pair(node.first, node.second + inlined->size() - 1));
+								}
+							}
+						}
+						if (nodes != rules[i]->inlined.end())
+						{
+							rules[i]->inlined.erase(nodes);
+						}
+						delete option;
+						changed = true;
+					}
+					alternatives.swap(rewritten);
+				}
+			}
+			// moves the alternatives that start with this rule to the loops
+			vector<vector<int>*> remaining;
+			for (vector<int>* option: alternatives)
+			{
+				if (option->empty() || option->front() != (int)i + 1000000000)
+				{
+					remaining.push_back(option);
+					continue;
+				}
+				auto nodes = rules[i]->inlined.find(option);
+				if (option->size() > 1)
+				{
+					rules[i]->loops.push_back(new vector<int>(option->begin() + 1, option->end()));
+					if (nodes != rules[i]->inlined.end())
+					{
+						rules[i]->inlined[rules[i]->loops.back()] = nodes->second;
+					}
+				}
+				if (nodes != rules[i]->inlined.end())
+				{
+					rules[i]->inlined.erase(nodes);
+				}
+				delete option;
+			}
+			alternatives.swap(remaining);
+		}
+	}
+
+	bool IGrammar::leads(int from, int to)
+	{
+		vector<bool> visited(rules.size(), false);
+		vector<int> pending(1, from);
+		while (!pending.empty())
+		{
+			int rule = pending.back();
+			pending.pop_back();
+			for (vector<int>* option: rules[rule]->symbols)
+			{
+				if (option->empty() || option->front() < 1000000000)
+				{
+					continue;
+				}
+				int next = option->front() - 1000000000;
+				if (next == to)
+				{
+					return true;
+				}
+				if (!visited[next])
+				{
+					visited[next] = true;
+					pending.push_back(next);
+				}
+			}
+		}
+		return false;
+	}
+
+	void IGrammar::analyze()
+	{
+		firstSets.assign(rules.size(), set<int>());
+		nullableRules.assign(rules.size(), false);
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (unsigned int i = 0; i < rules.size(); i++)
+			{
+				for (vector<int>* option: rules[i]->symbols)
+				{
+					set<int> terminals;
+					bool nullable = first(*option, terminals);
+					for (int terminal: terminals)
+					{
+						changed = firstSets[i].insert(terminal).second || changed;
+					}
+					if (nullable && !nullableRules[i])
+					{
+						nullableRules[i] = true;
+						changed = true;
+					}
+				}
+				// the loops can start the rule when its alternatives can match an empty list of tokens
+				for (unsigned int j = 0; nullableRules[i] && j < rules[i]->loops.size(); j++)
+				{
+					set<int> terminals;
+					first(*rules[i]->loops[j], terminals);
+					for (int terminal: terminals)
+					{
+						changed = firstSets[i].insert(terminal).second || changed;
+					}
+				}
+			}
+		}
+		analyzeReentrance();
+	}
+
+	void IGrammar::analyzeReentrance()
+	{
+		unsigned int size = rules.size();
+		// the rules that each rule references at its starting position, directly or indirectly
+		vector<set<int>> starts(size);
+		for (unsigned int i = 0; i < size; i++)
+		{
+			for (vector<int>* option: rules[i]->symbols)
+			{
+				for (int symbol: *option)
+				{
+					if (symbol < 1000000000)
+					{
+						break;
+					}
+					starts[i].insert(symbol - 1000000000);
+					if (!nullableRules[symbol - 1000000000])
+					{
+						break;
+					}
+				}
+			}
+		}
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (unsigned int i = 0; i < size; i++)
+			{
+				set<int> closure(starts[i]);
+				for (int rule: starts[i])
+				{
+					closure.insert(starts[rule].begin(), starts[rule].end());
+				}
+				if (closure.size() != starts[i].size())
+				{
+					starts[i].swap(closure);
+					changed = true;
+				}
+			}
+		}
+		// the rules reached by two alternatives that may be tried at the same position
+		set<int> reentered;
+		for (IGrammarRule* rule: rules)
+		{
+			unsigned int count = rule->symbols.size();
+			vector<set<int>> firsts(count), reached(count);
+			vector<bool> nullable(count);
+			for (unsigned int i = 0; i < count; i++)
+			{
+				nullable[i] = first(*rule->symbols[i], firsts[i]);
+				for (int symbol: *rule->symbols[i])
+				{
+					if (symbol >= 1000000000)
+					{
+						reached[i].insert(symbol - 1000000000);
+						reached[i].insert(starts[symbol - 1000000000].begin(), starts[symbol - 1000000000].end());
+					}
+				}
+			}
+			for (unsigned int i = 0; i < count; i++)
+			{
+				for (unsigned int j = i + 1; j < count; j++)
+				{
+					bool overlap = nullable[i] || nullable[j];
+					for (auto it = firsts[i].begin(); !overlap && it != firsts[i].end(); ++it)
+					{
+						overlap = firsts[j].count(*it) > 0;
+					}
+					if (!overlap)
+					{
+						continue;
+					}
+					for (int r: reached[i])
+					{
+						if (reached[j].count(r))
+						{
+							reentered.insert(r);
+						}
+					}
+				}
+			}
+		}
+		reenteredRules.assign(reentered.begin(), reentered.end());
+	}
+
+	const vector<int>& IGrammar::reentered()
+	{
+		return reenteredRules;
+	}
+
+	bool IGrammar::first(const vector<int>& symbols, set<int>& set)
+	{
+		for (int symbol: symbols)
+		{
+			if (symbol < 1000000000)
+			{
+				set.insert(symbol);
+				return false;
+			}
+			unsigned int rule = symbol - 1000000000;
+			set.insert(firstSets[rule].begin(), firstSets[rule].end());
+			if (!nullableRules[rule])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	
 }; /* namespace pgen */
\ No newline at end of file
@@ -13,6 +13,7 @@ namespace pgen { class IGrammar; };
 
 // STL
 #include <vector>
+#include <set>
 // yaml-cpp
 #include <yaml-cpp/yaml.h>
 // pgen
@@ -57,6 +58,80 @@ namespace pgen
 		 * \return the C99 code that is able to parse the grammar.
 		 */
 		virtual string compile() = 0;
+
+		/**
+		 * Generate C99 code that is able to parse the grammar, split into multiple translation units. The units are
+		 * compiled separately and share the declarations returned by IGrammar::declarations().
+		 * The default implementation writes the whole grammar to a single unit.
+		 * \param units the vector to add the code of each translation unit to.
+		 * \param count the maximum number of translation units to split the grammar into.
+		 */
+		virtual void compile(vector<string>& units, unsigned int count);
+
+		/**
+		 * Generate the C99 declarations (prototypes) needed by the translation units of the grammar.
+		 * \return the C99 declarations of the functions that parse the grammar.
+		 */
+		virtual string declarations();
+
+		/**
+		 * Rewrites the left-recursive rules, which would make a recursive descent parser recurse infinitely. The 
+		 * indirect left recursion is turned into direct left recursion by replacing the rules that start an 
+		 * alternative and that can lead back to the rule by their alternatives, e.g. "a: b X | Y" and "b: a Z | W" 
+		 * become "a: a Z X | W X | Y" and "b: a Z | W". The symbols that come from "b" are still parsed into a node of 
+		 * "b" (see IGrammarRule::inlined), so the trees do not change. The rules are rewritten from the last to the 
+		 * first one, so the recursion is eliminated on the first rule of the cycle, which is usually the one it is 
+		 * entered from. Then the alternatives that start with the rule itself are moved to IGrammarRule::loops without 
+		 * their first symbol, e.g. "expression: expression ADD number | number" becomes "expression: number" with the 
+		 * loop "ADD number". The parser repeats the loops after matching the rule, nesting the previous subtree as the 
+		 * first child of a new node of the rule, so the subtrees are left-associative. Only the first symbol of the 
+		 * alternatives is considered, i.e. the left recursion behind a rule that can match an empty list of tokens is 
+		 * not rewritten.
+		 * \throws LanguageException when the rule that leads back to a rule is itself directly left-recursive.
+		 */
+		void eliminateLeftRecursion();
+
+		/**
+		 * Computes the FIRST set of every rule, i.e. the terminals that can start the text matched by the rule, and 
+		 * whether the rule can match an empty list of tokens. The sets are computed from IGrammarRule::symbols (and 
+		 * IGrammarRule::loops) by iterating until no set changes, so it must be called again when rules are added.
+		 */
+		void analyze();
+
+		/**
+		 * Adds the FIRST set of a sequence of symbols to a set (see IGrammar::analyze(), which must be called before).
+		 * \param symbols the sequence of symbols, e.g. an alternative of a rule.
+		 * \param set the set to add the terminals to.
+		 * \return true when the sequence can match an empty list of tokens.
+		 */
+		bool first(const vector<int>& symbols, set<int>& set);
+
+		/**
+		 * Returns the rules that may be parsed more than once at the same position of the token list (see 
+		 * IGrammar::analyze(), which must be called before). A rule is re-entered when it can be reached from two 
+		 * alternatives of another rule that can start with the same token (or that can match an empty list of tokens),
+		 * since the failure of the first alternative backtracks to the second one. The rules are reached either 
+		 * directly or through the rules that start the referenced ones. These are the rules whose results are worth
+		 * memoizing on a packrat parser.
+		 * \return the indexes of the re-entered rules on IGrammar::rules, in ascending order.
+		 */
+		const vector<int>& reentered();
+	private:
+		vector<set<int>> firstSets;			//< The FIRST set of each rule.
+		vector<bool> nullableRules;			//< True for each rule that can match an empty list of tokens.
+		vector<int> reenteredRules;			//< The rules that may be parsed more than once at the same position.
+
+		/**
+		 * \return true when a rule can start with another rule, directly or through the rules that start it.
+		 * \param from the index of the first rule.
+		 * \param to the index of the rule to find.
+		 */
+		bool leads(int from, int to);
+
+		/**
+		 * Finds the re-entered rules (see IGrammar::reentered()). Called by IGrammar::analyze().
+		 */
+		void analyzeReentrance();
 	}; /* class IGrammar */
 }; /* namespace pgen */
 
@@ -36,6 +36,10 @@ namespace pgen
 				delete symSeq;
 			}
 		}
+		for (auto loop: loops)
+		{
+			delete loop;
+		}
 	}
 	
 	void IGrammarRule::add(YAML::Node &ruleNode) 
@@ -14,6 +14,7 @@ namespace pgen { class IGrammarRule; };
 // STL
 #include <string>
 #include <vector>
+#include <map>
 // yaml-cpp
 #include <yaml-cpp/yaml.h>
 // pgen
@@ -25,12 +26,19 @@ namespace pgen
 	
 	class IGrammarRule 
 	{
-	private:
+	protected:
 		IGrammarRule(Language* language, string &name);
 	public:
 		Language* language;				//< The language of this rule
 		string name;					//< The name of this rule
 		vector<vector<int>*> symbols;	//< Contains a list of symbols for each alternative of the rule.			
+		vector<vector<int>*> loops;		//< The symbols that can repeat after the rule (see IGrammar::eliminateLeftRecursion()).
+		/**
+		 * The nodes of the rules that were inlined at the start of an alternative or of a loop (see 
+		 * IGrammar::eliminateLeftRecursion()): the id of each rule and the number of symbols of the alternative (plus 
+		 * the repeated subtree, on the loops) that are its children, from the innermost to the outermost node.
+		 */
+		map<const vector<int>*, vector<pair<int, unsigned int>>> inlined;
 		
 		IGrammarRule(Language* language, string &name, YAML::Node &ruleNode);
 		virtual ~IGrammarRule();
@@ -0,0 +1,579 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-28
+ * \file
+ * This file contains the implementation of the LALR1 class. This class is responsible for generating a table-driven 
+ * LALR(1) parser for a specified language (see LALR1.h).
+ * These parsers don't need to parse text at all. They parse a list of tokens.
+ */
+ 
+// STL
+#include <sstream>
+#include <string>
+#include <iostream>
+#include <algorithm>
+// pgen
+#include "LALR1.h"
+#include "TableRule.h"
+ 
+using namespace std;
+namespace pgen 
+{
+
+	const string LALR1::NAME = "LALR(1)";
+
+	LALR1::~LALR1() 
+	{
+	}
+
+	void LALR1::addRule(string& name, YAML::Node &ruleNode) 
+	{
+		rules.push_back(new TableRule(language, name, ruleNode));
+	}
+
+	void LALR1::closure(set<Item>& items)
+	{
+		vector<Item> pending(items.begin(), items.end());
+		while (!pending.empty())
+		{
+			Item item = pending.back();
+			pending.pop_back();
+			vector<int>& symbols = productions[item.first];
+			if (item.second < (int)symbols.size() && symbols[item.second] >= 1000000000)
+			{
+				for (int production: ruleProductions[symbols[item.second]-1000000000])
+				{
+					if (items.insert(Item(production, 0)).second)
+					{
+						pending.push_back(Item(production, 0));
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * The starting production (production 0) is "%startRule%", so the state 0 is the closure of its item and the 
+	 * starting rule is accepted when it is reduced. The states are numbered in the order they are found.
+	 */
+	void LALR1::buildStates()
+	{
+		productionRules.assign(1, -1);
+		productions.assign(1, vector<int>(1, language->startRule));
+		ruleProductions.assign(rules.size(), vector<int>());
+		for (unsigned int i = 0; i < rules.size(); i++)
+		{
+			for (vector<int>* option: rules[i]->symbols)
+			{
+				ruleProductions[i].push_back(productions.size());
+				productionRules.push_back(i);
+				productions.push_back(*option);
+			}
+		}
+		kernels.assign(1, vector<Item>(1, Item(0, 0)));
+		transitions.clear();
+		map<vector<Item>, int> states;
+		states[kernels[0]] = 0;
+		for (unsigned int state = 0; state < kernels.size(); state++)
+		{
+			set<Item> items(kernels[state].begin(), kernels[state].end());
+			closure(items);
+			map<int, vector<Item>> next;
+			for (Item item: items)
+			{
+				vector<int>& symbols = productions[item.first];
+				if (item.second < (int)symbols.size())
+				{
+					next[symbols[item.second]].push_back(Item(item.first, item.second + 1));
+				}
+			}
+			transitions.push_back(map<int, int>());
+			for (auto& kv: next)
+			{
+				auto it = states.find(kv.second);
+				if (it == states.end())
+				{
+					it = states.insert(make_pair(kv.second, (int)kernels.size())).first;
+					kernels.push_back(kv.second);
+				}
+				transitions[state][kv.first] = it->second;
+			}
+		}
+	}
+
+	/**
+	 * The LR(1) closure of each kernel item is computed with a dummy lookahead (-2). The lookaheads of the items that
+	 * are reached from the closure (the kernel items of the next states and the empty productions of the state itself)
+	 * are generated spontaneously, except the dummy one, which means that the lookaheads of the kernel item propagate
+	 * to them. The end of the token list (-1) is the lookahead of the starting production.
+	 */
+	void LALR1::buildLookaheads(map<pair<int, Item>, set<int>>& lookaheads)
+	{
+		const int PROPAGATE = -2;
+		map<pair<int, Item>, vector<pair<int, Item>>> links;
+		lookaheads[make_pair(0, Item(0, 0))].insert(-1);
+		for (unsigned int state = 0; state < kernels.size(); state++)
+		{
+			for (Item kernel: kernels[state])
+			{
+				map<Item, set<int>> items;
+				items[kernel].insert(PROPAGATE);
+				vector<Item> pending(1, kernel);
+				while (!pending.empty())
+				{
+					Item item = pending.back();
+					pending.pop_back();
+					vector<int>& symbols = productions[item.first];
+					if (item.second >= (int)symbols.size() || symbols[item.second] < 1000000000)
+					{
+						continue;
+					}
+					set<int> next;
+					if (first(vector<int>(symbols.begin() + item.second + 1, symbols.end()), next))
+					{
+						next.insert(items[item].begin(), items[item].end());
+					}
+					for (int production: ruleProductions[symbols[item.second]-1000000000])
+					{
+						set<int>& target = items[Item(production, 0)];
+						unsigned int size = target.size();
+						target.insert(next.begin(), next.end());
+						if (target.size() != size)
+						{
+							pending.push_back(Item(production, 0));
+						}
+					}
+				}
+				for (auto& kv: items)
+				{
+					Item item = kv.first;
+					vector<int>& symbols = productions[item.first];
+					pair<int, Item> to;
+					if (item.second < (int)symbols.size())
+					{
+						to = make_pair(transitions[state][symbols[item.second]], Item(item.first, item.second + 1));
+					}
+					else if (item != kernel)
+					{
+						to = make_pair(state, item);
+					}
+					else
+					{
+						continue;
+					}
+					for (int lookahead: kv.second)
+					{
+						if (lookahead == PROPAGATE)
+						{
+							links[make_pair(state, kernel)].push_back(to);
+						}
+						else
+						{
+							lookaheads[to].insert(lookahead);
+						}
+					}
+				}
+			}
+		}
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (auto& kv: links)
+			{
+				set<int>& from = lookaheads[kv.first];
+				for (auto& to: kv.second)
+				{
+					set<int>& target = lookaheads[to];
+					unsigned int size = target.size();
+					target.insert(from.begin(), from.end());
+					changed = changed || target.size() != size;
+				}
+			}
+		}
+	}
+
+	string LALR1::symbolName(int symbol)
+	{
+		if (symbol == -1)
+		{
+			return "end of input";
+		}
+		return (symbol < 1000000000 ? language->tokenizer.getTypeName(symbol) : language->getNonTerminalName(symbol));
+	}
+
+	bool LALR1::setAction(int state, int type, int action)
+	{
+		auto production = [this](int action) {
+			int p = -action - 1;
+			int rule = productionRules[p];
+			return rules[rule]->name + " (alternative " + to_string(p - ruleProductions[rule][0] + 1) + ")";
+		};
+		auto it = actions[state].find(type);
+		if (it == actions[state].end())
+		{
+			actions[state][type] = action;
+			return false;
+		}
+		if (it->second == action)
+		{
+			return false;
+		}
+		if (it->second > 0)
+		{
+			cerr << "Warning: state " << state << ": LALR(1) shift/reduce conflict on " << symbolName(type) << 
+				" between the shift and the reduction of " << production(action) << ", the shift is used." << endl;
+			return true;
+		}
+		int used = max(it->second, action);
+		cerr << "Warning: state " << state << ": LALR(1) reduce/reduce conflict on " << symbolName(type) << 
+			" between the reductions of " << production(it->second) << " and " << production(action) << 
+			", the reduction of " << production(used) << " is used." << endl;
+		it->second = used;
+		return true;
+	}
+
+	/**
+	 * The most frequent reduction of each state becomes its default action, which is used for the token types that 
+	 * have no action on the state. The error is only detected when a token can not be shifted, after the default 
+	 * reductions, which never consume the wrong token. The action on the end of the token list is always kept in the
+	 * table, so the parser can tell the states on which the tokens read so far may match the starting rule.
+	 */
+	unsigned int LALR1::analyzeTable()
+	{
+		this->analyze();
+		buildStates();
+		map<pair<int, Item>, set<int>> lookaheads;
+		buildLookaheads(lookaheads);
+		unsigned int conflicts = 0;
+		actions.assign(kernels.size(), map<int, int>());
+		defaults.assign(kernels.size(), 0);
+		for (unsigned int state = 0; state < kernels.size(); state++)
+		{
+			for (auto& kv: transitions[state])
+			{
+				if (kv.first < 1000000000)
+				{
+					actions[state][kv.first] = kv.second + 1;
+				}
+			}
+		}
+		for (auto& kv: lookaheads)
+		{
+			int state = kv.first.first;
+			Item item = kv.first.second;
+			if (item.second < (int)productions[item.first].size())
+			{
+				continue;
+			}
+			if (item.first == 0)
+			{
+				defaults[state] = ACCEPT;
+				continue;
+			}
+			for (int type: kv.second)
+			{
+				conflicts += (setAction(state, type, -item.first - 1) ? 1 : 0);
+			}
+		}
+		for (unsigned int state = 0; state < kernels.size(); state++)
+		{
+			if (defaults[state] != 0)
+			{
+				continue;
+			}
+			map<int, int> frequency;
+			for (auto& kv: actions[state])
+			{
+				if (kv.second < 0 && ++frequency[kv.second] > frequency[defaults[state]])
+				{
+					defaults[state] = kv.second;
+				}
+			}
+			for (auto it = actions[state].begin(); defaults[state] != 0 && it != actions[state].end(); )
+			{
+				it = (it->second == defaults[state] && it->first != -1 ? actions[state].erase(it) : ++it);
+			}
+		}
+		return conflicts;
+	}
+
+	void LALR1::compileArray(ostream& s, const string& name, const vector<int>& values)
+	{
+		int min = 0, max = 0;
+		for (int value: values)
+		{
+			min = std::min(min, value);
+			max = std::max(max, value);
+		}
+		s << "static const " << (min >= -128 && max <= 127 ? "signed char" : 
+			(min >= -32768 && max <= 32767 ? "short" : "int")) << " " << name << "[" << values.size() << "] = {";
+		for (unsigned int i = 0; i < values.size(); i++)
+		{
+			s << (i == 0 ? "" : ",") << (i % 16 == 0 ? "\n " : " ") << values[i];
+		}
+		s << "\n};"																						"\n";
+	}
+
+	/**
+	 * The actions are encoded as integers: 0 is an error, a positive action shifts the token and goes to the state 
+	 * action-1, and a negative action reduces the production -action-1 (ACCEPT reduces the starting production). 
+	 * The action of each state for each token type (plus one, the end of the token list is the column 0) and the next
+	 * state of each state for each rule (on the columns that follow the token types) are stored in a single table
+	 * compressed by row displacement: the row of each state starts at %prefix%lalr_base[state] and shares the table 
+	 * with the other rows, and %prefix%lalr_check tells which state owns each entry. The missing actions are the 
+	 * default actions of the states, except on the end of the token list (see analyzeTable()).
+	 * compiled code:
+	 * %rule->compile() for each rule%
+	 * static const %type% %prefix%lalr_rule[] = { %rule of each production% };
+	 * static const %type% %prefix%lalr_length[] = { %number of symbols of each production% };
+	 * static const %type% %prefix%lalr_base[] = { %start of the row of each state% };
+	 * static const %type% %prefix%lalr_default[] = { %default action of each state% };
+	 * static const %type% %prefix%lalr_check[] = { %state of each entry, or -1% };
+	 * static const %type% %prefix%lalr_table[] = { %action or next state of each entry% };
+	 * %compileParse()%
+	 */
+	string LALR1::compile() 
+	{
+		stringstream s;
+		this->analyzeTable();
+		s << this->declarations();
+		for (auto rule: rules)
+		{
+			s << rule->compile();
+		}
+		// the rows, the largest ones first
+		unsigned int types = language->tokenizer.typeList.size() + 1;
+		unsigned int columns = types + rules.size();
+		vector<vector<pair<int, int>>> rows(kernels.size());
+		vector<int> order;
+		for (unsigned int state = 0; state < kernels.size(); state++)
+		{
+			for (auto& kv: actions[state])
+			{
+				rows[state].push_back(make_pair(kv.first + 1, kv.second));
+			}
+			for (auto& kv: transitions[state])
+			{
+				if (kv.first >= 1000000000)
+				{
+					rows[state].push_back(make_pair(types + kv.first - 1000000000, kv.second));
+				}
+			}
+			order.push_back(state);
+		}
+		stable_sort(order.begin(), order.end(), [&rows](int a, int b) { return rows[a].size() > rows[b].size(); });
+		// the first base that fits each row
+		vector<int> base(kernels.size(), 0), check, table;
+		for (int state: order)
+		{
+			for (int b = 0; !rows[state].empty(); b++)
+			{
+				bool fits = true;
+				for (auto& entry: rows[state])
+				{
+					fits = fits && (b + entry.first >= (int)check.size() || check[b + entry.first] == -1);
+				}
+				if (fits)
+				{
+					base[state] = b;
+					for (auto& entry: rows[state])
+					{
+						if (b + entry.first >= (int)check.size())
+						{
+							check.resize(b + entry.first + 1, -1);
+							table.resize(b + entry.first + 1, 0);
+						}
+						check[b + entry.first] = state;
+						table[b + entry.first] = entry.second;
+					}
+					break;
+				}
+			}
+		}
+		check.resize(*max_element(base.begin(), base.end()) + columns, -1);
+		table.resize(check.size(), 0);
+		vector<int> lengths;
+		for (auto& production: productions)
+		{
+			lengths.push_back(production.size());
+		}
+		compileArray(s, language->prefix + "lalr_rule", productionRules);
+		compileArray(s, language->prefix + "lalr_length", lengths);
+		compileArray(s, language->prefix + "lalr_base", base);
+		compileArray(s, language->prefix + "lalr_default", defaults);
+		compileArray(s, language->prefix + "lalr_check", check);
+		compileArray(s, language->prefix + "lalr_table", table);
+		s << "\n" << this->compileParse();
+		return s.str();
+	}
+
+	string LALR1::declarations()
+	{
+		stringstream s;
+		s << "ast_node* " << language->prefix << "parse(token_list* tokens, int* pos);"					"\n";
+		return s.str();
+	}
+
+	/**
+	 * The parser keeps a stack of states and a stack with the node of each state. A shift pushes the node of the 
+	 * token, and a reduction pops the nodes of the symbols of the production, which become the children of the node
+	 * of the rule that is pushed. The trees are the same ones built by the LL(*) parser. The nodes are allocated from
+	 * the arena of the token list, which is reset to its initial mark when the parsing fails.
+	 * Like the LL(*) parser, the parser matches the longest list of tokens that matches the starting rule. The last 
+	 * position on which the end of the token list has an action is remembered, and when a later token is rejected the
+	 * parser starts again as if the token list ended on that position. The restarts stop when there is no such 
+	 * position (the LALR(1) lookaheads may allow the end of the token list on a state that does not accept it).
+	 * compiled code:
+	 * ast_node* %prefix%parse(token_list* tokens, int* pos) {
+	 *  int opos = *pos;
+	 *  int size = 64, top = 0;
+	 *  int state = 0, type, action, production, i;
+	 *  int end = tokens->count, last = -1;
+	 *  int* states = (int*) malloc(size * sizeof(int));
+	 *  ast_node** nodes = (ast_node**) malloc(size * sizeof(ast_node*));
+	 *  int* grownStates;
+	 *  ast_node** grownNodes;
+	 *  ast_node* node;
+	 *  ast_mark mark = ast_arena_mark(&tokens->arena);
+	 *  if (states == NULL || nodes == NULL) goto fail;
+	 *  states[0] = 0;
+	 *  nodes[0] = NULL;
+	 *  for (;;) {
+	 *   type = (*pos < end ? tokens->items[*pos].type : -1);
+	 *   if (type != -1 && %prefix%lalr_check[%prefix%lalr_base[state]] == state) last = *pos;
+	 *   i = %prefix%lalr_base[state] + type + 1;
+	 *   action = (%prefix%lalr_check[i] == state ? %prefix%lalr_table[i] : %prefix%lalr_default[state]);
+	 *   if (action == 0) {
+	 *    if (last < 0) goto fail;
+	 *    ast_arena_reset(&tokens->arena, mark);
+	 *    end = last;
+	 *    last = -1;
+	 *    *pos = opos;
+	 *    state = 0;
+	 *    top = 0;
+	 *    continue;
+	 *   }
+	 *   if (action > 0) {
+	 *    node = ast_arena_new_node(&tokens->arena);
+	 *    node->tokenId = type;
+	 *    node->data = tokens->items[*pos].value;
+	 *    ++(*pos);
+	 *    state = action - 1;
+	 *   } else {
+	 *    production = -action - 1;
+	 *    top -= %prefix%lalr_length[production];
+	 *    if (production == 0) {
+	 *     node = nodes[1];
+	 *     free(states);
+	 *     free(nodes);
+	 *     return node;
+	 *    }
+	 *    node = ast_arena_new_node(&tokens->arena);
+	 *    node->tokenId = 1000000000 + %prefix%lalr_rule[production];
+	 *    for (i = %prefix%lalr_length[production]; i > 0; i--) {
+	 *     nodes[top + i]->nextSibling = node->firstChild;
+	 *     node->firstChild = nodes[top + i];
+	 *    }
+	 *    state = %prefix%lalr_table[%prefix%lalr_base[states[top]] + %types% + %prefix%lalr_rule[production]];
+	 *   }
+	 *   if (++top == size) {
+	 *    size *= 2;
+	 *    grownStates = (int*) realloc(states, size * sizeof(int));
+	 *    if (grownStates == NULL) goto fail;
+	 *    states = grownStates;
+	 *    grownNodes = (ast_node**) realloc(nodes, size * sizeof(ast_node*));
+	 *    if (grownNodes == NULL) goto fail;
+	 *    nodes = grownNodes;
+	 *   }
+	 *   states[top] = state;
+	 *   nodes[top] = node;
+	 *  }
+	 * fail:
+	 *  ast_arena_reset(&tokens->arena, mark);
+	 *  free(states);
+	 *  free(nodes);
+	 *  *pos = opos;
+	 *  return NULL;
+	 * }
+	 */
+	string LALR1::compileParse()
+	{
+		stringstream s;
+		string p = language->prefix;
+		s << "ast_node* " << p << "parse(token_list* tokens, int* pos) {"								"\n"
+			 " int opos = *pos;"																		"\n"
+			 " int size = 64, top = 0;"																	"\n"
+			 " int state = 0, type, action, production, i;"												"\n"
+			 " int end = tokens->count, last = -1;"														"\n"
+			 " int* states = (int*) malloc(size * sizeof(int));"										"\n"
+			 " ast_node** nodes = (ast_node**) malloc(size * sizeof(ast_node*));"						"\n"
+			 " int* grownStates;"																		"\n"
+			 " ast_node** grownNodes;"																	"\n"
+			 " ast_node* node;"																			"\n"
+			 " ast_mark mark = ast_arena_mark(&tokens->arena);"										"\n"
+			 " if (states == NULL || nodes == NULL) goto fail;"											"\n"
+			 " states[0] = 0;"																			"\n"
+			 " nodes[0] = NULL;"																		"\n"
+			 " for (;;) {"																				"\n"
+			 "  type = (*pos < end ? tokens->items[*pos].type : -1);"									"\n"
+			 "  if (type != -1 && " << p << "lalr_check[" << p << "lalr_base[state]] == state) last = *pos;"	"\n"
+			 "  i = " << p << "lalr_base[state] + type + 1;"											"\n"
+			 "  action = (" << p << "lalr_check[i] == state ? " << p << "lalr_table[i] : " << p << "lalr_default[state]);\n"
+			 "  if (action == 0) {"																		"\n"
+			 "   if (last < 0) goto fail;"																"\n"
+			 "   ast_arena_reset(&tokens->arena, mark);"												"\n"
+			 "   end = last;"																			"\n"
+			 "   last = -1;"																			"\n"
+			 "   *pos = opos;"																			"\n"
+			 "   state = 0;"																			"\n"
+			 "   top = 0;"																				"\n"
+			 "   continue;"																				"\n"
+			 "  }"																						"\n"
+			 "  if (action > 0) {"																		"\n"
+			 "   node = ast_arena_new_node(&tokens->arena);"											"\n"
+			 "   node->tokenId = type;"																	"\n"
+			 "   node->data = tokens->items[*pos].value;"												"\n"
+			 "   ++(*pos);"																				"\n"
+			 "   state = action - 1;"																	"\n"
+			 "  } else {"																				"\n"
+			 "   production = -action - 1;"																"\n"
+			 "   top -= " << p << "lalr_length[production];"											"\n"
+			 "   if (production == 0) {"																"\n"
+			 "    node = nodes[1];"																		"\n"
+			 "    free(states);"																		"\n"
+			 "    free(nodes);"																			"\n"
+			 "    return node;"																			"\n"
+			 "   }"																						"\n"
+			 "   node = ast_arena_new_node(&tokens->arena);"											"\n"
+			 "   node->tokenId = 1000000000 + " << p << "lalr_rule[production];"						"\n"
+			 "   for (i = " << p << "lalr_length[production]; i > 0; i--) {"							"\n"
+			 "    nodes[top + i]->nextSibling = node->firstChild;"										"\n"
+			 "    node->firstChild = nodes[top + i];"													"\n"
+			 "   }"																						"\n"
+			 "   state = " << p << "lalr_table[" << p << "lalr_base[states[top]] + " << 
+			 (language->tokenizer.typeList.size() + 1) << " + " << p << "lalr_rule[production]];"		"\n"
+			 "  }"																						"\n"
+			 "  if (++top == size) {"																	"\n"
+			 "   size *= 2;"																			"\n"
+			 "   grownStates = (int*) realloc(states, size * sizeof(int));"								"\n"
+			 "   if (grownStates == NULL) goto fail;"													"\n"
+			 "   states = grownStates;"																	"\n"
+			 "   grownNodes = (ast_node**) realloc(nodes, size * sizeof(ast_node*));"					"\n"
+			 "   if (grownNodes == NULL) goto fail;"													"\n"
+			 "   nodes = grownNodes;"																	"\n"
+			 "  }"																						"\n"
+			 "  states[top] = state;"																	"\n"
+			 "  nodes[top] = node;"																		"\n"
+			 " }"																						"\n"
+			 "fail:"																					"\n"
+			 " ast_arena_reset(&tokens->arena, mark);"													"\n"
+			 " free(states);"																			"\n"
+			 " free(nodes);"																			"\n"
+			 " *pos = opos;"																			"\n"
+			 " return NULL;"																			"\n"
+			 "}"																						"\n\n";
+		return s.str();
+	}
+	
+}; /* namespace pgen */
@@ -0,0 +1,136 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-28
+ * \file
+ * This file contains the declaration of the LALR1 class. This class is responsible for generating a table-driven 
+ * LALR(1) parser for a specified language. The parser is a shift-reduce automaton built from the LR(0) item sets of 
+ * the grammar, with the lookaheads of the reductions computed as on LALR(1) parsers, so it accepts left-recursive 
+ * rules. The action and goto tables are compressed and driven by a loop with explicit stacks on the heap.
+ */
+ 
+#ifndef LALR1_H_
+#define LALR1_H_
+
+namespace pgen { class LALR1; }
+
+// STL
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <ostream>
+// yaml-cpp
+#include <yaml-cpp/yaml.h>
+// pgen
+#include "IGrammar.h"
+#include "Language.h"
+
+using namespace std; 
+namespace pgen 
+{
+	
+	class LALR1 
+	 : public IGrammar 
+	{
+	public:
+		/**
+		 * Name of the grammar type (parser type)
+		 */
+		static const string NAME;
+		
+		/**
+		 * Using the IGrammar constructor.
+		 */
+		using IGrammar::IGrammar;
+		
+		/**
+		 * Virtual destructor. Currently does nothing. However the base (IGrammar) constructor is called and frees all
+		 * rules.
+		 */
+		virtual ~LALR1();
+		
+		/**
+		 * Adds a new grammar rule from a YAML node.
+		 * \param name the name of the rule
+		 * \param ruleNode the actual rule node.
+		 */
+		virtual void addRule(string &name, YAML::Node &ruleNode);
+		
+		/**
+		 * Generate C99 code that is able to parse the grammar.
+		 * \return the C99 code that is able to parse the grammar.
+		 */
+		virtual string compile();
+
+		/**
+		 * Generate the prototype of the parse function.
+		 * \return the C99 declarations of the functions that parse the grammar.
+		 */
+		virtual string declarations();
+
+		/**
+		 * Builds the LALR(1) automaton of the grammar and its action table. The shift/reduce conflicts are resolved in
+		 * favor of the shift, and the reduce/reduce conflicts in favor of the first rule (and alternative). Both are
+		 * reported on the standard error.
+		 * \return the number of conflicts found.
+		 */
+		unsigned int analyzeTable();
+	private:
+		/**
+		 * An LR(0) item: the index of a production and the position of the dot.
+		 */
+		typedef pair<int, int> Item;
+
+		/**
+		 * The action that accepts the input, i.e. the reduction of the starting production. It is the default action
+		 * of the state reached by the starting rule, so the parser stops there without looking at the next token.
+		 */
+		static const int ACCEPT = -1;
+
+		vector<int> productionRules;					//< The rule of each production (-1 for the starting production).
+		vector<vector<int>> productions;				//< The symbols of each production.
+		vector<vector<int>> ruleProductions;			//< The productions of each rule.
+		vector<vector<Item>> kernels;					//< The kernel items of each state.
+		vector<map<int, int>> transitions;				//< The next state of each state, for each symbol.
+		vector<map<int, int>> actions;					//< The action of each state for each token type (see compile()).
+		vector<int> defaults;							//< The default action of each state, or 0.
+
+		/**
+		 * Computes the LR(0) closure of a set of items.
+		 * \param items the items, the items of the closure are added to it.
+		 */
+		void closure(set<Item>& items);
+		/**
+		 * Builds the LR(0) item sets (the states) and their transitions.
+		 */
+		void buildStates();
+		/**
+		 * Computes the lookaheads of the reductions with the propagation method: the lookaheads that are generated 
+		 * spontaneously by the closure of each kernel item, and then the ones propagated through the transitions.
+		 * \param lookaheads the map to write the lookaheads of each completed item of each state to.
+		 */
+		void buildLookaheads(map<pair<int, Item>, set<int>>& lookaheads);
+		/**
+		 * Sets an action of the parse table, resolving and reporting conflicts.
+		 * \return true if there was a conflict.
+		 */
+		bool setAction(int state, int type, int action);
+		/**
+		 * \return the name of a symbol or "end of input" for -1.
+		 */
+		string symbolName(int symbol);
+		/**
+		 * Writes a static constant C99 array with the smallest integer type that fits its values.
+		 * \param s the stream to write to.
+		 * \param name the name of the array.
+		 * \param values the values of the array.
+		 */
+		static void compileArray(ostream& s, const string& name, const vector<int>& values);
+		/**
+		 * \return the C99 code of the parse function.
+		 */
+		string compileParse();
+	}; /* class LALR1 */
+}; /* namespace pgen */
+ 
+#endif /* LALR1_H_ */
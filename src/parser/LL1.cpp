@@ -0,0 +1,345 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-27
+ * \file
+ * This file contains the implementation of the LL1 class. This class is responsible for generating a table-driven 
+ * LL(1) parser for a specified language (see LL1.h).
+ * These parsers don't need to parse text at all. They parse a list of tokens.
+ */
+ 
+// STL
+#include <sstream>
+#include <string>
+#include <iostream>
+// pgen
+#include "LL1.h"
+#include "TableRule.h"
+#include "../misc/LanguageException.h"
+ 
+using namespace std;
+namespace pgen 
+{
+
+	const string LL1::NAME = "LL(1)";
+
+	LL1::~LL1() 
+	{
+	}
+
+	void LL1::addRule(string& name, YAML::Node &ruleNode) 
+	{
+		rules.push_back(new TableRule(language, name, ruleNode));
+	}
+
+	void LL1::follow(vector<set<int>>& sets)
+	{
+		sets.assign(rules.size(), set<int>());
+		sets[language->startRule-1000000000].insert(-1);
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (unsigned int i = 0; i < rules.size(); i++)
+			{
+				for (vector<int>* option: rules[i]->symbols)
+				{
+					for (unsigned int j = 0; j < option->size(); j++)
+					{
+						if (option->at(j) < 1000000000)
+						{
+							continue;
+						}
+						set<int>& target = sets[option->at(j)-1000000000];
+						set<int> next;
+						if (first(vector<int>(option->begin() + j + 1, option->end()), next))
+						{
+							next.insert(sets[i].begin(), sets[i].end());
+						}
+						for (int type: next)
+						{
+							changed = target.insert(type).second || changed;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	string LL1::symbolName(int symbol)
+	{
+		if (symbol == -1)
+		{
+			return "end of input";
+		}
+		return (symbol < 1000000000 ? language->tokenizer.getTypeName(symbol) : language->getNonTerminalName(symbol));
+	}
+
+	bool LL1::leftRecursive(unsigned int rule)
+	{
+		vector<bool> visited(rules.size(), false);
+		vector<unsigned int> pending(1, rule);
+		while (!pending.empty())
+		{
+			unsigned int current = pending.back();
+			pending.pop_back();
+			for (vector<int>* option: rules[current]->symbols)
+			{
+				for (int symbol: *option)
+				{
+					if (symbol < 1000000000)
+					{
+						break;
+					}
+					unsigned int next = symbol - 1000000000;
+					if (next == rule)
+					{
+						return true;
+					}
+					if (!visited[next])
+					{
+						visited[next] = true;
+						pending.push_back(next);
+					}
+					set<int> types;
+					if (!first(vector<int>(1, symbol), types))
+					{
+						break;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	unsigned int LL1::analyzeTable()
+	{
+		this->analyze();
+		for (unsigned int i = 0; i < rules.size(); i++)
+		{
+			if (leftRecursive(i))
+			{
+				throw LanguageException("The rule '" + rules[i]->name + "' is left-recursive, which is not supported "
+					"by the LL(1) parser.");
+			}
+		}
+		vector<set<int>> follows;
+		follow(follows);
+		unsigned int conflicts = 0;
+		table.assign(rules.size(), vector<int>(language->tokenizer.typeList.size() + 1, -1));
+		for (unsigned int i = 0; i < rules.size(); i++)
+		{
+			for (unsigned int a = 0; a < rules[i]->symbols.size(); a++)
+			{
+				set<int> types;
+				if (first(*rules[i]->symbols[a], types))
+				{
+					types.insert(follows[i].begin(), follows[i].end());
+				}
+				for (int type: types)
+				{
+					int& entry = table[i][type+1];
+					if (entry == -1)
+					{
+						entry = a;
+					}
+					else if (entry != (int)a)
+					{
+						if (!language->resolveConflicts)
+						{
+							stringstream msg;
+							msg << "The rule '" << rules[i]->name << "' has an LL(1) conflict on " << symbolName(type) 
+								<< " between the alternatives " << (entry+1) << " and " << (a+1) << ".";
+							throw LanguageException(msg.str());
+						}
+						++conflicts;
+						cerr << "Warning: rule " << rules[i]->name << ": LL(1) conflict on " << symbolName(type) << 
+							" between the alternatives " << (entry+1) << " and " << (a+1) << ", the alternative " << 
+							(entry+1) << " is used." << endl;
+					}
+				}
+			}
+		}
+		return conflicts;
+	}
+
+	/**
+	 * The alternatives of all rules are numbered as productions: the symbols of production p are 
+	 * %prefix%ll1_symbols[%prefix%ll1_offsets[p]] to %prefix%ll1_symbols[%prefix%ll1_offsets[p+1]-1]. The parse 
+	 * table has a row for each rule and a column for each token type plus one (the end of the token list is the first
+	 * column). The table uses the smallest C type that fits the production numbers.
+	 * compiled code:
+	 * %rule->compile() for each rule%
+	 * static const int %prefix%ll1_symbols[] = { %symbols of each production% };
+	 * static const int %prefix%ll1_offsets[] = { %offset of each production, and the total% };
+	 * static const %type% %prefix%ll1_table[%rules%][%token types + 1%] = { %production or -1% };
+	 * %compileParse()%
+	 */
+	string LL1::compile() 
+	{
+		stringstream s;
+		this->analyzeTable();
+		s << this->declarations();
+		vector<int> symbols, offsets, base;
+		for (auto rule: rules)
+		{
+			base.push_back(offsets.size());
+			for (vector<int>* option: rule->symbols)
+			{
+				offsets.push_back(symbols.size());
+				symbols.insert(symbols.end(), option->begin(), option->end());
+			}
+			s << rule->compile();
+		}
+		offsets.push_back(symbols.size());
+		if (symbols.empty())
+		{
+			symbols.push_back(0);
+		}
+		auto array = [&s](const vector<int>& values) {
+			for (unsigned int i = 0; i < values.size(); i++)
+			{
+				s << (i == 0 ? "" : ",") << (i % 16 == 0 ? "\n " : " ") << values[i];
+			}
+			s << "\n};"																					"\n";
+		};
+		string type = (offsets.size() <= 128 ? "signed char" : (offsets.size() <= 32768 ? "short" : "int"));
+		s << "static const int " << language->prefix << "ll1_symbols[] = {";
+		array(symbols);
+		s << "static const int " << language->prefix << "ll1_offsets[] = {";
+		array(offsets);
+		s << "static const " << type << " " << language->prefix << "ll1_table[" << rules.size() << "][" << 
+			(language->tokenizer.typeList.size() + 1) << "] = {"											"\n";
+		for (unsigned int i = 0; i < rules.size(); i++)
+		{
+			s << " {";
+			for (unsigned int j = 0; j < table[i].size(); j++)
+			{
+				s << (j == 0 ? "" : ",") << (table[i][j] < 0 ? -1 : base[i] + table[i][j]);
+			}
+			s << "}" << (i + 1 < rules.size() ? "," : "") <<												"\n";
+		}
+		s << "};"																							"\n\n"
+		  << this->compileParse();
+		return s.str();
+	}
+
+	string LL1::declarations()
+	{
+		stringstream s;
+		s << "ast_node* " << language->prefix << "parse(token_list* tokens, int* pos);"					"\n";
+		return s.str();
+	}
+
+	/**
+	 * The stack keeps the nodes of the symbols that were not parsed yet, and starts with the node of the starting rule.
+	 * A rule on the top of the stack is expanded with the production chosen by the table for the current token: the 
+	 * nodes of the symbols of the production are added to the node of the rule as its children, in order, and pushed in
+	 * reverse order (so that the first symbol is on the top). A token type on the top of the stack must match the 
+	 * current token. Since the children are created in order, the tree does not have to be inverted. The nodes are
+	 * allocated from the arena of the token list, which is reset to its initial mark when the parsing fails.
+	 * compiled code:
+	 * ast_node* %prefix%parse(token_list* tokens, int* pos) {
+	 *  int opos = *pos;
+	 *  int size = 64, top = 0;
+	 *  int type, production, count, i;
+	 *  ast_mark mark = ast_arena_mark(&tokens->arena);
+	 *  ast_node* root = ast_arena_new_node(&tokens->arena);
+	 *  ast_node* node;
+	 *  ast_node** last;
+	 *  ast_node** grown;
+	 *  ast_node** stack = (ast_node**) malloc(size * sizeof(ast_node*));
+	 *  if (stack == NULL) goto fail;
+	 *  root->tokenId = %startRule%;
+	 *  stack[top++] = root;
+	 *  while (top > 0) {
+	 *   node = stack[--top];
+	 *   type = (*pos < tokens->count ? tokens->items[*pos].type : -1);
+	 *   if (node->tokenId < 1000000000) {
+	 *    if (type != node->tokenId) goto fail;
+	 *    node->data = tokens->items[*pos].value;
+	 *    ++(*pos);
+	 *    continue;
+	 *   }
+	 *   production = %prefix%ll1_table[node->tokenId - 1000000000][type + 1];
+	 *   if (production < 0) goto fail;
+	 *   count = %prefix%ll1_offsets[production + 1] - %prefix%ll1_offsets[production];
+	 *   if (top + count > size) {
+	 *    size = 2 * (top + count);
+	 *    grown = (ast_node**) realloc(stack, size * sizeof(ast_node*));
+	 *    if (grown == NULL) goto fail;
+	 *    stack = grown;
+	 *   }
+	 *   last = &node->firstChild;
+	 *   for (i = 0; i < count; i++) {
+	 *    *last = ast_arena_new_node(&tokens->arena);
+	 *    (*last)->tokenId = %prefix%ll1_symbols[%prefix%ll1_offsets[production] + i];
+	 *    stack[top + count - 1 - i] = *last;
+	 *    last = &(*last)->nextSibling;
+	 *   }
+	 *   top += count;
+	 *  }
+	 *  free(stack);
+	 *  return root;
+	 * fail:
+	 *  free(stack);
+	 *  ast_arena_reset(&tokens->arena, mark);
+	 *  *pos = opos;
+	 *  return NULL;
+	 * }
+	 */
+	string LL1::compileParse()
+	{
+		stringstream s;
+		string p = language->prefix;
+		s << "ast_node* " << p << "parse(token_list* tokens, int* pos) {"								"\n"
+			 " int opos = *pos;"																		"\n"
+			 " int size = 64, top = 0;"																	"\n"
+			 " int type, production, count, i;"															"\n"
+			 " ast_mark mark = ast_arena_mark(&tokens->arena);"										"\n"
+			 " ast_node* root = ast_arena_new_node(&tokens->arena);"									"\n"
+			 " ast_node* node;"																			"\n"
+			 " ast_node** last;"																		"\n"
+			 " ast_node** grown;"																		"\n"
+			 " ast_node** stack = (ast_node**) malloc(size * sizeof(ast_node*));"						"\n"
+			 " if (stack == NULL) goto fail;"															"\n"
+			 " root->tokenId = " << language->startRule << ";"											"\n"
+			 " stack[top++] = root;"																	"\n"
+			 " while (top > 0) {"																		"\n"
+			 "  node = stack[--top];"																	"\n"
+			 "  type = (*pos < tokens->count ? tokens->items[*pos].type : -1);"							"\n"
+			 "  if (node->tokenId < 1000000000) {"														"\n"
+			 "   if (type != node->tokenId) goto fail;"													"\n"
+			 "   node->data = tokens->items[*pos].value;"												"\n"
+			 "   ++(*pos);"																				"\n"
+			 "   continue;"																				"\n"
+			 "  }"																						"\n"
+			 "  production = " << p << "ll1_table[node->tokenId - 1000000000][type + 1];"				"\n"
+			 "  if (production < 0) goto fail;"															"\n"
+			 "  count = " << p << "ll1_offsets[production + 1] - " << p << "ll1_offsets[production];"	"\n"
+			 "  if (top + count > size) {"																"\n"
+			 "   size = 2 * (top + count);"																"\n"
+			 "   grown = (ast_node**) realloc(stack, size * sizeof(ast_node*));"						"\n"
+			 "   if (grown == NULL) goto fail;"															"\n"
+			 "   stack = grown;"																		"\n"
+			 "  }"																						"\n"
+			 "  last = &node->firstChild;"																"\n"
+			 "  for (i = 0; i < count; i++) {"															"\n"
+			 "   *last = ast_arena_new_node(&tokens->arena);"											"\n"
+			 "   (*last)->tokenId = " << p << "ll1_symbols[" << p << "ll1_offsets[production] + i];"	"\n"
+			 "   stack[top + count - 1 - i] = *last;"													"\n"
+			 "   last = &(*last)->nextSibling;"															"\n"
+			 "  }"																						"\n"
+			 "  top += count;"																			"\n"
+			 " }"																						"\n"
+			 " free(stack);"																			"\n"
+			 " return root;"																			"\n"
+			 "fail:"																					"\n"
+			 " free(stack);"																			"\n"
+			 " ast_arena_reset(&tokens->arena, mark);"													"\n"
+			 " *pos = opos;"																			"\n"
+			 " return NULL;"																			"\n"
+			 "}"																						"\n\n";
+		return s.str();
+	}
+	
+}; /* namespace pgen */
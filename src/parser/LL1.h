@@ -0,0 +1,108 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-27
+ * \file
+ * This file contains the declaration of the LL1 class. This class is responsible for generating a table-driven LL(1)
+ * parser for a specified language. Instead of a recursive function for each rule, the parser uses a parse table that 
+ * maps each rule and token type to the alternative to expand, and an explicit stack that is allocated on the heap, so 
+ * that deeply nested inputs do not overflow the C stack.
+ */
+ 
+#ifndef LL1_H_
+#define LL1_H_
+
+namespace pgen { class LL1; }
+
+// STL
+#include <string>
+#include <vector>
+#include <set>
+// yaml-cpp
+#include <yaml-cpp/yaml.h>
+// pgen
+#include "IGrammar.h"
+#include "Language.h"
+
+using namespace std; 
+namespace pgen 
+{
+	
+	class LL1 
+	 : public IGrammar 
+	{
+	public:
+		/**
+		 * Name of the grammar type (parser type)
+		 */
+		static const string NAME;
+		
+		/**
+		 * Using the IGrammar constructor.
+		 */
+		using IGrammar::IGrammar;
+		
+		/**
+		 * Virtual destructor. Currently does nothing. However the base (IGrammar) constructor is called and frees all
+		 * rules.
+		 */
+		virtual ~LL1();
+		
+		/**
+		 * Adds a new grammar rule from a YAML node.
+		 * \param name the name of the rule
+		 * \param ruleNode the actual rule node.
+		 */
+		virtual void addRule(string &name, YAML::Node &ruleNode);
+		
+		/**
+		 * Generate C99 code that is able to parse the grammar.
+		 * \return the C99 code that is able to parse the grammar.
+		 */
+		virtual string compile();
+
+		/**
+		 * Generate the prototype of the parse function.
+		 * \return the C99 declarations of the functions that parse the grammar.
+		 */
+		virtual string declarations();
+
+		/**
+		 * Computes the parse table of the grammar. The alternative of a rule is chosen for the token types on its FIRST 
+		 * set and, when it can match an empty list of tokens, for the token types on the FOLLOW set of the rule (the 
+		 * end of the token list follows the starting rule). When more than one alternative can be chosen for the same
+		 * token type, the grammar is rejected, unless the language resolves the conflicts (see 
+		 * Language::resolveConflicts): then the conflict is reported on the standard error and the first alternative
+		 * is chosen.
+		 * \throws LanguageException if a rule is left-recursive or if there is a conflict that is not resolved.
+		 * \return the number of conflicts found.
+		 */
+		unsigned int analyzeTable();
+	private:
+		vector<vector<int>> table;	//< The alternative for each rule and token type (plus one), or -1.
+
+		/**
+		 * Computes the FOLLOW set of every rule, i.e. the token types that can follow the text matched by the rule. 
+		 * The end of the token list is the token type -1.
+		 * \param sets the vector to write the set of each rule to.
+		 */
+		void follow(vector<set<int>>& sets);
+		/**
+		 * \return the name of a symbol or "end of input" for -1.
+		 */
+		string symbolName(int symbol);
+		/**
+		 * Checks whether a rule can be expanded again without consuming any token, i.e. whether it can be reached from
+		 * itself through the first symbols of its alternatives (and the symbols after the ones that can match an 
+		 * empty list of tokens). The LL(1) parser would expand such a rule forever.
+		 * \param rule the index of the rule.
+		 * \return true if the rule is left-recursive.
+		 */
+		bool leftRecursive(unsigned int rule);
+		/**
+		 * \return the C99 code of the parse function, which parses the starting rule.
+		 */
+		string compileParse();
+	}; /* class LL1 */
+}; /* namespace pgen */
+ 
+#endif /* LL1_H_ */
@@ -14,6 +14,7 @@
 // pgen
 #include "LLStar.h"
 #include "LLStarRule.h"
+#include "OperatorRule.h"
  
 using namespace std;
 namespace pgen 
@@ -27,24 +28,116 @@ namespace pgen
 
 	void LLStar::addRule(string& name, YAML::Node &ruleNode) 
 	{
-		rules.push_back(new LLStarRule(language, name, ruleNode));
+		if (ruleNode.IsMap())
+		{
+			rules.push_back(new OperatorRule(language, name, ruleNode));
+		}
+		else
+		{
+			rules.push_back(new LLStarRule(language, name, ruleNode));
+		}
 	}
 
 	string LLStar::compile() 
+	{
+		stringstream s;
+		this->eliminateLeftRecursion();
+		this->analyze();
+		s << this->declarations();
+		for (auto rule: rules) 
+		{
+			s << rule->compile();
+		}
+		s << this->compileParse();
+		return s.str();
+	}
+
+	void LLStar::compile(vector<string>& units, unsigned int count)
+	{
+		unsigned int size = rules.size();
+		this->eliminateLeftRecursion();
+		this->analyze();
+		if (count > size) count = size;
+		if (count == 0) count = 1;
+		for (unsigned int unit = 0, first = 0; unit < count; unit++)
+		{
+			stringstream s;
+			unsigned int last = (size * (unit + 1)) / count;
+			if (unit == 0)
+			{
+				s << this->compileParse();
+			}
+			for (; first < last; first++)
+			{
+				s << rules[first]->compile();
+			}
+			units.push_back(s.str());
+		}
+	}
+
+	string LLStar::declarations()
 	{
 		stringstream s;
 		for (auto rule: rules)
 		{
 			s << rule->prototype() << ";\n";
 		}
-		for (auto rule: rules) 
+		s << "ast_node* " << language->prefix << "parse(token_list* tokens, int* pos);"		"\n";
+		if (language->packrat && !reentered().empty())
 		{
-			s << rule->compile();
+			s << "typedef struct _" << language->prefix << "memo {"							"\n"
+				 " int end;"																	"\n"
+				 " ast_node* node;"															"\n"
+				 "} " << language->prefix << "memo;"											"\n"
+				 "extern " << language->prefix << "memo* " << language->prefix << "memo_table[" << reentered().size() << "];\n"
+				 "extern ast_arena " << language->prefix << "memo_arena;"						"\n";
+		}
+		return s.str();
+	}
+
+	/**
+	 * With the packrat mode, the memo tables of the re-entered rules (see LLStarRule::compile()) are allocated by the 
+	 * rules and freed after parsing, along with the arena of the memoized subtrees.
+	 * compiled code:
+	 * %prefix%memo* %prefix%memo_table[%reentered().size()%];
+	 * ast_arena %prefix%memo_arena;
+	 * ast_node* %prefix%parse(token_list* tokens, int* pos) {
+	 *  int i;
+	 *  ast_node* ast = %start rule funcname()%(tokens, pos);
+	 *  for (i = 0; i < %reentered().size()%; i++) {
+	 *   if (%prefix%memo_table[i] == NULL) continue;
+	 *   free(%prefix%memo_table[i]);
+	 *   %prefix%memo_table[i] = NULL;
+	 *  }
+	 *  ast_arena_free(&%prefix%memo_arena);
+	 *  return ast;
+	 * }
+	 */
+	string LLStar::compileParse()
+	{
+		stringstream s;
+		string start = rules[language->startRule-1000000000]->funcname();
+		if (!language->packrat || reentered().empty())
+		{
+			s << "ast_node* " << language->prefix << "parse(token_list* tokens, int* pos) {"	"\n"
+				 " return " << start << "(tokens, pos);"										"\n"
+				 "}"																			"\n\n";
+			return s.str();
 		}
-		s <<
-			"ast_node* " << language->prefix << "parse(token_list* tokens, int* pos) {"		"\n"
-			" return ast_invert_siblings(" << rules[language->startRule-1000000000]->funcname() << "(tokens, pos), NULL);\n"
-			"}"																				"\n\n";
+		string table = language->prefix + "memo_table";
+		s << language->prefix << "memo* " << table << "[" << reentered().size() << "];"		"\n"
+			 "ast_arena " << language->prefix << "memo_arena;"									"\n"
+			 "ast_node* " << language->prefix << "parse(token_list* tokens, int* pos) {"		"\n"
+			 " int i;"																		"\n"
+			 " ast_node* ast = " << start << "(tokens, pos);"									"\n"
+			 " for (i = 0; i < " << reentered().size() << "; i++) {"							"\n"
+			 "  if (" << table << "[i] == NULL) continue;"									"\n"
+			 "  free(" << table << "[i]);"													"\n"
+			 "  " << table << "[i] = NULL;"													"\n"
+			 " }"																			"\n"
+			 " ast_arena_free(&" << language->prefix << "memo_arena);"						"\n"
+			 " return ast;"																	"\n"
+			 "}"																			"\n\n";
 		return s.str();
 	}
 	
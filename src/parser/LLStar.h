@@ -46,7 +46,8 @@ namespace pgen
 		virtual ~LLStar();
 		
 		/**
-		 * Adds a new grammar rule from a YAML node.
+		 * Adds a new grammar rule from a YAML node: a sequence of alternatives (see LLStarRule) or a map that declares
+		 * operators (see OperatorRule).
 		 * \param name the name of the rule
 		 * \param ruleNode the actual rule node.
 		 */
@@ -57,6 +58,25 @@ namespace pgen
 		 * \return the C99 code that is able to parse the grammar.
 		 */
 		virtual string compile();
+
+		/**
+		 * Generate C99 code that is able to parse the grammar, split into multiple translation units. The rules are
+		 * distributed in contiguous groups among the units, the first unit also contains the parse function.
+		 * \param units the vector to add the code of each translation unit to.
+		 * \param count the maximum number of translation units to split the grammar into.
+		 */
+		virtual void compile(vector<string>& units, unsigned int count);
+
+		/**
+		 * Generate the prototypes of the functions that parse the rules and of the parse function.
+		 * \return the C99 declarations of the functions that parse the grammar.
+		 */
+		virtual string declarations();
+	private:
+		/**
+		 * \return the C99 code of the parse function, which parses the starting rule.
+		 */
+		string compileParse();
 	}; /* class LLStar */
 }; /* namespace pgen */
  
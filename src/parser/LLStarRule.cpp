@@ -9,10 +9,12 @@
 // STL
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 // pgen
 #include "../misc/Util.h"
 #include "../misc/LanguageException.h"
 #include "LLStarRule.h"
+#include "IGrammar.h"
  
 using namespace std;
 namespace pgen 
@@ -22,47 +24,544 @@ namespace pgen
 	{
 	}
 
+	/**
+	 * The alternatives that can not start with the current token are skipped: they are not viable when the token is
+	 * not on their FIRST set (see IGrammar::first()), unless they can match an empty list of tokens. A switch on the 
+	 * type of the current token jumps to the first viable alternative, and the failure of an alternative jumps to the 
+	 * next alternative that is viable for the same token, so the rules whose FIRST sets do not overlap never 
+	 * backtrack. An alternative that starts with a token can not match an empty list of tokens, so it is only reached
+	 * when the current token has that type, which is not checked again. The end of the token list has the type -1, 
+	 * which only the empty alternatives can match.
+	 * The loops of a left-recursive rule (see IGrammar::eliminateLeftRecursion()) are tried after an alternative
+	 * matches, until none of them matches. Each loop that matches makes the subtree the first child of a new node of 
+	 * the rule, followed by the nodes of the loop. The children that belong to an inlined rule are then moved into a
+	 * node of that rule (see LLStarRule::wrap()).
+	 * The children are linked in order (see LLStarRule::link()), so the tree does not have to be inverted after 
+	 * parsing.
+	 * The nodes are allocated from the arena of the token list, which is reset to the mark taken after the node of
+	 * the rule when an alternative fails, and to the mark taken before it when the rule fails.
+	 * On the deferred mode (see Language::deferred), the alternatives only keep the positions of their tokens and the
+	 * subtrees of their rules (see LLStarRule::record()), and the nodes are built when the alternative (or a loop)
+	 * matches (see LLStarRule::build()), so the alternatives that fail do not allocate any node by themselves.
+	 * compiled code:
+	 * %prototype()% {
+	 *  int opos = *pos;
+	 *  int type = (*pos < tokens->count ? tokens->items[*pos].type : -1);
+	 *  ast_mark start = ast_arena_mark(&tokens->arena);
+	 *  ast_node* subtree = ast_arena_new_node(&tokens->arena);
+	 *  ast_mark mark = ast_arena_mark(&tokens->arena);
+	 *  ast_node* child = NULL; (when a token or a symbol that follows another one reads it)
+	 *  ast_node* tail;
+	 *  subtree->tokenId = %id%;
+	 *  %dispatch(first viable alternative of each token)%
+	 * %for (each alternative i)%
+	 * %funcname()%_alt%i%:
+	 *  %match each symbol, or goto %funcname()%_%i%%
+	 *  %wrap(the children of the inlined rules)%
+	 *  return subtree; (or goto %funcname()%_loop; when the rule has loops)
+	 * %funcname()%_%i%:
+	 *  *pos = opos;
+	 *  ast_arena_reset(&tokens->arena, mark);
+	 *  subtree->firstChild = NULL;
+	 *  %dispatch(next viable alternative of each token)%
+	 * %end for%
+	 * %funcname()%_fail:
+	 *  ast_arena_reset(&tokens->arena, start);
+	 *  return NULL;
+	 * %funcname()%_loop:
+	 *  opos = *pos;
+	 *  start = ast_arena_mark(&tokens->arena);
+	 *  tail = ast_arena_new_node(&tokens->arena);
+	 *  tail->tokenId = %id%;
+	 *  mark = ast_arena_mark(&tokens->arena);
+	 * %for (each loop i)%
+	 *  %match each symbol into tail, or goto %funcname()%_loop%i%%
+	 *  if (*pos == opos) goto %funcname()%_loop%i%; (when the loop can match an empty list of tokens)
+	 *  goto %funcname()%_nest; (or, when the loop has inlined rules:)
+	 *  ast_add_child(tail, subtree);
+	 *  subtree = tail;
+	 *  %wrap(the children of the inlined rules)%
+	 *  goto %funcname()%_loop;
+	 * %funcname()%_loop%i%:
+	 *  *pos = opos;
+	 *  ast_arena_reset(&tokens->arena, mark);
+	 *  tail->firstChild = NULL;
+	 * %end for%
+	 *  ast_arena_reset(&tokens->arena, start);
+	 *  return subtree;
+	 * %funcname()%_nest:
+	 *  ast_add_child(tail, subtree);
+	 *  subtree = tail;
+	 *  goto %funcname()%_loop;
+	 * }
+	 * The labels that are never jumped to are not written (nor the position and the mark when they are never restored),
+	 * and the loops are only written for left-recursive rules.
+	 */
 	string LLStarRule::compile() 
 	{
-		stringstream s;
 		string _funcName = this->funcname();
-		int alternativeNumber = 0;
-		s << this->prototype() << " {"																"\n"
-			 " int opos = *pos;"																	"\n"
-			 " ast_node* subtree = ast_new_node();"													"\n"
-			 " ast_node* child = NULL;"																"\n"
-			 " subtree->tokenId = " << language->getNonTerminalId(name) << ";"						"\n";
-		for (vector<int>* option: symbols)
+		int count = symbols.size();
+		// the viable alternatives for each token type, and for the other types
+		vector<set<int>> firsts(count);
+		vector<int> empty;
+		set<int> types;
+		for (int i = 0; i < count; i++)
 		{
-			for (unsigned int i = 0; i < option->size(); i++)
+			if (language->grammar->first(*symbols[i], firsts[i]))
 			{
-				int symbol = option->at(i);
-				if (symbol < 1000000000) {
-					s << " if (tokens->items[*pos].type != " << symbol << ") "						"\n"
-						 "  goto " << _funcName << "_" << alternativeNumber << ";\n"
-						 " child = ast_new_node();"													"\n"
-						 " child->tokenId = " << symbol << ";"										"\n"
-						 " child->data = tokens->items[*pos].value;"								"\n"
-						 " ast_add_child(subtree, child);"											"\n"
-						 " ++(*pos);"																"\n";
+				empty.push_back(i);
+			}
+			types.insert(firsts[i].begin(), firsts[i].end());
+		}
+		map<vector<int>, set<int>> viable;
+		for (int type: types)
+		{
+			vector<int> alternatives;
+			for (int i = 0; i < count; i++)
+			{
+				if (firsts[i].count(type) || find(empty.begin(), empty.end(), i) != empty.end())
+				{
+					alternatives.push_back(i);
+				}
+			}
+			viable[alternatives].insert(type);
+		}
+		// the alternative that follows each alternative of a list, or the failure
+		auto following = [count](const vector<int>& alternatives, int i) {
+			auto it = (i < 0 ? alternatives.begin() : upper_bound(alternatives.begin(), alternatives.end(), i));
+			return (it == alternatives.end() ? count : *it);
+		};
+		// the jumps to the alternatives
+		set<int> used;
+		stringstream body;
+		Targets targets;
+		for (auto& kv: viable)
+		{
+			targets[following(kv.first, -1)].insert(kv.second.begin(), kv.second.end());
+		}
+		dispatch(body, targets, following(empty, -1), 0, used);
+		bool deferred = language->deferred;
+		for (int i = 0; i < count; i++)
+		{
+			string fail = _funcName + "_" + to_string(i);
+			body << "@" << i << "\n";
+			size_t alternative = body.str().size();
+			if (deferred)
+			{
+				record(body, *symbols[i], fail, true);
+				body << " subtree = ast_arena_new_node(&tokens->arena);"							"\n"
+						" subtree->tokenId = " << language->getNonTerminalId(name) << ";"			"\n";
+				build(body, *symbols[i], "subtree");
+			}
+			else
+			{
+				match(body, *symbols[i], "subtree", fail, true);
+			}
+			wrap(body, *symbols[i], "subtree");
+			body << (loops.empty() ? " return subtree;" : " goto " + _funcName + "_loop;") << 		"\n";
+			if (body.str().find("goto " + fail + ";", alternative) == string::npos)
+			{
+				// an empty alternative (or a single token selected by the switch) can not fail, so the alternatives
+				// after it are never tried from here
+				continue;
+			}
+			body << fail << 																		":\n"
+					" *pos = opos;"																	"\n";
+			if (!deferred)
+			{
+				body << " ast_arena_reset(&tokens->arena, mark);"									"\n"
+						" subtree->firstChild = NULL;"												"\n";
+			}
+			else if (calls(*symbols[i]))
+			{
+				body << " ast_arena_reset(&tokens->arena, start);"									"\n";
+			}
+			// the next alternative of each token type that can reach this alternative
+			targets.clear();
+			bool other = find(empty.begin(), empty.end(), i) != empty.end();
+			int otherTarget = (other ? following(empty, i) : count);
+			for (auto& kv: viable)
+			{
+				if (find(kv.first.begin(), kv.first.end(), i) != kv.first.end())
+				{
+					targets[following(kv.first, i)].insert(kv.second.begin(), kv.second.end());
+				}
+			}
+			if (!other && !targets.empty())
+			{
+				otherTarget = targets.rbegin()->first;
+			}
+			dispatch(body, targets, otherTarget, i+1, used);
+		}
+		// writes the code with the labels that are used, memoizing the re-entered rules on the packrat mode
+		int memo = -1;
+		if (language->packrat)
+		{
+			const vector<int>& reentered = language->grammar->reentered();
+			auto it = find(reentered.begin(), reentered.end(), language->getNonTerminalId(name) - 1000000000);
+			memo = (it == reentered.end() ? -1 : it - reentered.begin());
+		}
+		stringstream s;
+		s << (memo < 0 ? this->prototype() : "static ast_node* " + _funcName + "_nomemo(token_list* tokens, int *pos)") 
+		  << " {"																					"\n";
+		// the position and the mark are only restored by the alternatives that can fail, and by the loops
+		bool restored = !loops.empty() || body.str().find(" *pos = opos;") != string::npos;
+		if (restored)
+		{
+			s << " int opos = *pos;"																"\n";
+		}
+		if (body.str().find("switch (type)") != string::npos)
+		{
+			s << " int type = (*pos < tokens->count ? tokens->items[*pos].type : -1);"				"\n";
+		}
+		// the positions of the matched tokens and the subtrees of the matched rules of an alternative or loop (on the 
+		// deferred mode), and whether the last child is read, i.e. by a token or by a symbol that follows another one
+		unsigned int size = 0;
+		bool terminals = false, references = false;
+		for (auto option: { &symbols, &loops })
+		{
+			for (vector<int>* symbolList: *option)
+			{
+				size = max(size, (unsigned int)symbolList->size());
+				references = references || calls(*symbolList);
+				terminals = terminals || any_of(symbolList->begin(), symbolList->end(), [](int symbol) { 
+					return symbol < 1000000000; 
+				});
+			}
+		}
+		bool children = terminals || size > 1 || (deferred && !loops.empty());
+		if (deferred)
+		{
+			// only the subtrees of the rules are released when an alternative (or a loop) fails
+			if (references)
+			{
+				s << " ast_mark start = ast_arena_mark(&tokens->arena);"							"\n";
+			}
+			s << " ast_node* subtree;"																"\n";
+			if (children)
+			{
+				s << " ast_node* child;"															"\n";
+			}
+			if (terminals)
+			{
+				s << " int at[" << size << "];"														"\n";
+			}
+			if (references)
+			{
+				s << " ast_node* sub[" << size << "];"												"\n";
+			}
+		}
+		else
+		{
+			s << " ast_mark start = ast_arena_mark(&tokens->arena);"								"\n"
+				 " ast_node* subtree = ast_arena_new_node(&tokens->arena);"							"\n";
+			if (restored)
+			{
+				s << " ast_mark mark = ast_arena_mark(&tokens->arena);"								"\n";
+			}
+			if (children)
+			{
+				s << " ast_node* child = NULL;"														"\n";
+			}
+			if (!loops.empty())
+			{
+				s << " ast_node* tail;"																"\n";
+			}
+			s << " subtree->tokenId = " << language->getNonTerminalId(name) << ";"					"\n";
+		}
+		string line;
+		while (getline(body, line))
+		{
+			if (!line.empty() && line[0] == '@')
+			{
+				if (used.count(stoi(line.substr(1))))
+				{
+					s << _funcName << "_alt" << line.substr(1) << ":"								"\n";
+				}
+				continue;
+			}
+			s << line << "\n";
+		}
+		if (used.count(count))
+		{
+			s << _funcName << "_fail:"																"\n";
+		}
+		if (!deferred)
+		{
+			s << " ast_arena_reset(&tokens->arena, start);"											"\n";
+		}
+		s << " return NULL;"																		"\n";
+		if (!loops.empty() && deferred)
+		{
+			s << _funcName << "_loop:"																"\n"
+				 " opos = *pos;"																	"\n";
+			if (references)
+			{
+				s << " start = ast_arena_mark(&tokens->arena);"									"\n";
+			}
+			for (unsigned int i = 0; i < loops.size(); i++)
+			{
+				string fail = _funcName + "_loop" + to_string(i);
+				set<int> types;
+				record(s, *loops[i], fail);
+				if (language->grammar->first(*loops[i], types))
+				{
+					s << " if (*pos == opos) goto " << fail << ";"									"\n";
+				}
+				s << " child = subtree;"															"\n"
+					 " subtree = ast_arena_new_node(&tokens->arena);"								"\n"
+					 " subtree->tokenId = " << language->getNonTerminalId(name) << ";"				"\n"
+					 " subtree->firstChild = child;"												"\n";
+				build(s, *loops[i], "");
+				wrap(s, *loops[i], "subtree");
+				s << " goto " << _funcName << "_loop;"												"\n"
+				  << fail << ":"																	"\n"
+					 " *pos = opos;"																"\n";
+				if (calls(*loops[i]))
+				{
+					s << " ast_arena_reset(&tokens->arena, start);"									"\n";
+				}
+			}
+			s << " return subtree;"																	"\n";
+		}
+		else if (!loops.empty())
+		{
+			s << _funcName << "_loop:"																"\n"
+				 " opos = *pos;"																	"\n"
+				 " start = ast_arena_mark(&tokens->arena);"										"\n"
+				 " tail = ast_arena_new_node(&tokens->arena);"										"\n"
+				 " tail->tokenId = " << language->getNonTerminalId(name) << ";"						"\n"
+				 " mark = ast_arena_mark(&tokens->arena);"											"\n";
+			bool nest = false;
+			for (unsigned int i = 0; i < loops.size(); i++)
+			{
+				string fail = _funcName + "_loop" + to_string(i);
+				set<int> types;
+				match(s, *loops[i], "tail", fail);
+				if (language->grammar->first(*loops[i], types))
+				{
+					s << " if (*pos == opos) goto " << fail << ";"									"\n";
+				}
+				if (inlined.count(loops[i]))
+				{
+					s << " ast_add_child(tail, subtree);"											"\n"
+						 " subtree = tail;"															"\n";
+					wrap(s, *loops[i], "subtree");
+					s << " goto " << _funcName << "_loop;"											"\n";
 				}
 				else
 				{
-					s << " if ((child = " << language->grammar->rules[symbol-1000000000]->funcname() << "(tokens, pos)) == NULL) \n"
-						 "  goto " << _funcName << "_" << alternativeNumber << ";"					"\n"
-						 " ast_add_child(subtree, child);"											"\n";
+					s << " goto " << _funcName << "_nest;"											"\n";
+					nest = true;
 				}
+				s << fail << ":"																	"\n"
+					 " *pos = opos;"																"\n"
+					 " ast_arena_reset(&tokens->arena, mark);"										"\n"
+					 " tail->firstChild = NULL;"													"\n";
+			}
+			s << " ast_arena_reset(&tokens->arena, start);"										"\n"
+				 " return subtree;"																	"\n";
+			if (nest)
+			{
+				s << _funcName << "_nest:"															"\n"
+					 " ast_add_child(tail, subtree);"												"\n"
+					 " subtree = tail;"																"\n"
+					 " goto " << _funcName << "_loop;"												"\n";
 			}
-			// TODO: remove the printf and put the code that must run when matched
-			s << " return subtree;"																	"\n" <<
-				 _funcName << "_" << alternativeNumber++ << 										":\n"
-				 " *pos = opos;"																	"\n"
-				 " ast_clear(subtree);"																"\n";
 		}
-		s << " free(subtree);"																		"\n"
-			 " return NULL;"																		"\n"
+		s << "}"																					"\n\n";
+		if (memo >= 0)
+		{
+			s << memoize(memo);
+		}
+		return s.str();
+	}
+
+	/**
+	 * The memo table of the rule has an entry for each position of the token list, which is allocated on the first
+	 * call. The entry keeps the end position of the match plus one (or -1 when the rule fails, or 0 when the rule was
+	 * not parsed on the position yet) and a copy of the subtree on the memo arena, since the nodes returned by the 
+	 * rules are released (see ast_arena_reset()) when the alternatives that use them fail.
+	 * compiled code:
+	 * %prototype()% {
+	 *  %prefix%memo* memo;
+	 *  ast_node* subtree;
+	 *  if (%prefix%memo_table[%index%] == NULL)
+	 *   %prefix%memo_table[%index%] = (%prefix%memo*) calloc(tokens->count + 1, sizeof(%prefix%memo));
+	 *  memo = &%prefix%memo_table[%index%][*pos];
+	 *  if (memo->end == 0) {
+	 *   subtree = %funcname()%_nomemo(tokens, pos);
+	 *   memo->end = (subtree == NULL ? -1 : *pos + 1);
+	 *   memo->node = ast_copy(&%prefix%memo_arena, subtree);
+	 *   return subtree;
+	 *  }
+	 *  if (memo->end < 0) return NULL;
+	 *  *pos = memo->end - 1;
+	 *  return ast_copy(&tokens->arena, memo->node);
+	 * }
+	 */
+	string LLStarRule::memoize(int index)
+	{
+		stringstream s;
+		string _funcName = this->funcname();
+		string type = language->prefix + "memo";
+		string table = language->prefix + "memo_table[" + to_string(index) + "]";
+		s << this->prototype() << " {"																"\n"
+			 " " << type << "* memo;"																"\n"
+			 " ast_node* subtree;"																	"\n"
+			 " if (" << table << " == NULL)"														"\n"
+			 "  " << table << " = (" << type << "*) calloc(tokens->count + 1, sizeof(" << type << "));\n"
+			 " memo = &" << table << "[*pos];"														"\n"
+			 " if (memo->end == 0) {"																"\n"
+			 "  subtree = " << _funcName << "_nomemo(tokens, pos);"									"\n"
+			 "  memo->end = (subtree == NULL ? -1 : *pos + 1);"										"\n"
+			 "  memo->node = ast_copy(&" << language->prefix << "memo_arena, subtree);"			"\n"
+			 "  return subtree;"																	"\n"
+			 " }"																					"\n"
+			 " if (memo->end < 0) return NULL;"														"\n"
+			 " *pos = memo->end - 1;"																"\n"
+			 " return ast_copy(&tokens->arena, memo->node);"										"\n"
 			 "}"																					"\n\n";
 		return s.str();
 	}
 
+	void LLStarRule::match(stringstream& s, const vector<int>& option, const string& parent, const string& fail, 
+		bool checked)
+	{
+		for (unsigned int j = 0; j < option.size(); j++)
+		{
+			int symbol = option[j];
+			if (symbol < 1000000000) {
+				if (j > 0 || !checked)
+				{
+					s << " if (tokens->items[*pos].type != " << symbol << ") "						"\n"
+						 "  goto " << fail << ";"													"\n";
+				}
+				s << " " << link(parent, j) << " = ast_arena_new_node(&tokens->arena);"				"\n"
+					 " child = " << link(parent, j) << ";"											"\n"
+					 " child->tokenId = " << symbol << ";"											"\n"
+					 " child->data = tokens->items[*pos].value;"									"\n"
+					 " ++(*pos);"																	"\n";
+			}
+			else
+			{
+				s << " if ((" << link(parent, j) << " = " << language->grammar->rules[symbol-1000000000]->funcname() << "(tokens, pos)) == NULL) \n"
+					 "  goto " << fail << ";"														"\n";
+				if (j + 1 < option.size())
+				{
+					s << " child = " << link(parent, j) << ";"										"\n";
+				}
+			}
+		}
+	}
+
+	void LLStarRule::record(stringstream& s, const vector<int>& option, const string& fail, bool checked)
+	{
+		for (unsigned int j = 0; j < option.size(); j++)
+		{
+			int symbol = option[j];
+			if (symbol < 1000000000) {
+				if (j > 0 || !checked)
+				{
+					s << " if (tokens->items[*pos].type != " << symbol << ") "						"\n"
+						 "  goto " << fail << ";"													"\n";
+				}
+				s << " at[" << j << "] = (*pos)++;"													"\n";
+			}
+			else
+			{
+				s << " if ((sub[" << j << "] = " << language->grammar->rules[symbol-1000000000]->funcname() << "(tokens, pos)) == NULL) \n"
+					 "  goto " << fail << ";"														"\n";
+			}
+		}
+	}
+
+	void LLStarRule::build(stringstream& s, const vector<int>& option, const string& parent)
+	{
+		for (unsigned int j = 0; j < option.size(); j++)
+		{
+			int symbol = option[j];
+			if (symbol < 1000000000) {
+				s << " " << link(parent, j) << " = ast_arena_new_node(&tokens->arena);"				"\n"
+					 " child = " << link(parent, j) << ";"											"\n"
+					 " child->tokenId = " << symbol << ";"											"\n"
+					 " child->data = tokens->items[at[" << j << "]].value;"							"\n";
+			}
+			else
+			{
+				s << " " << link(parent, j) << " = sub[" << j << "];"								"\n";
+				if (j + 1 < option.size())
+				{
+					s << " child = sub[" << j << "];"												"\n";
+				}
+			}
+		}
+	}
+
+	void LLStarRule::wrap(stringstream& s, const vector<int>& option, const string& parent)
+	{
+		auto it = inlined.find(&option);
+		if (it == inlined.end())
+		{
+			return;
+		}
+		// each node replaces its children, so the next one has one child for them
+		unsigned int inner = 1;
+		for (auto& node: it->second)
+		{
+			s << " ast_wrap(&tokens->arena, " << parent << ", " << node.first << ", " << (node.second - inner + 1) << 
+				");"																				"\n";
+			inner = node.second;
+		}
+	}
+
+	string LLStarRule::link(const string& parent, unsigned int index)
+	{
+		return (index == 0 && !parent.empty() ? parent + "->firstChild" : "child->nextSibling");
+	}
+
+	bool LLStarRule::calls(const vector<int>& option)
+	{
+		return any_of(option.begin(), option.end(), [](int symbol) { return symbol >= 1000000000; });
+	}
+
+	void LLStarRule::dispatch(stringstream& s, const Targets& targets, int other, int next, set<int>& used)
+	{
+		string _funcName = this->funcname();
+		int count = symbols.size();
+		auto label = [&](int target) {
+			used.insert(target);
+			return (target == count ? _funcName + "_fail" : _funcName + "_alt" + to_string(target));
+		};
+		bool same = true;
+		for (auto& kv: targets)
+		{
+			same = same && kv.first == other;
+		}
+		if (same)
+		{
+			if (other != next)
+			{
+				s << " goto " << label(other) << ";"												"\n";
+			}
+			return;
+		}
+		s << " switch (type) {"																		"\n";
+		for (auto& kv: targets)
+		{
+			if (kv.first == other)
+			{
+				continue;
+			}
+			for (int type: kv.second)
+			{
+				s << "  case " << type << ":"														"\n";
+			}
+			s << "   goto " << label(kv.first) << ";"												"\n";
+		}
+		s << "  default:"																			"\n"
+			 "   goto " << label(other) << ";"														"\n"
+			 " }"																					"\n";
+	}
+
 }; /* namespace pgen */
\ No newline at end of file
@@ -14,6 +14,8 @@
  // STL
  #include <string>
  #include <vector>
+ #include <map>
+ #include <set>
  // pgen
  #include "IGrammarRule.h"
  #include "Language.h"
@@ -25,6 +27,84 @@
 	class LLStarRule 
 	 : public IGrammarRule 
 	{
+	private:
+		/**
+		 * The alternatives to try for each token type, mapped to the token types. Each target is the index of an 
+		 * alternative, or the number of alternatives when the rule must fail.
+		 */
+		typedef map<int, set<int>> Targets;
+
+		/**
+		 * Writes a jump to the alternative to try for the current token type (the variable "type").
+		 * \param s the stringstream to write to.
+		 * \param targets the token types of each alternative to jump to.
+		 * \param other the alternative to jump to for the other token types.
+		 * \param next the alternative that follows the code, which is reached without a jump.
+		 * \param used the set to add the indexes of the alternatives that are jumped to.
+		 */
+		void dispatch(stringstream& s, const Targets& targets, int other, int next, set<int>& used);
+
+		/**
+		 * Writes the code that matches a sequence of symbols, adding a child to a node for each symbol. The children
+		 * are added in order, the variable "child" keeping the last one (the node of a rule is only kept there when
+		 * another symbol follows it).
+		 * \param s the stringstream to write to.
+		 * \param option the symbols to match.
+		 * \param parent the variable of the node to add the children to (see LLStarRule::link()).
+		 * \param fail the label to jump to when a symbol does not match.
+		 * \param checked true when the type of the first token was already checked by the switch on the type.
+		 */
+		void match(stringstream& s, const vector<int>& option, const string& parent, const string& fail, 
+			bool checked = false);
+
+		/**
+		 * Writes the code that matches a sequence of symbols without building the nodes (on the deferred mode): the
+		 * position of each token is kept on the array "at" and the subtree of each rule on the array "sub", indexed
+		 * by the position of the symbol on the sequence.
+		 * \param s the stringstream to write to.
+		 * \param option the symbols to match.
+		 * \param fail the label to jump to when a symbol does not match.
+		 * \param checked true when the type of the first token was already checked by the switch on the type.
+		 */
+		void record(stringstream& s, const vector<int>& option, const string& fail, bool checked = false);
+
+		/**
+		 * Writes the code that adds the nodes of a sequence of symbols recorded by LLStarRule::record() to a node.
+		 * \param s the stringstream to write to.
+		 * \param option the matched symbols.
+		 * \param parent the variable of the node to add the children to (see LLStarRule::link()).
+		 */
+		void build(stringstream& s, const vector<int>& option, const string& parent);
+
+		/**
+		 * Writes the code that moves the children of a node that belong to the rules inlined at the start of a 
+		 * sequence of symbols (see IGrammarRule::inlined) into the nodes of those rules.
+		 * \param s the stringstream to write to.
+		 * \param option the matched symbols.
+		 * \param parent the variable of the node that has the children of the sequence.
+		 */
+		void wrap(stringstream& s, const vector<int>& option, const string& parent);
+
+		/**
+		 * \return the pointer that the node of a symbol is linked to: the first child of the parent for the first 
+		 * symbol of a sequence, or the next sibling of the previous child (the variable "child") for the others.
+		 * \param parent the variable of the parent node, or an empty string when the parent already has children.
+		 * \param index the position of the symbol on the sequence.
+		 */
+		static string link(const string& parent, unsigned int index);
+
+		/**
+		 * \return true when a sequence of symbols references any rule.
+		 * \param option the symbols.
+		 */
+		static bool calls(const vector<int>& option);
+
+		/**
+		 * Generates the function that looks up the result of the rule on its memo table before parsing it.
+		 * \param index the index of the memo table of the rule.
+		 * \return the C99 code of the function.
+		 */
+		string memoize(int index);
 	public:
 		/**
 		 * Using IGrammarRule's constructors.
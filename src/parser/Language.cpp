@@ -37,6 +37,8 @@
 #include "../expr/Code.h"
 #include "Language.h"
 #include "LLStar.h"
+#include "LL1.h"
+#include "LALR1.h"
 #include "../misc/LanguageException.h"
 
 // DEFINITIONS
@@ -51,7 +53,7 @@ namespace pgen
 	 * Language default constructor. Currently only initializes the tokenizer object.
 	 */
 	Language::Language()
-	 : tokenizer(this)
+	 : packrat(false), deferred(false), flat(false), linear(false), resolveConflicts(false), tokenizer(this)
 	{
 	}
 
@@ -109,6 +111,21 @@ namespace pgen
 		// language.type (name)
 		node = languageNode["type"];
 		this->languageType = (node? node.as<string>() : "LL(*)");
+		// language.packrat (memoization of the rules)
+		node = languageNode["packrat"];
+		this->packrat = (node ? node.as<bool>() : false);
+		// language.deferred (construction of the nodes after the alternatives match)
+		node = languageNode["deferred"];
+		this->deferred = (node ? node.as<bool>() : false);
+		// language.flat (conversion of the AST returned by the parse functions to an array)
+		node = languageNode["flat"];
+		this->flat = (node ? node.as<bool>() : false);
+		// language.linear (automaton engines for the tokens that may backtrack catastrophically)
+		node = languageNode["linear"];
+		this->linear = (node ? node.as<bool>() : false);
+		// language.resolveConflicts (choice of the first alternative on the LL(1) conflicts)
+		node = languageNode["resolveConflicts"];
+		this->resolveConflicts = (node ? node.as<bool>() : false);
 	}
 	
 	/**
@@ -188,7 +205,9 @@ namespace pgen
 				{
 					setStateId = getStateId(node.as<string>());
 				}
-				tokenizer.add(tokenRegex, tokenName, setStateId, validStatesArray);
+				node = token["ignore_case"];						// token.ignore_case
+				bool ignoreCase = (node ? node.as<bool>() : false);
+				tokenizer.add(tokenRegex, tokenName, setStateId, validStatesArray, ignoreCase);
 			}
 		}
 	}
@@ -213,7 +232,7 @@ namespace pgen
 			{
 				auto &key = it->first;
 				auto &ruleNode = it->second;
-				if (key.IsScalar() && ruleNode.IsSequence()) 
+				if (key.IsScalar() && (ruleNode.IsSequence() || ruleNode.IsMap())) 
 				{
 					string ruleName = key.as<string>();
 					this->ruleList.push_back(ruleName);
@@ -243,8 +262,12 @@ namespace pgen
 		loadTokensNode(spec["tokens"]);
 		loadGrammarNode(spec["grammar"], ruleNodes);
 		
-		if (languageType == "LL(*)") {
+		if (languageType == LLStar::NAME) {
 			grammar = new LLStar(this);
+		} else if (languageType == LL1::NAME) {
+			grammar = new LL1(this);
+		} else if (languageType == LALR1::NAME) {
+			grammar = new LALR1(this);
 		} else {
 			throw LanguageException("Invalid language type '" + languageType + "'.");
 		}
@@ -381,21 +404,58 @@ namespace pgen
 	void Language::compile(ostream& s) 
 	{
 		s << endl << "//-------------------------------------" << endl;
-		s << tokenizer.code();
+		this->compileLexer(s);
 		s << endl << "//-------------------------------------" << endl;
 		s << grammar->compile() << endl;
 		this->compileParseHelpers(s);
 	}
 	
+	/**
+	 * writes the compiled C99 code of the tokenizer.
+	 */
+	void Language::compileLexer(ostream& s)
+	{
+		s << tokenizer.code();
+	}
+	
+	/**
+	 * compiles the grammar into multiple translation units.
+	 */
+	void Language::compileParser(vector<string>& units, unsigned int count)
+	{
+		grammar->compile(units, count);
+	}
+	
+	/**
+	 * writes the internal C99 header shared by the translation units of the generated code.
+	 */
+	void Language::compileInternalHeader(ostream& s, const string& headerFileName, const string& code)
+	{
+		s << "#ifndef __" << this->prefix << "_INTERNAL_H"								"\n"
+			 "#define __" << this->prefix << "_INTERNAL_H"								"\n\n"
+			 "#include \"" << headerFileName << "\""										"\n\n"
+		  << Code::getInternal(code) << 												"\n"
+		  << tokenizer.declarations()
+		  << grammar->declarations() << 												"\n"
+			 "#endif /* __" << this->prefix << "_INTERNAL_H */"							"\n";
+	}
+	
 	/**
 	 * \brief 
 	 * @param s
 	 */
 	void Language::compileParseHelpers(ostream& s)
 	{
+		string flatten;
+		if (flat)
+		{
+			flatten = " pr->flat = ast_flatten(pr->ast, 0, &pr->flat_count);"								"\n"
+					  " pr->ast = NULL;"																	"\n"
+					  " ast_arena_free(&pr->tokens->arena);"												"\n";
+		}
 		s << "parse_result* " << prefix << "parse_string(char* text) {"										"\n"
 			 " int i;"																						"\n"
-			 " parse_result* pr = (parse_result*) malloc(sizeof(parse_result));"							"\n"
+			 " parse_result* pr = parse_result_new();"														"\n"
 			 " pr->tokens = " << prefix << "tokenize_string(text);"											"\n"
 			 " if (pr->tokens == NULL) {"																	"\n"
 			 "  printf(\"Invalid Input at position %d, '%s'\\n\", " << prefix << "inv_token_pos, " << prefix << "inv_token_txt);\n"
@@ -404,11 +464,12 @@ namespace pgen
 			 " }"																							"\n"
 			 " i = 0;"																						"\n"
 			 " pr->ast = " << prefix << "parse(pr->tokens, &i);"											"\n"
+		  << flatten <<
 			 " return pr;"																					"\n"
 			 "}"																							"\n\n"
 			 "parse_result* " << prefix << "parse_file(char* fileName) {"									"\n"
 			 " int i;"																						"\n"
-			 " parse_result* pr = (parse_result*) malloc(sizeof(parse_result));"							"\n"
+			 " parse_result* pr = parse_result_new();"														"\n"
 			 " pr->tokens = " << prefix << "tokenize_file(fileName);"										"\n"
 			 " if (pr->tokens == NULL) {"																	"\n"
 			 "  printf(\"Invalid Input at position %d, '%s'\\n\", " << prefix << "inv_token_pos, " << prefix << "inv_token_txt);\n"
@@ -417,6 +478,7 @@ namespace pgen
 			 " }"																							"\n"
 			 " i = 0;"																						"\n"
 			 " pr->ast = " << prefix << "parse(pr->tokens, &i);"											"\n"
+		  << flatten <<
 			 " return pr;"																					"\n"
 			 "}"																							"\n\n";
 	}
@@ -442,6 +504,14 @@ namespace pgen
 				s << "#define " << this->prefix << it->first << " " << it->second->typeId<<"\n";
 			}
 		}
+		for (auto it = tokenizer.typeList.begin(); it != tokenizer.typeList.end(); ++it) 
+		{
+			if (!it->second->discard)
+			{
+				s << "int " << tokenizer.fnNameFind(it->second) << "(char* buf, int len, token_match* match);"	"\n"
+					 "int " << tokenizer.fnNameFind(it->second) << "_from(char* text, int len, int start, token_match* match);\n";
+			}
+		}
 		s << "#endif /* __" << this->prefix << "_H */"									"\n";
 	}
 	
@@ -65,6 +65,13 @@ namespace pgen
 		string startStateName;		//< The name of the initial state
 		string startRuleName;		//< The name of the starting rule
 		string languageType;		//< The name of the language type
+		bool packrat;				//< True to memoize the results of the re-entered rules (see IGrammar::reentered())
+		bool deferred;				//< True to build the nodes of the LL(*) rules only when an alternative matches
+		bool flat;					//< True to convert the AST to an array of nodes after parsing (see ast_flatten)
+		bool linear;				//< True to match the tokens that may backtrack catastrophically with an automaton
+									//< instead of the backtracking code (see TokenType)
+		bool resolveConflicts;		//< True to resolve the LL(1) conflicts in favor of the first alternative instead
+									//< of rejecting the grammar (see LL1::analyzeTable())
 		set<string> stateList;		//< The list of states
 		vector<string> ruleList;	//< The list of rules
 		int startState;				//< The initial state
@@ -177,7 +184,31 @@ namespace pgen
 		void compile(ostream& s);
 		
 		/**
-		 * writes the code for the parse_string and parse_file helpers.
+		 * writes the compiled C99 code of the tokenizer (lexer) to a stream.
+		 * \param s the stream to write to.
+		 */
+		void compileLexer(ostream& s);
+		
+		/**
+		 * compiles the grammar into multiple translation units (see IGrammar::compile(vector<string>&, unsigned int)).
+		 * \param units the vector to add the code of each translation unit to.
+		 * \param count the maximum number of translation units to split the grammar into.
+		 */
+		void compileParser(vector<string>& units, unsigned int count);
+		
+		/**
+		 * writes the internal C99 header, which is shared by all the translation units when the generated code is split
+		 * into multiple files. It contains the declarations of the helper code, of the tokenizer and of the grammar.
+		 * \param s the stream to write to.
+		 * \param headerFileName the name of the public header (see Language::compileHeader()) to include.
+		 * \param code the generated code of all the translation units, which selects the helpers that are declared
+		 * (see Code::getInternal(const string&)).
+		 */
+		void compileInternalHeader(ostream& s, const string& headerFileName, const string& code);
+		
+		/**
+		 * writes the code for the parse_string and parse_file helpers. When the language is flat, the helpers convert
+		 * the AST built by the parser to an array of nodes once the parse succeeds (see ast_flatten).
 		 * @param s the stream to write to.
 		 */
 		void compileParseHelpers(ostream& s);
@@ -31,6 +31,7 @@
 // pgen
 #include "../expr/CharClass.h"
 #include "../misc/LanguageException.h"
+#include "../misc/UnicodeData.h"
 #include "NamedClassManager.h"
 
 using namespace std;
@@ -87,7 +88,15 @@ namespace pgen
 		auto it = namedClasses.find(name);
 		if (it == namedClasses.end())
 		{
-			throw LanguageException("Error while trying to retrieve the named class '" + name + "'.");
+			// classes that were not declared may be Unicode properties (e.g. [:Greek:] or [:Lu:]).
+			IntervalSet set;
+			if (!UnicodeData::get(name, set))
+			{
+				throw LanguageException("Error while trying to retrieve the named class '" + name + "'.");
+			}
+			CharClass* cClass = new CharClass();
+			cClass->add(set);
+			it = namedClasses.insert(make_pair(name, cClass)).first;
 		}
 		return *((CharClass*)it->second);
 	}
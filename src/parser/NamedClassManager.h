@@ -68,7 +68,9 @@ namespace pgen
 		void add(string name, string regex);
 		
 		/**
-		 * Returns a const CharClass reference to a previously added charclass.
+		 * Returns a const CharClass reference to a previously added charclass. If there is no class with the given 
+		 * name, but it is the name of a Unicode property (see UnicodeData), a class with the characters of the 
+		 * property is added and returned.
 		 * @param name the name of the class to read
 		 * @return a const reference to the CharClass object.
 		 */
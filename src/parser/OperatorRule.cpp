@@ -0,0 +1,265 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-29
+ * \file
+ * This file contains the implementation of the OperatorRule class. This class handles a LL(*) grammar rule that is 
+ * defined by operators instead of alternatives (see OperatorRule.h).
+ */
+
+// STL
+#include <sstream>
+#include <set>
+// pgen
+#include "../misc/LanguageException.h"
+#include "OperatorRule.h"
+#include "IGrammar.h"
+ 
+using namespace std;
+namespace pgen 
+{
+	OperatorRule::OperatorRule(Language* language, string& name, YAML::Node& ruleNode)
+	 : IGrammarRule(language, name)
+	{
+		YAML::Node node = ruleNode["operand"];
+		if (!node)
+		{
+			throw LanguageException("Expected the 'operand' of the operator rule '" + name + "'.");
+		}
+		operand = language->getSymbolId(node.as<string>());
+		if (operand == -1)
+		{
+			throw LanguageException("Unrecognized symbol: " + node.as<string>());
+		}
+		node = ruleNode["operators"];
+		if (!node || !node.IsSequence())
+		{
+			throw LanguageException("Expected a Sequence of operator levels for rule '" + name + "'.");
+		}
+		set<int> binary, prefix;
+		for (int i = 0, sz = node.size(); i < sz; i++)
+		{
+			YAML::Node levelNode = node[i];
+			if (!levelNode.IsMap() || levelNode.size() != 1)
+			{
+				throw LanguageException("Expected a single associativity (left, right or prefix) on each operator "
+					"level of rule '" + name + "'.");
+			}
+			string associativity = levelNode.begin()->first.as<string>();
+			YAML::Node operators = levelNode.begin()->second;
+			pair<Associativity, vector<int>> level;
+			if (associativity == "left")
+			{
+				level.first = LEFT;
+			}
+			else if (associativity == "right")
+			{
+				level.first = RIGHT;
+			}
+			else if (associativity == "prefix")
+			{
+				level.first = PREFIX;
+			}
+			else
+			{
+				throw LanguageException("Invalid associativity '" + associativity + "' on rule '" + name + "'.");
+			}
+			for (int j = 0, count = operators.size(); j < count; j++)
+			{
+				string token = operators[j].as<string>();
+				int symbol = language->getTerminalId(token);
+				if (symbol == -1)
+				{
+					throw LanguageException("Unrecognized token: " + token);
+				}
+				if (!(level.first == PREFIX ? prefix : binary).insert(symbol).second)
+				{
+					throw LanguageException("The operator " + token + " is declared twice on rule '" + name + "'.");
+				}
+				level.second.push_back(symbol);
+			}
+			levels.push_back(level);
+		}
+		// the equivalent alternatives
+		int self = language->getNonTerminalId(name);
+		symbols.push_back(new vector<int>(1, operand));
+		for (auto& level: levels)
+		{
+			for (int symbol: level.second)
+			{
+				symbols.push_back(level.first == PREFIX ? new vector<int>({ symbol, self }) : 
+					new vector<int>({ self, symbol, self }));
+			}
+		}
+	}
+
+	OperatorRule::~OperatorRule()
+	{
+	}
+
+	void OperatorRule::switchLevel(stringstream& s, bool binary)
+	{
+		s << " switch (type) {"																		"\n";
+		for (unsigned int i = 0; i < levels.size(); i++)
+		{
+			if ((levels[i].first == PREFIX) == binary)
+			{
+				continue;
+			}
+			for (int symbol: levels[i].second)
+			{
+				s << "  case " << symbol << ":"														"\n";
+			}
+			s << "   level = " << (i+1) << ";"														"\n"
+				 "   next = " << (levels[i].first == LEFT ? i+2 : i+1) << ";"						"\n"
+				 "   break;"																		"\n";
+		}
+		s << "  default:"																			"\n"
+			 "   level = -1;"																		"\n"
+			 "   next = -1;"																		"\n"
+			 " }"																					"\n";
+	}
+
+	/**
+	 * Each operation is a node of the rule with the operator token and the operands as its children, e.g. "1 + 2 * 3"
+	 * is parsed as expression(number ADD expression(number MUL number)). An operand without operators is the only 
+	 * child of a node of the rule. When the right operand of an operator can not be parsed, the operator is not
+	 * consumed, like on the alternatives of the LL(*) rules.
+	 * compiled code:
+	 * static ast_node* %funcname()%_level(token_list* tokens, int* pos, int min) {
+	 *  int opos;
+	 *  int level, next;
+	 *  int type = (*pos < tokens->count ? tokens->items[*pos].type : -1);
+	 *  ast_node* left = NULL;
+	 *  ast_node* right;
+	 *  ast_node* node;
+	 *  %switchLevel(prefix operators)%
+	 *  if (level >= 0) {
+	 *   opos = (*pos)++;
+	 *   right = %funcname()%_level(tokens, pos, next);
+	 *   if (right == NULL) {
+	 *    *pos = opos;
+	 *   } else {
+	 *    left = ast_arena_new_node(&tokens->arena);
+	 *    left->tokenId = %id%;
+	 *    node = ast_arena_new_node(&tokens->arena);
+	 *    node->tokenId = type;
+	 *    node->data = tokens->items[opos].value;
+	 *    node->nextSibling = right;
+	 *    left->firstChild = node;
+	 *   }
+	 *  }
+	 *  %parse the operand if left == NULL, or return NULL%
+	 *  for (;;) {
+	 *   type = (*pos < tokens->count ? tokens->items[*pos].type : -1);
+	 *   %switchLevel(binary operators)%
+	 *   if (level < min) return left;
+	 *   opos = (*pos)++;
+	 *   right = %funcname()%_level(tokens, pos, next);
+	 *   if (right == NULL) {
+	 *    *pos = opos;
+	 *    return left;
+	 *   }
+	 *   node = ast_arena_new_node(&tokens->arena);
+	 *   node->tokenId = %id%;
+	 *   node->firstChild = left;
+	 *   left->nextSibling = ast_arena_new_node(&tokens->arena);
+	 *   left = left->nextSibling;
+	 *   left->tokenId = type;
+	 *   left->data = tokens->items[opos].value;
+	 *   left->nextSibling = right;
+	 *   left = node;
+	 *  }
+	 * }
+	 *
+	 * %prototype()% {
+	 *  ast_node* subtree = %funcname()%_level(tokens, pos, 1);
+	 *  ast_node* node;
+	 *  if (subtree == NULL || subtree->tokenId == %id%) return subtree;
+	 *  node = ast_arena_new_node(&tokens->arena);
+	 *  node->tokenId = %id%;
+	 *  ast_add_child(node, subtree);
+	 *  return node;
+	 * }
+	 */
+	string OperatorRule::compile()
+	{
+		stringstream s;
+		string _funcName = this->funcname();
+		int id = language->getNonTerminalId(name);
+		s << "static ast_node* " << _funcName << "_level(token_list* tokens, int* pos, int min) {"		"\n"
+			 " int opos;"																			"\n"
+			 " int level, next;"																	"\n"
+			 " int type = (*pos < tokens->count ? tokens->items[*pos].type : -1);"					"\n"
+			 " ast_node* left = NULL;"																"\n"
+			 " ast_node* right;"																	"\n"
+			 " ast_node* node;"																		"\n";
+		switchLevel(s, false);
+		s << " if (level >= 0) {"																	"\n"
+			 "  opos = (*pos)++;"																	"\n"
+			 "  right = " << _funcName << "_level(tokens, pos, next);"								"\n"
+			 "  if (right == NULL) {"																"\n"
+			 "   *pos = opos;"																		"\n"
+			 "  } else {"																			"\n"
+			 "   left = ast_arena_new_node(&tokens->arena);"										"\n"
+			 "   left->tokenId = " << id << ";"														"\n"
+			 "   node = ast_arena_new_node(&tokens->arena);"										"\n"
+			 "   node->tokenId = type;"																"\n"
+			 "   node->data = tokens->items[opos].value;"											"\n"
+			 "   node->nextSibling = right;"														"\n"
+			 "   left->firstChild = node;"															"\n"
+			 "  }"																					"\n"
+			 " }"																					"\n";
+		if (operand >= 1000000000)
+		{
+			s << " if (left == NULL && (left = " << language->grammar->rules[operand-1000000000]->funcname() << 
+				 "(tokens, pos)) == NULL) return NULL;"												"\n";
+		}
+		else
+		{
+			s << " if (left == NULL) {"																"\n"
+				 "  if (type != " << operand << ") return NULL;"									"\n"
+				 "  left = ast_arena_new_node(&tokens->arena);"										"\n"
+				 "  left->tokenId = " << operand << ";"												"\n"
+				 "  left->data = tokens->items[(*pos)++].value;"									"\n"
+				 " }"																				"\n";
+		}
+		s << " for (;;) {"																			"\n"
+			 "  type = (*pos < tokens->count ? tokens->items[*pos].type : -1);"						"\n";
+		stringstream level;
+		switchLevel(level, true);
+		string line;
+		while (getline(level, line))
+		{
+			s << " " << line << "\n";
+		}
+		s << "  if (level < min) return left;"														"\n"
+			 "  opos = (*pos)++;"																	"\n"
+			 "  right = " << _funcName << "_level(tokens, pos, next);"								"\n"
+			 "  if (right == NULL) {"																"\n"
+			 "   *pos = opos;"																		"\n"
+			 "   return left;"																		"\n"
+			 "  }"																					"\n"
+			 "  node = ast_arena_new_node(&tokens->arena);"											"\n"
+			 "  node->tokenId = " << id << ";"														"\n"
+			 "  node->firstChild = left;"															"\n"
+			 "  left->nextSibling = ast_arena_new_node(&tokens->arena);"							"\n"
+			 "  left = left->nextSibling;"															"\n"
+			 "  left->tokenId = type;"																"\n"
+			 "  left->data = tokens->items[opos].value;"											"\n"
+			 "  left->nextSibling = right;"															"\n"
+			 "  left = node;"																		"\n"
+			 " }"																					"\n"
+			 "}"																					"\n\n"
+		  << this->prototype() << " {"																"\n"
+			 " ast_node* subtree = " << _funcName << "_level(tokens, pos, 1);"						"\n"
+			 " ast_node* node;"																		"\n"
+			 " if (subtree == NULL || subtree->tokenId == " << id << ") return subtree;"			"\n"
+			 " node = ast_arena_new_node(&tokens->arena);"											"\n"
+			 " node->tokenId = " << id << ";"														"\n"
+			 " ast_add_child(node, subtree);"														"\n"
+			 " return node;"																		"\n"
+			 "}"																					"\n\n";
+		return s.str();
+	}
+
+}; /* namespace pgen */
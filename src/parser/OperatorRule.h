@@ -0,0 +1,88 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-29
+ * \file
+ * This file contains the declaration of the OperatorRule class. This class handles a LL(*) grammar rule that is 
+ * defined by operators instead of alternatives, e.g.:
+ *   - expression:
+ *       operand: number
+ *       operators:          # from the lowest to the highest precedence
+ *         - left: [ADD, SUB]
+ *         - left: [MUL, DIV]
+ *         - right: [POW]
+ *         - prefix: [SUB]
+ * The rule is parsed by a precedence climbing loop instead of a chain of rules (one for each precedence level), so the
+ * recursion depth and the number of nodes depend on the expression and not on the number of levels.
+ */
+ 
+#ifndef OPERATORRULE_H_
+#define OPERATORRULE_H_
+
+namespace pgen { class OperatorRule; };
+
+// STL
+#include <string>
+#include <vector>
+#include <sstream>
+// yaml-cpp
+#include <yaml-cpp/yaml.h>
+// pgen
+#include "IGrammarRule.h"
+#include "Language.h"
+
+using namespace std;
+namespace pgen 
+{
+	
+	class OperatorRule 
+	 : public IGrammarRule 
+	{
+	public:
+		/**
+		 * How the operators of a precedence level are grouped.
+		 */
+		enum Associativity
+		{
+			LEFT,		//< Binary operators grouped from the left, e.g. "a - b - c" is "(a - b) - c".
+			RIGHT,		//< Binary operators grouped from the right, e.g. "a ^ b ^ c" is "a ^ (b ^ c)".
+			PREFIX		//< Unary operators written before the operand, e.g. "- a".
+		};
+
+		int operand;										//< The symbol of the operands.
+		vector<pair<Associativity, vector<int>>> levels;	//< The operators of each level, from the lowest precedence.
+
+		/**
+		 * Constructs an operator rule from a YAML node with the "operand" and the "operators" nodes. The symbols 
+		 * of the rule (IGrammarRule::symbols) are set to the equivalent alternatives, which are used by the grammar
+		 * analysis (see IGrammar::analyze()): the operand, each prefix operator followed by the rule, and the rule
+		 * followed by each binary operator and the rule.
+		 * \param language the language of the rule.
+		 * \param name the name of the rule.
+		 * \param ruleNode the YAML node of the rule.
+		 * \throws LanguageException when the node is not valid.
+		 */
+		OperatorRule(Language* language, string& name, YAML::Node& ruleNode);
+
+		/**
+		 * Destructor that does nothing for now.
+		 */
+		virtual ~OperatorRule();
+
+		/**
+		 * Generate C99 code that is able to parse the rule.
+		 * @return the C99 code that is able to parse the rule.
+		 */
+		virtual string compile();
+	private:
+		/**
+		 * Writes a switch on the current token type that sets the precedence level of the operator (the variable 
+		 * "level") and the minimum level of the operators of its right operand (the variable "next"). The levels are
+		 * numbered from 1, the level is -1 when the token is not an operator.
+		 * \param s the stream to write to.
+		 * \param binary true for the binary operators, false for the prefix operators.
+		 */
+		void switchLevel(stringstream& s, bool binary);
+	}; /* class OperatorRule */
+}; /* namespace pgen */
+ 
+#endif /* OPERATORRULE_H_ */
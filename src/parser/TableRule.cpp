@@ -0,0 +1,39 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-27
+ * \file
+ * This file contains the implementation of the TableRule class. This class handles a single rule of the table-driven 
+ * grammars. The rules do not have functions of their own, they are parsed by the table-driven parsers generated by 
+ * the LL1 and the LALR1 classes.
+ */
+
+// STL
+#include <sstream>
+// pgen
+#include "TableRule.h"
+ 
+using namespace std;
+namespace pgen 
+{
+	TableRule::~TableRule() 
+	{
+	}
+
+	string TableRule::compile() 
+	{
+		stringstream s;
+		s << "// " << language->getNonTerminalId(name) << " " << name << ":";
+		for (unsigned int i = 0; i < symbols.size(); i++)
+		{
+			s << (i == 0 ? "" : " |");
+			for (int symbol: *symbols[i])
+			{
+				s << " " << (symbol < 1000000000 ? language->tokenizer.getTypeName(symbol) : 
+					language->getNonTerminalName(symbol));
+			}
+		}
+		s << "\n";
+		return s.str();
+	}
+
+}; /* namespace pgen */
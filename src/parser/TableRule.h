@@ -0,0 +1,51 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-27
+ * \file
+ * This file contains the declaration of the TableRule class. This class handles a single rule of the table-driven 
+ * grammars. The rules do not have functions of their own, they are parsed by the table-driven parsers generated by 
+ * the LL1 and the LALR1 classes.
+ */
+ 
+#ifndef TABLERULE_H_
+#define TABLERULE_H_
+
+namespace pgen { class TableRule; };
+
+// STL
+#include <string>
+#include <vector>
+// yaml-cpp
+#include <yaml-cpp/yaml.h>
+// pgen
+#include "IGrammarRule.h"
+#include "Language.h"
+
+using namespace std;
+namespace pgen 
+{
+	
+	class TableRule 
+	 : public IGrammarRule 
+	{
+	public:
+		/**
+		 * Using IGrammarRule's constructors.
+		 */
+		using IGrammarRule::IGrammarRule;
+		
+		/**
+		 * Destructor that does nothing for now.
+		 */
+		virtual ~TableRule();
+		
+		/**
+		 * Generates a C99 comment with the alternatives of the rule, which documents the productions on the tables of
+		 * the table-driven parsers.
+		 * @return the C99 comment, e.g. "// 1000000000 expression: NUMBER OPERATOR expression | NUMBER".
+		 */
+		virtual string compile();
+	}; /* class TableRule */
+}; /* namespace pgen */
+ 
+#endif /* TABLERULE_H_ */
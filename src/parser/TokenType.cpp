@@ -32,16 +32,21 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#include <iostream>
 // pgen
 #include "TokenType.h"
+#include "../expr/Backtracking.h"
+#include "../expr/Simplifier.h"
 
 using namespace std; 
 namespace pgen 
 {
 
 	TokenType::TokenType(Language* language, string expression, string name, int typeId, bool discard, int setState, 
-		int* validStates) 
-	  : regex(expression, language->ncm)
+		int* validStates, bool ignoreCase) 
+	  : linear(nullptr)
+	  , bitParallel(nullptr)
+	  , regex(expression, language->ncm, ignoreCase)
 	  , name(name)
 	  , discard(discard)
 	  , typeId(typeId)
@@ -49,6 +54,29 @@ namespace pgen
 	  , validStates(validStates)
 	  , language(language)
 	{
+		Simplifier::simplify(regex);
+		Backtracking analysis(&regex);
+		if (analysis.risk() != Backtracking::NONE)
+		{
+			for (const string& warning: analysis.warnings())
+			{
+				cerr << "Warning: token " << name << ": " << warning << endl;
+			}
+			if (!language->linear)
+			{
+				return;
+			}
+			bitParallel = new BitParallel(&regex);
+			if (bitParallel->supported())
+			{
+				cerr << "Warning: token " << name << " will be matched by the bit-parallel engine." << endl;
+				return;
+			}
+			delete bitParallel;
+			bitParallel = nullptr;
+			cerr << "Warning: token " << name << " will be matched by the linear-time engine." << endl;
+			linear = new Linear(&regex);
+		}
 	}
 
 	TokenType::~TokenType() 
@@ -57,25 +85,58 @@ namespace pgen
 		{
 			delete validStates;
 		}
+		delete linear;
+		delete bitParallel;
+	}
+
+	ICompilable* TokenType::matcher()
+	{
+		if (linear != nullptr)
+		{
+			return linear;
+		}
+		if (bitParallel != nullptr)
+		{
+			return bitParallel;
+		}
+		return &regex;
 	}
 
 	void TokenType::matchCode(string tabs, stringstream& s) 
 	{
-		s << tabs << "*pos = " << regex.funcname() << "(text);" 							"\n"
-		  << tabs << "if (*pos != -1) ";
+		s << tabs << "*pos = " << matcher()->funcname() << "(text);" 							"\n"
+		  << tabs << "if (*pos != -1) {"														"\n";
+		acceptCode(tabs + " ", s);
+		s << tabs << "}"																		"\n";
+	}
+
+	void TokenType::acceptCode(string tabs, stringstream& s)
+	{
 		if (setState != -1) 
 		{
 			// Match and set a new state
-			s << "{" 																		"\n"
-			  << tabs << " " << language->prefix << "state = " << setState << ";"			"\n"
-			  << tabs << " return " << (discard? -2 : typeId) << ";" 						"\n"
-			  << tabs << "}"																"\n";
-		} 
-		else 
+			s << tabs << language->prefix << "state = " << setState << ";"						"\n";
+		}
+		s << tabs << "return " << (discard? -2 : typeId) << ";"									"\n";
+	}
+
+	bool TokenType::literal(string& bytes)
+	{
+		return (matcher() == &regex && regex.literal(bytes));
+	}
+
+	string TokenType::stateCondition()
+	{
+		stringstream s;
+		for (int i = 0; validStates != nullptr && validStates[i] != -1; i++) 
 		{
-			// Only match, doesn't make any changes to the state
-			s << "return " << (discard? -2 : typeId) << ";"									"\n";
+			if (i > 0) 
+			{
+				s << " || ";
+			}
+			s << language->prefix << "state == " << validStates[i];
 		}
+		return s.str();
 	}
 
 	string TokenType::code() 
@@ -84,16 +145,7 @@ namespace pgen
 		if (validStates != nullptr) 
 		{
 			// If the token is valid only on specific states, check states first
-			s << " if ("
-			  << language->prefix << "state == " << validStates[0];
-			int i = 1;
-			while (validStates[i] != -1) 
-			{
-				s << " || " 											"\n"
-					 "     " << language->prefix << "state == " << validStates[i++];
-			}
-			s << ")" 													"\n"
-				 " {"													"\n";
+			s << " if (" << stateCondition() << ") {"				"\n";
 			// And then match the token
 			matchCode("  ", s);
 			s << " }" << endl;
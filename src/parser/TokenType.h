@@ -19,6 +19,8 @@ namespace pgen { class TokenType; };
 #include <vector>
 // pgen
 #include "../expr/Regex.h"
+#include "../expr/Linear.h"
+#include "../expr/BitParallel.h"
 #include "Language.h"
 
 using namespace std; 
@@ -35,6 +37,10 @@ namespace pgen
 		 * \param s the stringstream reference to use.
 		 */
 		void matchCode(string tabs, stringstream& s);
+
+		Linear* linear;				//< The linear-time engine of the regex, when it may backtrack catastrophically.
+		BitParallel* bitParallel;	//< The bit-parallel engine of the regex, used instead of the linear-time engine 
+									//< when it supports the regex.
 		
 	public:
 		Regex regex;				//< The regex object associated to this token type
@@ -60,14 +66,47 @@ namespace pgen
 		 * \param validStates the list of stateIds of the states in which this token can occur. This list, when passed
 		 * to the TokenType constructor is supposed to be owned and managed by the TokenType object. It will be 
 		 * automatically freed when the TokenType is destroyed.
+		 * \param ignoreCase true if the token matches the text regardless of the case of the letters.
 		 * \remark When the validStates array is provided, it must contain at least ONE VALID ITEM.
+		 * \remark The regex is analyzed for backtracking risks (see Backtracking). A warning is printed for each risky
+		 * sub-expression. When the language enables it (see Language::linear), the token is matched with the 
+		 * bit-parallel engine when it supports the regex (see BitParallel), or with the linear-time engine otherwise
+		 * (see Linear). The engines may accept texts that the backtracking code rejects (see Linear), which changes
+		 * the language of the token, so they must be enabled explicitly.
 		 */
 		TokenType(Language* language, string expression, string name, int typeId, bool discard = false, 
-			int setState = -1, int* validStates = nullptr);
+			int setState = -1, int* validStates = nullptr, bool ignoreCase = false);
 		/**
 		 * TokenType virtual destructor. When the validStates array is set, it is freed.
 		 */
 		virtual ~TokenType();
+
+		/**
+		 * \returns the expression that matches this TokenType: the regex, or its bit-parallel or linear-time engine 
+		 * when the regex may backtrack catastrophically.
+		 */
+		ICompilable* matcher();
+
+		/**
+		 * Gets the text matched by this TokenType, when its regex only matches a single text.
+		 * \param bytes the string to append the UTF-8 bytes of the text to.
+		 * \returns true when the regex only matches a single text (see ICompilable::literal()).
+		 */
+		bool literal(string& bytes);
+
+		/**
+		 * \returns the C99 condition that checks whether the tokenizer is in one of the valid states of this 
+		 * TokenType, or an empty string when the TokenType is valid in all states.
+		 */
+		string stateCondition();
+
+		/**
+		 * Writes the C99 code executed once this TokenType is matched: it sets the new state, when there is one, and 
+		 * returns the typeId (or -2 when the token is discarded).
+		 * \param tabs the string of the tabs to be prepended to each command line.
+		 * \param s the stringstream reference to use.
+		 */
+		void acceptCode(string tabs, stringstream& s);
 		
 		/**
 		 * Returns the code that parses this TokenType (to be used on the next_token function).
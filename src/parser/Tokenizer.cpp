@@ -11,8 +11,12 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <set>
+#include <algorithm>
 // pgen
 #include "../expr/Code.h"
+#include "../expr/Trie.h"
+#include "../expr/Prefilter.h"
 #include "TokenType.h"
 #include "Tokenizer.h"
 
@@ -55,6 +59,23 @@ namespace pgen
         return -1;
     }
 
+    /**
+     * Returns the name of a token type.
+     * \param typeId the typeId of the token type.
+     * \return the name of the token type, or an empty string if there is no token type with the typeId.
+     */
+    string Tokenizer::getTypeName(int typeId)
+    {
+        for (auto it = typeList.begin(); it != typeList.end(); ++it)
+        {
+            if (it->second->typeId == typeId)
+            {
+                return it->first;
+            }
+        }
+        return "";
+    }
+
     /**
      * Adds a TokenType to the Tokenizer (the TokenType is provided by the user).
      * \param tokenType the tokenType.
@@ -79,8 +100,9 @@ namespace pgen
      * \param name the name of the type
      * \param setState the state to set the tokenizer when the token is matched (or -1 if state doesn't change)
      * \param validStates the states in which the token is valid (or nullptr if the token is valid on all states)
+     * \param ignoreCase true if the token matches the text regardless of the case of the letters
      */
-    void Tokenizer::add(string expression, string name, int setState, int* validStates) 
+    void Tokenizer::add(string expression, string name, int setState, int* validStates, bool ignoreCase) 
     {
         bool discard = (name.length() > 0 && name[0] == '$');
         int typeId = this->getTypeId(name);
@@ -88,7 +110,8 @@ namespace pgen
         { 
             typeId = typeList.size();
         }
-        TokenType *tokenType = new TokenType(language, expression, name, typeId, discard, setState, validStates);
+        TokenType *tokenType = new TokenType(language, expression, name, typeId, discard, setState, validStates, 
+            ignoreCase);
         this->add(tokenType);
     }
 
@@ -115,18 +138,123 @@ namespace pgen
     }
 
     /**
-     * Writes the code to the next_token method, which gets the next token of the text.
+     * Splits the token types, sorted by typeId, into groups. Consecutive token types that only match a literal text 
+     * (see TokenType::literal()) are put together in the same group, as long as their texts are different. Every other
+     * token type is put alone in its own group.
+     * \return the groups of token types.
+     */
+    vector<vector<TokenType*>> Tokenizer::groups() 
+    {
+        vector<TokenType*> types;
+        for (auto& kv: typeList) 
+        {
+            types.push_back(kv.second);
+        }
+        sort(types.begin(), types.end(), [](TokenType* a, TokenType* b) { return a->typeId < b->typeId; });
+        vector<vector<TokenType*>> list;
+        set<string> texts;
+        bool literals = false;
+        for (TokenType* type: types) 
+        {
+            string bytes;
+            bool literal = type->literal(bytes);
+            if (literal && literals && texts.insert(bytes).second) 
+            {
+                list.back().push_back(type);
+                continue;
+            }
+            list.push_back(vector<TokenType*>(1, type));
+            literals = literal;
+            texts.clear();
+            texts.insert(bytes);
+        }
+        return list;
+    }
+
+    /**
+     * Writes a function that matches a group of literal token types at once with a trie (see Trie), reading each byte
+     * of the text only once. The token type with the lowest typeId is accepted when more than one text matches the 
+     * text, which is the same token type that would be accepted by trying each token type in order.
+     * \param s the stringstream to write to
+     * \param group the token types.
+     * \param index the index of the group, which is appended to the name of the function.
+     * compiled code:
+     * static int next_literal_token%index%(char* text, int* pos) {
+     *  %trie of the texts of the token types%
+     * }
+     * and the stop code of the trie, for each text that matches the input (sorted by typeId):
+     *  if (%stateCondition()%) {
+     *   *pos = %length of the text%;
+     *   %acceptCode()%
+     *  }
+     *  return -1;
+     */
+    void Tokenizer::codeLiteralTokens(stringstream& s, const vector<TokenType*>& group, unsigned int index) 
+    {
+        Trie trie;
+        bool all = false;
+        for (unsigned int i = 0; i < group.size(); i++) 
+        {
+            string bytes;
+            group[i]->literal(bytes);
+            trie.add(bytes, i);
+            // the texts with lower priorities are also needed when the texts may be invalid in the current state
+            all = all || group[i]->validStates != nullptr;
+        }
+        s << "static int next_literal_token" << index << "(char* text, int* pos) {"                                 "\n"
+          << trie.compile(all, [&group](stringstream& s, const string& tabs, const vector<Trie::Match>& matches) {
+                for (const Trie::Match& m: matches) 
+                {
+                    TokenType* type = group[m.item];
+                    string condition = type->stateCondition();
+                    if (condition.empty()) 
+                    {
+                        s << tabs << "*pos = " << m.length << ";"                                                   "\n";
+                        type->acceptCode(tabs, s);
+                        return;
+                    }
+                    s << tabs << "if (" << condition << ") {"                                                       "\n"
+                      << tabs << " *pos = " << m.length << ";"                                                      "\n";
+                    type->acceptCode(tabs + " ", s);
+                    s << tabs << "}"                                                                                "\n";
+                }
+                s << tabs << "return -1;"                                                                           "\n";
+             })
+          << "}"                                                                                                  "\n\n";
+    }
+
+    /**
+     * Writes the code to the next_token method, which gets the next token of the text. The groups of literal token 
+     * types are matched by their own functions (see codeLiteralTokens).
      * \param stringstream the stringstream to write to
      */
     void Tokenizer::codeNextToken(stringstream &s) 
     {
+        vector<vector<TokenType*>> list = groups();
+        bool literals = false;
+        for (unsigned int i = 0; i < list.size(); i++) 
+        {
+            if (list[i].size() > 1) 
+            {
+                codeLiteralTokens(s, list[i], i);
+                literals = true;
+            }
+        }
         s << "int next_token(char* text, int* pos) {"                                                               "\n";
-        for (int i = 0, sz = typeList.size(); i < sz; i++) {
-            for (auto kv: typeList) {
-                if (kv.second->typeId == i) {
-                    s << kv.second->code();
-                    break;
-                }
+        if (literals) 
+        {
+            s << " int tokid;"                                                                                      "\n";
+        }
+        for (unsigned int i = 0; i < list.size(); i++) 
+        {
+            if (list[i].size() > 1) 
+            {
+                s << " tokid = next_literal_token" << i << "(text, pos);"                                           "\n"
+                     " if (tokid != -1) return tokid;"                                                              "\n";
+            }
+            else 
+            {
+                s << list[i][0]->code();
             }
         }
         s << " strncpy(" << language->prefix << "inv_token_txt, text, 200);"                                        "\n"
@@ -236,6 +364,26 @@ namespace pgen
              "}"                                                                                                  "\n\n";
     }
 
+    /**
+     * Writes the find functions, which search a buffer for the first token of each type that is not discarded (see 
+     * Prefilter). The tokenizer state is ignored by those functions.
+     * \param stringstream the stringstream to write to
+     */
+    void Tokenizer::codeFind(stringstream &s) 
+    {
+        for (const auto& group: groups()) 
+        {
+            for (TokenType* type: group) 
+            {
+                if (!type->discard) 
+                {
+                    Prefilter prefilter(&type->regex);
+                    s << prefilter.compile(fnNameFind(type), type->matcher()->funcname());
+                }
+            }
+        }
+    }
+
     /**
      * \returns a string with all the code needed by the tokenizer.
      */
@@ -244,10 +392,13 @@ namespace pgen
         stringstream s;
         Code mCode;
         
-        // Add the code to parse all tokens
-        for (const auto& kv: typeList) 
+        // Add the code to parse all tokens, except the ones matched by the tries of the literal token types
+        for (const auto& group: groups()) 
         {
-            mCode.add(&(kv.second->regex));
+            if (group.size() == 1) 
+            {
+                mCode.add(group[0]->matcher());
+            }
         }
         s << mCode.code() << endl;
         
@@ -258,10 +409,41 @@ namespace pgen
         this->codeTokenizeStringLen(s);
         this->codeTokenizeString(s);
         this->codeTokenizeFile(s);
+        this->codeFind(s);
 
         return s.str();
     }
 
+    /**
+     * \returns the declarations of the globals and functions of the tokenizer code.
+     */
+    string Tokenizer::declarations()
+    {
+        stringstream s;
+        this->codeDefines(s);
+        s << "extern int " << language->prefix << "state;"                                                         "\n"
+             "extern int " << language->prefix << "inv_token_pos;"                                                 "\n"
+             "extern char " << language->prefix << "inv_token_txt[200];"                                           "\n"
+             "int next_token(char* text, int* pos);"                                                                "\n"
+             "int " << fnNameNumTokens() << "(char* text, int len);"                                                "\n"
+             "token_list* " << fnNameTokenizeStringLen() << "(char* text, int len);"                                "\n"
+             "token_list* " << fnNameTokenizeString() << "(char* text);"                                            "\n"
+             "token_list* " << fnNameTokenizeFile() << "(char* fileName);"                                          "\n\n";
+        return s.str();
+    }
+
+    /**
+     * \returns the name of the find method of a token type.
+     */
+    const string Tokenizer::fnNameFind(TokenType* type) 
+    {
+        if (type->discard) 
+        {
+            return "";
+        }
+        return language->prefix + "find_" + type->name;
+    }
+
     /**
      * \returns the name of the tokenize_string_len method for the language.
      */
@@ -14,6 +14,7 @@ namespace pgen { class Tokenizer; };
 // STL
 #include <string>
 #include <map>
+#include <vector>
 // Other
 #include "TokenType.h"
 #include "Language.h"
@@ -31,11 +32,14 @@ namespace pgen
 		void codeStructs(stringstream& s);
 		void codeGlobals(stringstream &s);
 		void codeTokenListHelper(stringstream &s);
+		vector<vector<TokenType*>> groups();
+		void codeLiteralTokens(stringstream& s, const vector<TokenType*>& group, unsigned int index);
 		void codeNextToken(stringstream &s);
 		void codeNumTokens(stringstream &s);
 		void codeTokenizeStringLen(stringstream &s);
 		void codeTokenizeString(stringstream &s);
 		void codeTokenizeFile(stringstream &s);
+		void codeFind(stringstream &s);
 	public:
 		map<string, TokenType*> typeList;			//< map of TokenTypes, indexed by their names.
 		
@@ -50,6 +54,13 @@ namespace pgen
 		 */
 		int getTypeId(const string& name);
 		
+		/**
+		 * Returns the name of a token type.
+		 * \param typeId the typeId of the token type.
+		 * \return the name of the token type, or an empty string if there is no token type with the typeId.
+		 */
+		string getTypeName(int typeId);
+		
 		/**
 		 * Add a TokenType to the manager.
 		 * \param tokenType a pointer to the tokenType to be added.
@@ -63,9 +74,11 @@ namespace pgen
 		 * \param name the name of the token, when the name starts with '%', the token is read but ignored by the parser
 		 * \param setState the state to be set when this token is read by the parser or -1 if state shouldn't change
 		 * \param validStates list of states on which this token is valid, nullptr if all states are valid.
+		 * \param ignoreCase true if the token matches the text regardless of the case of the letters.
 		 * \remark The created TokenType will be fully owned and managed by this Tokenizer.
 		 */
-		void add(string expression, string name, int setState = -1, int* validStates = nullptr);
+		void add(string expression, string name, int setState = -1, int* validStates = nullptr, 
+			bool ignoreCase = false);
 		
 		/**
 		 * Returns the C99 code for tokenizing a string and a file according to the token type rules.
@@ -73,6 +86,13 @@ namespace pgen
 		 */
 		string code();
 		
+		/**
+		 * Returns the C99 declarations of the globals and functions defined by the code of the Tokenizer, which are
+		 * needed by other translation units when the generated code is split into multiple files.
+		 * \return the C99 declarations of the tokenizer globals and functions.
+		 */
+		string declarations();
+		
 		const string fnNameTokenizeStringLen();
 		
 		/**
@@ -91,6 +111,15 @@ namespace pgen
 		 * Name of the function to get the number of tokens.
 		 */
 		const string fnNameNumTokens();
+
+		/**
+		 * Name of the function that finds the first token of a type on a buffer (see Prefilter::compile()). The 
+		 * function that searches a null-terminated text from a position has the same name followed by "_from".
+		 * \param type the token type.
+		 * \return the name of the function, or an empty string when the token type is discarded (the function is not
+		 * generated).
+		 */
+		const string fnNameFind(TokenType* type);
 	}; /* class Tokenizer */
 }; /* namespace pgen */
 
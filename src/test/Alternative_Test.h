@@ -23,6 +23,7 @@
 #include "../expr/Alternative.h"
 #include "../expr/Sequence.h"
 #include "../expr/Character.h"
+#include "../expr/Quantified.h"
 #include "ICompilable_Test.h"
 
 using namespace std;
@@ -45,6 +46,7 @@ namespace pgen
 			CppUnit::TestSuite * s = new CppUnit::TestSuite("AlternativeTest");
 			s->addTest(new CppUnit::TestCaller<AlternativeTest>("AlternativeTest::testCompile", &AlternativeTest::testCompile));
 			s->addTest(new CppUnit::TestCaller<AlternativeTest>("AlternativeTest::testName", &AlternativeTest::testName));
+			s->addTest(new CppUnit::TestCaller<AlternativeTest>("AlternativeTest::testLiterals", &AlternativeTest::testLiterals));
 			return s;
 		}
 
@@ -89,8 +91,47 @@ namespace pgen
 			ICompilableTest::clearFiles();
 		}
 
+		void testLiterals() {
+			// "if|int|in", the first alternative that matches is used even when a longer one also matches.
+			Alternative keywords;
+			const char* words[] = {"if", "int", "in"};
+			for (const char* word: words) {
+				Sequence *s = new Sequence();
+				for (const char* c = word; *c != 0; c++) {
+					s->add(new Character(*c));
+				}
+				keywords.add(s);
+			}
+			CPPUNIT_ASSERT(alt.literals());
+			CPPUNIT_ASSERT(keywords.literals());
+			ICompilableTest::compileSource(keywords, Code::getHeader());
+			CPPUNIT_ICOMPILABLE_ASSERT("if",2);
+			CPPUNIT_ICOMPILABLE_ASSERT("int",3);
+			CPPUNIT_ICOMPILABLE_ASSERT("in",2);
+			CPPUNIT_ICOMPILABLE_ASSERT("inx",2);
+			CPPUNIT_ICOMPILABLE_ASSERT("i",255);
+			ICompilableTest::clearFiles();
+			// an alternative with a non-literal expression is not matched by a trie.
+			keywords.add(new Quantified(new Character('x'), 1, Quantified::INF));
+			CPPUNIT_ASSERT(!keywords.literals());
+		}
+
 		void testName() {
-			CPPUNIT_ICOMPILABLE_ASSERTNAME(alt, "al_sq_ch_114_ch_101_sq_ch_100_ch_105");
+			Alternative same, other;
+			Sequence *s = new Sequence();
+			s->add(new Character('r'));
+			s->add(new Character('e'));
+			same.add(s);
+			s = new Sequence();
+			s->add(new Character('d'));
+			s->add(new Character('i'));
+			same.add(s);
+			other.add(new Character('r'));
+			other.add(new Character('d'));
+			CPPUNIT_ICOMPILABLE_ASSERTNAME(alt, same.name());
+			CPPUNIT_ASSERT(alt.name() != other.name());
+			CPPUNIT_ASSERT(alt.name().substr(0, 2) == "al");
+			CPPUNIT_ASSERT(alt.name().find_first_not_of("0123456789", 2) == string::npos);
 		}
 	}; /* class AlternativeTest */
 } /* namespace pgen */
@@ -0,0 +1,116 @@
+/*
+ * Backtracking_Test.h
+ *
+ *  Created on: May 23, 2015
+ *      Author: Dimas Melo Filho
+ */
+
+#ifndef BACKTRACKING_TEST_H_
+#define BACKTRACKING_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+// pgen
+#include "../expr/Backtracking.h"
+#include "../expr/Regex.h"
+#include "../parser/NamedClassManager.h"
+
+using namespace std;
+namespace pgen
+{
+	/**
+	 * Unit Test Fixture for the "Backtracking" class.
+	 */
+	class BacktrackingTest 
+	 : public CppUnit::TestFixture 
+	{
+	public:
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test * suite() 
+		{
+			CppUnit::TestSuite * s = new CppUnit::TestSuite("BacktrackingTest");
+			s->addTest(new CppUnit::TestCaller<BacktrackingTest>("BacktrackingTest::testSafe", &BacktrackingTest::testSafe));
+			s->addTest(new CppUnit::TestCaller<BacktrackingTest>("BacktrackingTest::testExponential", &BacktrackingTest::testExponential));
+			s->addTest(new CppUnit::TestCaller<BacktrackingTest>("BacktrackingTest::testPolynomial", &BacktrackingTest::testPolynomial));
+			s->addTest(new CppUnit::TestCaller<BacktrackingTest>("BacktrackingTest::testWarnings", &BacktrackingTest::testWarnings));
+			return s;
+		}
+
+		/**
+		 * Test preparations.
+		 */
+		void setUp() 
+		{
+		}
+
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+		}
+
+		/**
+		 * \return the risk of a regular expression.
+		 */
+		static Backtracking::Risk risk(const string& expression)
+		{
+			NamedClassManager ncm;
+			Regex r(expression, ncm);
+			return Backtracking(&r).risk();
+		}
+
+		void testSafe() 
+		{
+			CPPUNIT_ASSERT_EQUAL(Backtracking::NONE, risk("[0-9]+\\.[0-9]+"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::NONE, risk("[a-zA-Z_][a-zA-Z0-9_]*"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::NONE, risk("\"([^\"\\\\]|\\\\.)*\""));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::NONE, risk("(-[a-z]{2,8})+"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::NONE, risk("x(ab)*abc"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::NONE, risk("a*a"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::NONE, risk("[0-9a-f]{1,4}[0-9a-f]{1,4}"));
+		}
+
+		void testExponential() 
+		{
+			CPPUNIT_ASSERT_EQUAL(Backtracking::EXPONENTIAL, risk("(a+)+b"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::EXPONENTIAL, risk("([a-z]+\\s?)*!"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::EXPONENTIAL, risk("(a*)*"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::EXPONENTIAL, risk("(a|a)*b"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::EXPONENTIAL, risk("\"(\\\\.|[^\"])*\""));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::EXPONENTIAL, risk("x|(\\d{1,3})+y"));
+		}
+
+		void testPolynomial() 
+		{
+			CPPUNIT_ASSERT_EQUAL(Backtracking::POLYNOMIAL, risk("a*a*b"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::POLYNOMIAL, risk("[0-9]+\\.?[0-9]+"));
+			CPPUNIT_ASSERT_EQUAL(Backtracking::POLYNOMIAL, risk("(a+){3}"));
+		}
+
+		void testWarnings() 
+		{
+			NamedClassManager ncm;
+			Regex r("x(a+)+|y", ncm);
+			Backtracking b(&r);
+			CPPUNIT_ASSERT_EQUAL((size_t)1, b.warnings().size());
+			// the warning shows the offending sub-expression and the quantifier nested in it
+			CPPUNIT_ASSERT(b.warnings()[0].find("exponential") == 0);
+			CPPUNIT_ASSERT(b.warnings()[0].find("'(a+)+'") != string::npos);
+			CPPUNIT_ASSERT(b.warnings()[0].find("'a+'") != string::npos);
+			Regex s("abc", ncm);
+			CPPUNIT_ASSERT(Backtracking(&s).warnings().empty());
+		}
+		
+	}; /* class BacktrackingTest */
+} /* namespace pgen */
+
+#endif /* BACKTRACKING_TEST_H_ */
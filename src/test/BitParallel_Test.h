@@ -0,0 +1,135 @@
+/*
+ * BitParallel_Test.h
+ *
+ *  Created on: May 24, 2015
+ *      Author: Dimas Melo Filho
+ */
+
+#ifndef BITPARALLEL_TEST_H_
+#define BITPARALLEL_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+// pgen
+// pgen
+#include "../expr/BitParallel.h"
+#include "../expr/Regex.h"
+#include "../expr/Code.h"
+#include "../expr/Simplifier.h"
+#include "../parser/NamedClassManager.h"
+#include "ICompilable_Test.h"
+
+using namespace std;
+namespace pgen
+{
+	/**
+	 * Unit Test Fixture for the "BitParallel" class.
+	 */
+	class BitParallelTest 
+	 : public CppUnit::TestFixture 
+	{
+	public:
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test * suite() 
+		{
+			CppUnit::TestSuite * s = new CppUnit::TestSuite("BitParallelTest");
+			s->addTest(new CppUnit::TestCaller<BitParallelTest>("BitParallelTest::testAutomaton", &BitParallelTest::testAutomaton));
+			s->addTest(new CppUnit::TestCaller<BitParallelTest>("BitParallelTest::testSupported", &BitParallelTest::testSupported));
+			s->addTest(new CppUnit::TestCaller<BitParallelTest>("BitParallelTest::testCompile", &BitParallelTest::testCompile));
+			return s;
+		}
+
+		/**
+		 * Test preparations.
+		 */
+		void setUp() 
+		{
+		}
+
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+			ICompilableTest::clearFiles();
+		}
+
+		/**
+		 * Checks whether the bit-parallel engine supports an expression.
+		 */
+		static bool supported(const string& expression)
+		{
+			NamedClassManager ncm;
+			Regex r(expression, ncm);
+			Simplifier::simplify(r);
+			BitParallel b(&r);
+			return b.supported();
+		}
+
+		void testAutomaton() 
+		{
+			NamedClassManager ncm;
+			Regex r("a(b|c)*d", ncm);
+			BitParallel b(&r);
+			// see the example on BitParallel.h
+			CPPUNIT_ASSERT(b.supported());
+			CPPUNIT_ASSERT_EQUAL(4u, b.size());
+			CPPUNIT_ASSERT(b.name() != r.name());
+			CPPUNIT_ASSERT_EQUAL(r.str(), b.str());
+			// bounded quantifiers have a position for each occurrence
+			Regex r2("[0-9a-f]{2,4}", ncm);
+			BitParallel b2(&r2);
+			CPPUNIT_ASSERT(b2.supported());
+			CPPUNIT_ASSERT_EQUAL(4u, b2.size());
+		}
+
+		/**
+		 * Only the expressions whose longest match is the match of the backtracking code are supported.
+		 */
+		void testSupported()
+		{
+			CPPUNIT_ASSERT(supported("[0-9]+\\.[0-9]+"));
+			CPPUNIT_ASSERT(supported("(a?b+c*|[d-f])+|[^a-z]+"));
+			CPPUNIT_ASSERT(supported("abc[0-9]|abd|ab"));
+			// two positions of a set accept the same character
+			CPPUNIT_ASSERT(!supported("(ab|a)(bc|c)"));
+			CPPUNIT_ASSERT(!supported(".{0,5}x"));
+			// lazy quantifiers
+			CPPUNIT_ASSERT(!supported("x(a|b)*?y"));
+			// a nullable alternative that is not the last one
+			CPPUNIT_ASSERT(!supported("(a*|b)c"));
+			// too many positions
+			CPPUNIT_ASSERT(!supported("[0-9a-f]{65}"));
+		}
+
+		/**
+		 * The matches are the same ones found by the backtracking code, including expressions that take exponential 
+		 * time with it.
+		 */
+		void testCompile() 
+		{
+			NamedClassManager ncm;
+			Regex r("(a?b+c*|[d-f])+!|[0-9 ]+|\\u00e9{2,3}x", ncm);
+			Simplifier::simplify(r);
+			BitParallel b(&r);
+			CPPUNIT_ASSERT(b.supported());
+			ICompilableTest::compileSource(b, Code::getHeader());
+			ICompilableTest::assert("abbcd!", 6,__FILE__,__LINE__);
+			ICompilableTest::assert("abbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbba", 255,__FILE__,__LINE__);
+			ICompilableTest::assert("12 34!", 5,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc3\xa9\xc3\xa9\xc3\xa9x", 7,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc3\xa9x", 255,__FILE__,__LINE__);
+		}
+
+	}; /* class BitParallelTest */
+} /* namespace pgen */
+
+#endif /* BITPARALLEL_TEST_H_ */
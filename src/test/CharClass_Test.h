@@ -17,6 +17,7 @@
 // STL
 #include <iostream>
 #include <climits>
+#include <vector>
 // pgen
 #include "../expr/CharClass.h"
 #include "../parser/NamedClassManager.h"
@@ -41,6 +42,8 @@ namespace pgen
 			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::add(s,e)", &CharClassTest::testAddInterval));
 			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::invert()", &CharClassTest::testInvert));
 			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::normalize()", &CharClassTest::testNormalize));
+			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::intersect()", &CharClassTest::testIntersect));
+			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::add(c)", &CharClassTest::testUnion));
 			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::operator==() and CharClass::operator!=()", &CharClassTest::testOperators));
 			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::compile", &CharClassTest::testCompile));
 			s->addTest(new CppUnit::TestCaller<CharClassTest>("CharClass::name", &CharClassTest::testName));
@@ -77,49 +80,43 @@ namespace pgen
 			 */
 		}
 
+		/**
+		 * Checks if a class contains exactly the expected intervals, in order.
+		 */
+		static bool hasRanges(const CharClass& c, const vector<pair<unsigned int, unsigned int>>& expected)
+		{
+			return (vector<pair<unsigned int, unsigned int>>(c.ranges.begin(), c.ranges.end()) == expected);
+		}
+
 		void testAddInterval() 
 		{
 			il = new CharClass();
-			CPPUNIT_ASSERT( il->range == nullptr );
+			CPPUNIT_ASSERT( il->ranges.empty() );
 			il->add(10);
-			CPPUNIT_ASSERT( il->range != nullptr );
-			CPPUNIT_ASSERT( il->range->prev == nullptr );
-			CPPUNIT_ASSERT( il->range->next == nullptr );
-			CPPUNIT_ASSERT( il->range->start == 10 );
-			CPPUNIT_ASSERT( il->range->end == 10 );
+			CPPUNIT_ASSERT( hasRanges(*il, {{10,10}}) );
 			il->add(11);
-			CPPUNIT_ASSERT( il->range->prev == nullptr );
-			CPPUNIT_ASSERT( il->range->next == nullptr );
-			CPPUNIT_ASSERT( il->range->start == 10 );
-			CPPUNIT_ASSERT( il->range->end == 11 );
+			CPPUNIT_ASSERT( hasRanges(*il, {{10,11}}) );
 			il->add(13);
-			CPPUNIT_ASSERT( il->range->prev == nullptr );
-			CPPUNIT_ASSERT( il->range->next != nullptr );
-			CPPUNIT_ASSERT( il->range->start == 10 );
-			CPPUNIT_ASSERT( il->range->end == 11 );
-			CPPUNIT_ASSERT( il->range->next->start == 13 );
-			CPPUNIT_ASSERT( il->range->next->end == 13 );
+			CPPUNIT_ASSERT( hasRanges(*il, {{10,11},{13,13}}) );
 			il->add(12,14);
-			CPPUNIT_ASSERT( il->range->prev == nullptr );
-			CPPUNIT_ASSERT( il->range->next == nullptr );
-			CPPUNIT_ASSERT( il->range->start == 10 );
-			CPPUNIT_ASSERT( il->range->end == 14 );
+			CPPUNIT_ASSERT( hasRanges(*il, {{10,14}}) );
 			il->add(5,9);
-			CPPUNIT_ASSERT( il->range->prev == nullptr );
-			CPPUNIT_ASSERT( il->range->next == nullptr );
-			CPPUNIT_ASSERT( il->range->start == 5 );
-			CPPUNIT_ASSERT( il->range->end == 14 );
+			CPPUNIT_ASSERT( hasRanges(*il, {{5,14}}) );
 			il->add(9,12);
-			CPPUNIT_ASSERT( il->range->prev == nullptr );
-			CPPUNIT_ASSERT( il->range->next == nullptr );
-			CPPUNIT_ASSERT( il->range->start == 5 );
-			CPPUNIT_ASSERT( il->range->end == 14 );
+			CPPUNIT_ASSERT( hasRanges(*il, {{5,14}}) );
 			il->add(16,20);
 			il->add(15);
-			CPPUNIT_ASSERT( il->range->prev == nullptr );
-			CPPUNIT_ASSERT( il->range->next == nullptr );
-			CPPUNIT_ASSERT( il->range->start == 5 );
-			CPPUNIT_ASSERT( il->range->end == 20 );
+			CPPUNIT_ASSERT( hasRanges(*il, {{5,20}}) );
+			// an interval that covers several others, given in reverse order
+			il->add(30,40);
+			il->add(50,60);
+			il->add(70,80);
+			CPPUNIT_ASSERT( hasRanges(*il, {{5,20},{30,40},{50,60},{70,80}}) );
+			il->add(65,35);
+			CPPUNIT_ASSERT( hasRanges(*il, {{5,20},{30,65},{70,80}}) );
+			il->add(UINT_MAX);
+			il->add(21,UINT_MAX-1);
+			CPPUNIT_ASSERT( hasRanges(*il, {{5,UINT_MAX}}) );
 			delete il;
 		}
 
@@ -129,60 +126,33 @@ namespace pgen
 			il->add(10,20);
 			il->add(110,120);
 			il->invert();
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 1);
-			CPPUNIT_ASSERT(il->range->end == 9);
-			CPPUNIT_ASSERT(il->range->next != nullptr);
-			CPPUNIT_ASSERT(il->range->next->start == 21);
-			CPPUNIT_ASSERT(il->range->next->end == 109);
-			CPPUNIT_ASSERT(il->range->next->next != nullptr);
-			CPPUNIT_ASSERT(il->range->next->next->start == 121);
-			CPPUNIT_ASSERT(il->range->next->next->end == UINT_MAX);
-			CPPUNIT_ASSERT(il->range->next->next->next == nullptr);
+			CPPUNIT_ASSERT( hasRanges(*il, {{1,9},{21,109},{121,UINT_MAX}}) );
 			il->invert();
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 10);
-			CPPUNIT_ASSERT(il->range->end == 20);
-			CPPUNIT_ASSERT(il->range->next != nullptr);
-			CPPUNIT_ASSERT(il->range->next->start == 110);
-			CPPUNIT_ASSERT(il->range->next->end == 120);
-			CPPUNIT_ASSERT(il->range->next->next == nullptr);
+			CPPUNIT_ASSERT( hasRanges(*il, {{10,20},{110,120}}) );
 			delete il;
 			// test the inversion of a class that contains all characters
 			il = new CharClass();
 			il->add(0,UINT_MAX);
-			CPPUNIT_ASSERT(il->range != nullptr);
+			CPPUNIT_ASSERT( !il->ranges.empty() );
 			il->invert();
 			// test the inversion of a class that contains no characters.
-			CPPUNIT_ASSERT(il->range == nullptr);
+			CPPUNIT_ASSERT( il->ranges.empty() );
 			il->invert();
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 1);
-			CPPUNIT_ASSERT(il->range->end == UINT_MAX);
+			CPPUNIT_ASSERT( hasRanges(*il, {{1,UINT_MAX}}) );
 			delete il;
 			// test the inversion of a class that contains only the 1 (0 gets added as 1)
 			il = new CharClass();
 			il->add((unsigned int)0);
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 1);
-			CPPUNIT_ASSERT(il->range->end == 1);
+			CPPUNIT_ASSERT( hasRanges(*il, {{1,1}}) );
 			il->invert();
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 2);
-			CPPUNIT_ASSERT(il->range->end == UINT_MAX);
-			CPPUNIT_ASSERT(il->range->next == nullptr);
+			CPPUNIT_ASSERT( hasRanges(*il, {{2,UINT_MAX}}) );
 			delete il;
 			// test the inversion of a class that contains only the UINT_MAX
 			il = new CharClass();
 			il->add(UINT_MAX);
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == UINT_MAX);
-			CPPUNIT_ASSERT(il->range->end == UINT_MAX);
+			CPPUNIT_ASSERT( hasRanges(*il, {{UINT_MAX,UINT_MAX}}) );
 			il->invert();
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 1);
-			CPPUNIT_ASSERT(il->range->end == UINT_MAX-1);
-			CPPUNIT_ASSERT(il->range->next == nullptr);
+			CPPUNIT_ASSERT( hasRanges(*il, {{1,UINT_MAX-1}}) );
 			delete il;
 		}
 
@@ -191,23 +161,49 @@ namespace pgen
 			il = new CharClass();
 			il->negated = true;
 			il->add((unsigned int)0);									// since 0 is not accepted, 1 will be added instead
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 1);
-			CPPUNIT_ASSERT(il->range->end == 1);
+			CPPUNIT_ASSERT( hasRanges(*il, {{1,1}}) );
 			CPPUNIT_ASSERT(il->negated == true);
 			il->normalize();							// invert the 1 that was added, now it should start at 2 and end at UINT_MAX
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 2);
-			CPPUNIT_ASSERT(il->range->end == UINT_MAX);
+			CPPUNIT_ASSERT( hasRanges(*il, {{2,UINT_MAX}}) );
 			CPPUNIT_ASSERT(il->negated == false);
 			il->normalize();							// nothing is changed since it is already normalized
-			CPPUNIT_ASSERT(il->range != nullptr);
-			CPPUNIT_ASSERT(il->range->start == 2);
-			CPPUNIT_ASSERT(il->range->end == UINT_MAX);
+			CPPUNIT_ASSERT( hasRanges(*il, {{2,UINT_MAX}}) );
 			CPPUNIT_ASSERT(il->negated == false);
 			delete il;
 		}
 
+		void testIntersect() 
+		{
+			il = new CharClass();
+			CharClass other;
+			il->add(10,20);
+			il->add(30,40);
+			il->add(50,60);
+			other.add(15,35);
+			other.add(60,70);
+			il->intersect(other);
+			CPPUNIT_ASSERT( hasRanges(*il, {{15,20},{30,35},{60,60}}) );
+			il->intersect(CharClass());
+			CPPUNIT_ASSERT( il->ranges.empty() );
+			delete il;
+		}
+
+		void testUnion() 
+		{
+			// large classes are merged in a single pass, small ones are added range by range.
+			il = new CharClass();
+			CharClass other;
+			for (unsigned int c = 0; c < 100; c += 4) il->add(c, c+1);
+			for (unsigned int c = 2; c < 100; c += 8) other.add(c, c+1);
+			il->add(other);
+			CPPUNIT_ASSERT( il->ranges.size() == 13 );
+			for (unsigned int c = 1; c < 100; c++) 
+			{
+				CPPUNIT_ASSERT( il->ranges.contains(c) == (c % 8 < 6) );
+			}
+			delete il;
+		}
+
 		void testOperators() 
 		{
 			il = new CharClass();
@@ -252,6 +248,31 @@ namespace pgen
 			ICompilableTest::assert("\x40",1,__FILE__,__LINE__);
 			ICompilableTest::assert("\x41",255,__FILE__,__LINE__);
 			ICompilableTest::clearFiles();
+			delete il;
+			// latin-1 bitmap and binary search (see CharClass::membership())
+			il = new CharClass();
+			for (unsigned int c = 'a'; c <= 'z'; c += 2) il->add(c);
+			for (unsigned int c = 0x100; c < 0x120; c += 2) il->add(c);
+			ICompilableTest::compileSource(*il, pgen::Code::getHeader());
+			ICompilableTest::assert("a",1,__FILE__,__LINE__);
+			ICompilableTest::assert("b",255,__FILE__,__LINE__);
+			ICompilableTest::assert("y",1,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc4\x80",2,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc4\x9e",2,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc4\x9f",255,__FILE__,__LINE__);
+			ICompilableTest::clearFiles();
+			// two-level table
+			for (unsigned int c = 0x4E00; c < 0x4F00; c += 2) il->add(c);
+			ICompilableTest::compileSource(*il, pgen::Code::getHeader());
+			ICompilableTest::assert("y",1,__FILE__,__LINE__);
+			ICompilableTest::assert("z",255,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc4\x80",2,__FILE__,__LINE__);
+			ICompilableTest::assert("\xe4\xb8\x80",3,__FILE__,__LINE__);
+			ICompilableTest::assert("\xe4\xb8\x81",255,__FILE__,__LINE__);
+			ICompilableTest::assert("\xe4\xbb\xbe",3,__FILE__,__LINE__);
+			ICompilableTest::assert("\xe4\xbc\x80",255,__FILE__,__LINE__);
+			ICompilableTest::clearFiles();
+			delete il;
 		}
 
 		void testName() 
@@ -267,6 +288,18 @@ namespace pgen
 			il->add(13);
 			il->add(11);
 			CPPUNIT_ICOMPILABLE_ASSERTNAME(*il, "cl_10_13");
+			// classes with many ranges are named by the id of their ranges.
+			CharClass many, same;
+			for (unsigned int c = 'a'; c <= 'z'; c += 2)
+			{
+				many.add(c);
+				same.add(c);
+			}
+			CPPUNIT_ICOMPILABLE_ASSERTNAME(many, same.name());
+			CPPUNIT_ASSERT(many.name().substr(0, 2) == "cl");
+			CPPUNIT_ASSERT(many.name().find_first_not_of("0123456789", 2) == string::npos);
+			same.add('b');
+			CPPUNIT_ASSERT(many.name() != same.name());
 		}
 
 	}; /* class CharClassTest */
@@ -20,6 +20,7 @@
 // Used Objects
 #include "../expr/Code.h"
 #include "../expr/Regex.h"
+#include "../expr/Simplifier.h"
 #include "../parser/NamedClassManager.h"
 #include "ICompilable_Test.h"
 
@@ -44,6 +45,9 @@ namespace pgen
 		{
 			CppUnit::TestSuite * s = new CppUnit::TestSuite("CodeTest");
 			s->addTest(new CppUnit::TestCaller<CodeTest>("CodeTest::testCompile", &CodeTest::testCompile));
+			s->addTest(new CppUnit::TestCaller<CodeTest>("CodeTest::testReachable", &CodeTest::testReachable));
+			s->addTest(new CppUnit::TestCaller<CodeTest>("CodeTest::testArena", &CodeTest::testArena));
+			s->addTest(new CppUnit::TestCaller<CodeTest>("CodeTest::testOptional", &CodeTest::testOptional));
 			return s;
 		}
 
@@ -104,6 +108,87 @@ namespace pgen
 			ICompilableTest::clearFiles();
 		}
 
+		/**
+		 * The functions that are never called by the added expressions are not part of the code.
+		 */
+		void testReachable()
+		{
+			NamedClassManager ncm;
+			Regex r("(ab)*c", ncm);
+			Simplifier::simplify(r);
+			// the repeated text is compared inline by the quantifier (see Quantified::literal())
+			ICompilable* text = r.expr[0]->dependences()[0]->dependences()[0];
+			Code c;
+			c.add(&r);
+			string code = c.code();
+			CPPUNIT_ASSERT(code.find(r.funcname() + "(") != string::npos);
+			CPPUNIT_ASSERT(code.find(text->funcname() + "(") == string::npos);
+			CPPUNIT_ASSERT(code.find(text->cfuncname() + "(") == string::npos);
+		}
+
+		/**
+		 * The nodes allocated after a mark of the arena are reused after the arena is reset to the mark, and the 
+		 * blocks of the arena are kept until it is freed (GCC is required).
+		 */
+		void testArena()
+		{
+			ofstream o("___test___.c");
+			o << Code::getHeader() << endl << Code::getHelper() << endl << 
+				 "int main() {"														"\n"
+				 " ast_arena arena = { NULL, NULL, 0 };"								"\n"
+				 " ast_node* first = ast_arena_new_node(&arena);"					"\n"
+				 " ast_mark mark = ast_arena_mark(&arena);"							"\n"
+				 " ast_node* node = ast_arena_new_node(&arena);"					"\n"
+				 " ast_block* block;"												"\n"
+				 " int i;"															"\n"
+				 " first->tokenId = 1;"												"\n"
+				 " for (i = 0; i < 1000; i++) ast_arena_new_node(&arena)->tokenId = i;\n"
+				 " block = arena.block;"												"\n"
+				 " if (block == arena.first || first->tokenId != 1) return 1;"		"\n"
+				 " ast_arena_reset(&arena, mark);"									"\n"
+				 " if (ast_arena_new_node(&arena) != node) return 2;"				"\n"
+				 " if (node->tokenId != -1 || node->firstChild != NULL) return 3;"	"\n"
+				 " for (i = 0; i < 1000; i++) ast_arena_new_node(&arena);"			"\n"
+				 " if (arena.block != block) return 4;"								"\n"
+				 " ast_arena_free(&arena);"											"\n"
+				 " return (arena.first == NULL && arena.block == NULL ? 0 : 5);"	"\n"
+				 "}"																"\n";
+			o.close();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___") >> 8;
+			CPPUNIT_ASSERT_EQUAL(0, res);
+			ICompilableTest::clearFiles();
+		}
+
+		/**
+		 * The optional helpers are only part of the helper code when the generated code calls them.
+		 */
+		void testOptional()
+		{
+			NamedClassManager ncm;
+			Regex r("(a|ab)*c", ncm);
+			Code c;
+			c.add(&r);
+			string helper = Code::getHelper(c.code());
+			// the quantifier can not be counted, so it uses a stack
+			CPPUNIT_ASSERT(helper.find("void stack_int_push(stack_int* s, int val) {") != string::npos);
+			CPPUNIT_ASSERT(helper.find("nfa_match") == string::npos);
+			CPPUNIT_ASSERT(helper.find("bp_match") == string::npos);
+			CPPUNIT_ASSERT(helper.find("ast_copy") == string::npos);
+			CPPUNIT_ASSERT(helper.find("ast_wrap") == string::npos);
+			CPPUNIT_ASSERT(helper.find("ast_flatten") == string::npos);
+			CPPUNIT_ASSERT(Code::getHelper("").find("stack_int") == string::npos);
+			// the declarations and the definitions are selected together
+			helper = Code::getInternal(" return nfa_match(prog, 8, ranges, text);");
+			CPPUNIT_ASSERT(helper.find("int nfa_match(") != string::npos);
+			CPPUNIT_ASSERT(helper.find("bp_automaton") == string::npos);
+			helper = Code::getRuntime(" return nfa_match(prog, 8, ranges, text);");
+			CPPUNIT_ASSERT(helper.find("int nfa_add(") != string::npos);
+			CPPUNIT_ASSERT(helper.find("int bp_match(") == string::npos);
+			CPPUNIT_ASSERT(Code::getHelper().find("ast_flat_node* ast_flatten(") != string::npos);
+		}
+
 		void testName() 
 		{
 			//CPPUNIT_ICOMPILABLE_ASSERTNAME(alt, "al_sq_ch_114_ch_101_sq_ch_100_ch_105");
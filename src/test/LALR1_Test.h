@@ -0,0 +1,198 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-28
+ * \tabsize 4
+ * \file
+ * This file contains an unit test fixture for testing the LALR1 class. 
+ */
+ 
+#ifndef LALR1_TEST_H_
+#define LALR1_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+#include <fstream>
+#include <vector>
+// pgen
+#include "../parser/TableRule.h"
+#include "../parser/LALR1.h"
+#include "../parser/Language.h"
+#include "../expr/Code.h"
+
+using namespace std;
+namespace pgen
+{
+	class LALR1Test
+	 : public CppUnit::TestFixture
+	{
+	private:
+		Language *lang;
+		
+		/**
+		 * Adds the expression rule to the grammar.
+		 * \param alternatives the names of the symbols of each alternative.
+		 */
+		void addExpression(vector<vector<string>> alternatives)
+		{
+			string name("expression");
+			lang->ruleList.push_back(name);
+			lang->startRule = lang->getNonTerminalId(name);
+			TableRule* rule = new TableRule(lang, name);
+			for (auto& alternative: alternatives)
+			{
+				vector<int>* symbolList = new vector<int>();
+				for (auto& symbol: alternative)
+				{
+					symbolList->push_back(lang->getSymbolId(symbol));
+				}
+				rule->symbols.push_back(symbolList);
+			}
+			lang->grammar->rules.push_back(rule);
+		}
+	public:
+		
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test* suite() 
+		{
+			using namespace CppUnit;
+			TestSuite * s = new TestSuite("LALR1Test");
+			s->addTest(new TestCaller<LALR1Test>("LALR1Test::testTable", &LALR1Test::testTable));
+			s->addTest(new TestCaller<LALR1Test>("LALR1Test::testConflict", &LALR1Test::testConflict));
+			s->addTest(new TestCaller<LALR1Test>("LALR1Test::testCompile", &LALR1Test::testCompile));
+			return s;
+		}
+		
+		/**
+		 * Test preparations: the tokens of a simple arithmetic expression.
+		 */
+		void setUp() 
+		{
+			lang = new Language();
+			lang->name = "Test";
+			lang->prefix = "UT_";
+			lang->stateList.insert("default");
+			lang->startStateName = "default";
+			lang->startState = lang->getStateId(lang->startStateName);
+			int def = lang->getStateId("default");
+			int* validStates;
+			validStates = new int[2]; validStates[0] = def; validStates[1] = -1;
+			lang->tokenizer.add("[ \\t]+","$WHITESPACE",-1,validStates);
+			validStates = new int[2]; validStates[0] = def; validStates[1] = -1;			
+			lang->tokenizer.add("\\d*\\.\\d+","NUMBER",-1,validStates);
+			validStates = new int[2]; validStates[0] = def; validStates[1] = -1;
+			lang->tokenizer.add("[\\+\\-\\*\\/]","OPERATOR",-1,validStates);
+			lang->grammar = new LALR1(lang);
+		}
+		
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+			delete lang;
+		}
+		
+		/**
+		 * Test the automaton of a left-recursive grammar:
+		 * 0: expression' -> . expression 
+		 * 1: expression -> NUMBER .
+		 * 2: expression' -> expression .      expression -> expression . OPERATOR NUMBER
+		 * 3: expression -> expression OPERATOR . NUMBER
+		 * 4: expression -> expression OPERATOR NUMBER .
+		 */
+		void testTable()
+		{
+			addExpression({ { "expression", "OPERATOR", "NUMBER" }, { "NUMBER" } });
+			LALR1* grammar = reinterpret_cast<LALR1*>(lang->grammar);
+			CPPUNIT_ASSERT_EQUAL(0u, grammar->analyzeTable());
+			CPPUNIT_ASSERT_EQUAL((size_t)5, grammar->kernels.size());
+			int op = lang->getSymbolId("OPERATOR");
+			int number = lang->getSymbolId("NUMBER");
+			CPPUNIT_ASSERT_EQUAL(1 + 1, grammar->actions[0][number]);
+			CPPUNIT_ASSERT_EQUAL(3 + 1, grammar->actions[2][op]);
+			CPPUNIT_ASSERT(grammar->defaults[2] == LALR1::ACCEPT);
+			// the reductions are the default actions of their states, but the end of the token list keeps its action
+			CPPUNIT_ASSERT_EQUAL((size_t)1, grammar->actions[1].size());
+			CPPUNIT_ASSERT_EQUAL(-2 - 1, grammar->actions[1][-1]);
+			CPPUNIT_ASSERT_EQUAL(-2 - 1, grammar->defaults[1]);
+			CPPUNIT_ASSERT_EQUAL(-1 - 1, grammar->defaults[4]);
+		}
+
+		/**
+		 * Test the report of the conflicts of an ambiguous grammar, where the shift is used.
+		 */
+		void testConflict()
+		{
+			addExpression({ { "expression", "OPERATOR", "expression" }, { "NUMBER" } });
+			LALR1* grammar = reinterpret_cast<LALR1*>(lang->grammar);
+			CPPUNIT_ASSERT_EQUAL(1u, grammar->analyzeTable());
+			// expression -> expression OPERATOR expression .      expression -> expression . OPERATOR expression
+			int state = grammar->transitions[grammar->transitions[2][lang->getSymbolId("OPERATOR")]][1000000000];
+			CPPUNIT_ASSERT(grammar->actions[state][lang->getSymbolId("OPERATOR")] > 0);
+		}
+		
+		/**
+		 * Test the compilation of the LALR1 parser (GCC is required).
+		 */
+		void testCompile()
+		{
+			addExpression({ { "expression", "OPERATOR", "NUMBER" }, { "NUMBER" } });
+			system("rm -f ___test___.c"); 								// remove source
+			ofstream o("___test___.c");
+			o << Code::getHeader() << endl << Code::helperCode << endl;
+			lang->compile(o);
+			o << endl << flush <<
+				 "int depth(ast_node* ast) {"								"\n"
+				 " int d = 0;"												"\n"
+				 " for (; ast->tokenId == 1000000000; ast = ast->firstChild) {"	"\n"
+				 "  if (ast->firstChild->nextSibling != NULL && "			"\n"
+				 "      ast->firstChild->nextSibling->nextSibling->tokenId != 1) return -1;"	"\n"
+				 "  d++;"													"\n"
+				 " }"														"\n"
+				 " return d;"												"\n"
+				 "}"														"\n\n"
+				 "int main(int argc, char* argv[]) {"						"\n"
+				 " int pos = 0;"											"\n"
+				 " int i, n = atoi(argv[1]);"								"\n"
+				 " char* text = (char*) malloc(5 * n + 10);"				"\n"
+				 " token_list* tokens;"										"\n"
+				 " ast_node* ast;"											"\n"
+				 " for (i = 0; i < n; i++) strcpy(text + 5 * i, \"1.2 +\");"	"\n"
+				 " strcpy(text + 5 * n - 2, argv[2]);"						"\n"
+				 " tokens = UT_tokenize_string(text);"						"\n"
+				 " if (tokens == NULL) return 255;"							"\n"
+				 " ast = UT_parse(tokens, &pos);"							"\n"
+				 " if (ast == NULL) return pos == 0 ? 254 : 253;"			"\n"
+				 " return depth(ast) == n ? pos : 252;"						"\n"
+				 "}"														"\n";
+			o.close();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ 3 \"\"") >> 8;					// "1.2 +1.2 +1.2"
+			CPPUNIT_ASSERT_EQUAL(5, res);
+			// the parser stops after the longest list of tokens that matches the starting rule
+			res = system("./___test___ 3 \" .5\"") >> 8;				// "1.2 +1.2 +1.2 .5"
+			CPPUNIT_ASSERT_EQUAL(5, res);
+			// even when the tokens after it were shifted before the error was found
+			res = system("./___test___ 3 \"+\"") >> 8;					// "1.2 +1.2 +1.2+"
+			CPPUNIT_ASSERT_EQUAL(5, res);
+			res = system("./___test___ 3 \"+ +\"") >> 8;				// "1.2 +1.2 +1.2+ +"
+			CPPUNIT_ASSERT_EQUAL(5, res);
+			res = system("./___test___ 1 \"+\"") >> 8;					// "1.2+"
+			CPPUNIT_ASSERT_EQUAL(1, res);
+			// the left recursion does not grow the stacks
+			res = system("./___test___ 100000 \"\"") >> 8;
+			CPPUNIT_ASSERT_EQUAL((2 * 100000 - 1) & 255, res);
+		}
+	}; /* class LALR1Test */
+} /* namespace pgen */
+
+#endif /* LALR1_TEST_H_ */
@@ -0,0 +1,226 @@
+/**
+ * \author Dimas Melo Filho
+ * \date 2015-05-27
+ * \tabsize 4
+ * \file
+ * This file contains an unit test fixture for testing the LL1 and the TableRule classes. 
+ */
+ 
+#ifndef LL1_TEST_H_
+#define LL1_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+#include <fstream>
+#include <vector>
+// pgen
+#include "../parser/TableRule.h"
+#include "../parser/LL1.h"
+#include "../parser/Language.h"
+#include "../expr/Code.h"
+#include "../misc/LanguageException.h"
+
+using namespace std;
+namespace pgen
+{
+	class LL1Test
+	 : public CppUnit::TestFixture
+	{
+	private:
+		Language *lang;
+		
+		/**
+		 * Adds a rule to the grammar.
+		 * \param name the name of the rule.
+		 * \param alternatives the names of the symbols of each alternative.
+		 */
+		void addRule(string name, vector<vector<string>> alternatives)
+		{
+			TableRule* rule = new TableRule(lang, name);
+			for (auto& alternative: alternatives)
+			{
+				vector<int>* symbolList = new vector<int>();
+				for (auto& symbol: alternative)
+				{
+					symbolList->push_back(lang->getSymbolId(symbol));
+				}
+				rule->symbols.push_back(symbolList);
+			}
+			lang->grammar->rules.push_back(rule);
+		}
+	public:
+		
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test* suite() 
+		{
+			using namespace CppUnit;
+			TestSuite * s = new TestSuite("LL1Test");
+			s->addTest(new TestCaller<LL1Test>("LL1Test::testTable", &LL1Test::testTable));
+			s->addTest(new TestCaller<LL1Test>("LL1Test::testConflict", &LL1Test::testConflict));
+			s->addTest(new TestCaller<LL1Test>("LL1Test::testLeftRecursion", &LL1Test::testLeftRecursion));
+			s->addTest(new TestCaller<LL1Test>("LL1Test::testCompile", &LL1Test::testCompile));
+			return s;
+		}
+		
+		/**
+		 * Test preparations: the tokens of a simple arithmetic expression.
+		 */
+		void setUp() 
+		{
+			lang = new Language();
+			lang->name = "Test";
+			lang->prefix = "UT_";
+			lang->stateList.insert("default");
+			lang->startStateName = "default";
+			lang->startState = lang->getStateId(lang->startStateName);
+			int def = lang->getStateId("default");
+			int* validStates;
+			validStates = new int[2]; validStates[0] = def; validStates[1] = -1;
+			lang->tokenizer.add("[ \\t]+","$WHITESPACE",-1,validStates);
+			validStates = new int[2]; validStates[0] = def; validStates[1] = -1;			
+			lang->tokenizer.add("\\d*\\.\\d+","NUMBER",-1,validStates);
+			validStates = new int[2]; validStates[0] = def; validStates[1] = -1;
+			lang->tokenizer.add("[\\+\\-\\*\\/]","OPERATOR",-1,validStates);
+			lang->grammar = new LL1(lang);
+		}
+		
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+			delete lang;
+		}
+
+		/**
+		 * Adds the rules of a left-factored expression grammar:
+		 * expression: NUMBER tail
+		 * tail: OPERATOR expression | ''
+		 */
+		void addExpression()
+		{
+			lang->ruleList.push_back("expression");
+			lang->ruleList.push_back("tail");
+			lang->startRule = lang->getNonTerminalId("expression");
+			addRule("expression", { { "NUMBER", "tail" } });
+			addRule("tail", { { "OPERATOR", "expression" }, { } });
+		}
+		
+		/**
+		 * Test the parse table of a LL(1) grammar.
+		 */
+		void testTable()
+		{
+			addExpression();
+			LL1* grammar = reinterpret_cast<LL1*>(lang->grammar);
+			CPPUNIT_ASSERT_EQUAL(0u, grammar->analyzeTable());
+			int number = lang->getSymbolId("NUMBER");
+			int op = lang->getSymbolId("OPERATOR");
+			CPPUNIT_ASSERT_EQUAL(0, grammar->table[0][number+1]);
+			CPPUNIT_ASSERT_EQUAL(-1, grammar->table[0][op+1]);
+			CPPUNIT_ASSERT_EQUAL(-1, grammar->table[0][0]);
+			CPPUNIT_ASSERT_EQUAL(0, grammar->table[1][op+1]);
+			CPPUNIT_ASSERT_EQUAL(-1, grammar->table[1][number+1]);
+			// the empty alternative is chosen at the end of the token list (the FOLLOW set of the tail)
+			CPPUNIT_ASSERT_EQUAL(1, grammar->table[1][0]);
+		}
+
+		/**
+		 * Test the rejection of the conflicts, which are only resolved in favor of the first alternative when the 
+		 * language asks for it.
+		 */
+		void testConflict()
+		{
+			lang->ruleList.push_back("expression");
+			lang->startRule = lang->getNonTerminalId("expression");
+			addRule("expression", { { "NUMBER", "OPERATOR", "expression" }, { "NUMBER" } });
+			LL1* grammar = reinterpret_cast<LL1*>(lang->grammar);
+			CPPUNIT_ASSERT_THROW(grammar->analyzeTable(), LanguageException);
+			lang->resolveConflicts = true;
+			CPPUNIT_ASSERT_EQUAL(1u, grammar->analyzeTable());
+			CPPUNIT_ASSERT_EQUAL(0, grammar->table[0][lang->getSymbolId("NUMBER")+1]);
+		}
+		
+		/**
+		 * Test the rejection of left-recursive rules, directly and through a rule that can match an empty list of 
+		 * tokens, which the parser would expand forever.
+		 */
+		void testLeftRecursion()
+		{
+			lang->ruleList.push_back("expression");
+			lang->ruleList.push_back("sign");
+			lang->startRule = lang->getNonTerminalId("expression");
+			addRule("expression", { { "expression", "OPERATOR", "expression" }, { "NUMBER" } });
+			addRule("sign", { { "OPERATOR" }, { } });
+			LL1* grammar = reinterpret_cast<LL1*>(lang->grammar);
+			CPPUNIT_ASSERT_THROW(grammar->analyzeTable(), LanguageException);
+			string name = "expression";
+			delete grammar->rules[0];
+			grammar->rules[0] = new TableRule(lang, name);
+			grammar->rules[0]->symbols.push_back(new vector<int>({ lang->getSymbolId("sign"), 
+				lang->getSymbolId("expression") }));
+			grammar->rules[0]->symbols.push_back(new vector<int>({ lang->getSymbolId("NUMBER") }));
+			CPPUNIT_ASSERT_THROW(grammar->analyzeTable(), LanguageException);
+			grammar->rules[0]->symbols[0]->at(0) = lang->getSymbolId("OPERATOR");
+			CPPUNIT_ASSERT_EQUAL(0u, grammar->analyzeTable());
+		}
+		
+		/**
+		 * Test the compilation of the LL1 parser (GCC is required).
+		 */
+		void testCompile()
+		{
+			addExpression();
+			system("rm -f ___test___.c"); 								// remove source
+			ofstream o("___test___.c");
+			o << Code::getHeader() << endl << Code::helperCode << endl;
+			lang->compile(o);
+			o << endl << flush <<
+				 "int depth(ast_node* ast) {"								"\n"
+				 " int d = 0;"												"\n"
+				 " for (; ast != NULL; ast = ast->firstChild->nextSibling) {"	"\n"
+				 "  if (ast->tokenId != 1000000000) return -1;"				"\n"
+				 "  ast = ast->firstChild->nextSibling;"					"\n"
+				 "  if (ast->tokenId != 1000000001) return -1;"				"\n"
+				 "  d++;"													"\n"
+				 "  if (ast->firstChild == NULL) return d;"					"\n"
+				 " }"														"\n"
+				 " return -1;"												"\n"
+				 "}"														"\n\n"
+				 "int main(int argc, char* argv[]) {"						"\n"
+				 " int pos = 0;"											"\n"
+				 " int i, n = atoi(argv[1]);"								"\n"
+				 " char* text = (char*) malloc(5 * n + 1);"					"\n"
+				 " token_list* tokens;"										"\n"
+				 " ast_node* ast;"											"\n"
+				 " for (i = 0; i < n; i++) strcpy(text + 5 * i, \"1.2 +\");"	"\n"
+				 " strcpy(text + 5 * n - 2, argv[2]);"						"\n"
+				 " tokens = UT_tokenize_string(text);"						"\n"
+				 " if (tokens == NULL) return 255;"							"\n"
+				 " ast = UT_parse(tokens, &pos);"							"\n"
+				 " if (ast == NULL) return pos == 0 ? 254 : 253;"			"\n"
+				 " return depth(ast) == n && pos == tokens->count;"			"\n"
+				 "}"														"\n";
+			o.close();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ 3 \"\"") >> 8;					// "1.2 +1.2 +1.2"
+			CPPUNIT_ASSERT_EQUAL(1, res);
+			res = system("./___test___ 3 \"+\"") >> 8;					// "1.2 +1.2 +1.2+"
+			CPPUNIT_ASSERT_EQUAL(254, res);
+			// nested deeply enough to overflow the stack of a recursive parser
+			res = system("./___test___ 200000 \"\"") >> 8;
+			CPPUNIT_ASSERT_EQUAL(1, res);
+		}
+	}; /* class LL1Test */
+} /* namespace pgen */
+
+#endif /* LL1_TEST_H_ */
@@ -3,7 +3,7 @@
  * \date 2015-01-26
  * \tabsize 4
  * \file
- * This file contains an unit test fixture for testing the LLStar and the LLStarRule classes. 
+ * This file contains an unit test fixture for testing the LLStar, the LLStarRule and the OperatorRule classes. 
  */
  
 #ifndef LLSTAR_TEST_H_
@@ -19,11 +19,15 @@
 #include <sstream>
 #include <string>
 #include <fstream>
+#include <set>
+#include <vector>
 // pgen
 #include "../parser/LLStarRule.h"
 #include "../parser/LLStar.h"
+#include "../parser/OperatorRule.h"
 #include "../parser/Language.h"
 #include "../expr/Code.h"
+#include "../misc/LanguageException.h"
 
 using namespace std;
 namespace pgen
@@ -43,6 +47,13 @@ namespace pgen
 			using namespace CppUnit;
 			TestSuite * s = new TestSuite("LLStarTest");
 			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testCompile", &LLStarTest::testCompile));
+			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testCompileUnits", &LLStarTest::testCompileUnits));
+			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testDispatch", &LLStarTest::testDispatch));
+			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testPackrat", &LLStarTest::testPackrat));
+			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testOperator", &LLStarTest::testOperator));
+			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testLeftRecursion", &LLStarTest::testLeftRecursion));
+			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testDeferred", &LLStarTest::testDeferred));
+			s->addTest(new TestCaller<LLStarTest>("LLStarTest::testFlat", &LLStarTest::testFlat));
 			return s;
 		}
 		
@@ -98,9 +109,10 @@ namespace pgen
 		}
 		
 		/**
-		 * Test the compilation of the LLStar (and LLStarRule) (GCC is required).
+		 * Writes the compiled language and a program that checks the tree parsed from argv[1] against the 
+		 * representation on argv[2] to ___test___.c.
 		 */
-		void testCompile()
+		void writeChecker()
 		{
 			system("rm -f ___test___.c"); 								// remove source
 			ofstream o("___test___.c");
@@ -135,6 +147,18 @@ namespace pgen
 				 " return compare_tree(ast, &check);"						"\n"
 				 "}"														"\n";
 			o.close();
+		}
+
+		/**
+		 * Test the compilation of the LLStar (and LLStarRule) (GCC is required).
+		 */
+		void testCompile()
+		{
+			// the children are linked in order, the tree is not inverted after parsing
+			CPPUNIT_ASSERT(lang->grammar->compile().find("ast_invert_siblings") == string::npos);
+			CPPUNIT_ASSERT(Code::getRuntime().find("ast_invert_siblings") == string::npos);
+			CPPUNIT_ASSERT(Code::getHeader().find("ast_invert_siblings") == string::npos);
+			writeChecker();
 			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
 			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
 			res = system("./___test___ \"1.2 * \t /* test */ 5.11 + 2.56\" "
@@ -147,6 +171,340 @@ namespace pgen
 						 "\"1000000000(4(),5(),5(),1000000000(4(),5(),1000000000(4())))\"") >> 8;
 			CPPUNIT_ASSERT( res == 0 );
 		}
+
+		/**
+		 * Test the compilation of the LLStar into multiple translation units, that are compiled separately and then 
+		 * linked together (GCC is required).
+		 */
+		void testCompileUnits()
+		{
+			string numberRuleName("number");
+			LLStarRule* rule = new LLStarRule(lang, numberRuleName);
+			vector<int>* symbolList = new vector<int>();
+			symbolList->push_back(lang->getSymbolId("NUMBER"));
+			rule->symbols.push_back(symbolList);
+			lang->ruleList.push_back("number");
+			lang->grammar->rules.push_back(rule);
+			vector<string> units;
+			lang->compileParser(units, 1);
+			CPPUNIT_ASSERT(units.size() == 1);
+			units.clear();
+			lang->compileParser(units, 4);
+			CPPUNIT_ASSERT(units.size() == 2);
+			stringstream lexer;
+			lang->compileLexer(lexer);
+			string code = lexer.str() + units[0] + units[1];
+			system("rm -f ___test___*"); 								// remove sources
+			ofstream o("___test___.h");
+			lang->compileHeader(o);
+			o.close();
+			o.open("___test____internal.h");
+			lang->compileInternalHeader(o, "___test___.h", code);
+			o.close();
+			o.open("___test____runtime.c");
+			o << "#include \"___test____internal.h\"" << endl << Code::getRuntime(code);
+			o.close();
+			o.open("___test____lexer.c");
+			o << "#include \"___test____internal.h\"" << endl << lexer.str();
+			o.close();
+			for (unsigned int i = 0; i < units.size(); i++)
+			{
+				o.open("___test____parser" + to_string(i) + ".c");
+				o << "#include \"___test____internal.h\"" << endl << units[i];
+				o.close();
+			}
+			o.open("___test___.c");
+			o << "#include \"___test____internal.h\""					"\n"
+				 "int main(int argc, char* argv[]) {"						"\n"
+				 " int pos = 0;"											"\n"
+				 " token_list* tokens = UT_tokenize_string(argv[1]);"		"\n"
+				 " if (tokens == NULL) return 0;"							"\n"
+				 " return UT_parse(tokens, &pos) != NULL;"					"\n"
+				 "}"														"\n";
+			o.close();
+			int res = system("gcc -c ___test___*.c") >> 8;				// compile each unit using gcc
+			CPPUNIT_ASSERT( res == 0 );
+			res = system("gcc -o ___test___ ___test___*.o") >> 8;		// link the units
+			CPPUNIT_ASSERT( res == 0 );
+			res = system("./___test___ \"1.2 * 5.11 + 2.56\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			res = system("./___test___ \"+ 1.2\"") >> 8;
+			CPPUNIT_ASSERT( res == 0 );
+		}
+		/**
+		 * Test the dispatch of the alternatives on the FIRST sets of the current token: the failure of an alternative
+		 * only jumps to the next alternative when both can start with the same token.
+		 */
+		void testDispatch()
+		{
+			int number = lang->getSymbolId("NUMBER");
+			int op = lang->getSymbolId("OPERATOR");
+			lang->ruleList.push_back("operand");
+			string operandRuleName("operand");
+			LLStarRule* rule = new LLStarRule(lang, operandRuleName);
+			vector<int>* symbolList = new vector<int>();
+			symbolList->push_back(op);
+			symbolList->push_back(number);
+			rule->symbols.push_back(symbolList);
+			symbolList = new vector<int>();
+			symbolList->push_back(number);
+			rule->symbols.push_back(symbolList);
+			lang->grammar->rules.push_back(rule);
+			lang->grammar->analyze();
+			set<int> first;
+			CPPUNIT_ASSERT(!lang->grammar->first(vector<int>(1, lang->getSymbolId("expression")), first));
+			CPPUNIT_ASSERT(first == set<int>({number}));
+			first.clear();
+			CPPUNIT_ASSERT(!lang->grammar->first(vector<int>(1, lang->getSymbolId("operand")), first));
+			CPPUNIT_ASSERT(first == set<int>({number, op}));
+			first.clear();
+			CPPUNIT_ASSERT(lang->grammar->first(vector<int>(), first));
+			CPPUNIT_ASSERT(first.empty());
+			// both alternatives of the expression start with a NUMBER: the failure of the first one tries the second
+			string code = lang->grammar->rules[0]->compile();
+			CPPUNIT_ASSERT(code.find(" switch (type) {\n  case " + to_string(number) + ":\n   goto UT_parse_expression_alt0;\n"
+				"  default:\n   goto UT_parse_expression_fail;\n }\n") != string::npos);
+			CPPUNIT_ASSERT(code.find("UT_parse_expression_0:\n *pos = opos;\n ast_arena_reset(&tokens->arena, mark);\n"
+				" subtree->firstChild = NULL;\n"
+				"UT_parse_expression_alt1:\n") == string::npos);
+			// the token that selected the alternatives is not checked again
+			CPPUNIT_ASSERT(code.find("UT_parse_expression_0:\n *pos = opos;\n ast_arena_reset(&tokens->arena, mark);\n"
+				" subtree->firstChild = NULL;\n"
+				" subtree->firstChild = ast_arena_new_node(&tokens->arena);\n") != string::npos);
+			CPPUNIT_ASSERT(code.find(" if (tokens->items[*pos].type != " + to_string(number)) == string::npos);
+			// the alternatives of the operand start with different tokens: the failure of the first one fails the rule
+			code = rule->compile();
+			CPPUNIT_ASSERT(code.find("  case " + to_string(op) + ":\n   goto UT_parse_operand_alt0;\n") != string::npos);
+			CPPUNIT_ASSERT(code.find("  case " + to_string(number) + ":\n   goto UT_parse_operand_alt1;\n") != string::npos);
+			CPPUNIT_ASSERT(code.find("UT_parse_operand_0:\n *pos = opos;\n ast_arena_reset(&tokens->arena, mark);\n"
+				" subtree->firstChild = NULL;\n"
+				" goto UT_parse_operand_fail;\n") != string::npos);
+		}
+		/**
+		 * Test the memoization of the re-entered rules on the packrat mode (GCC is required).
+		 */
+		void testPackrat()
+		{
+			// expression: term OPERATOR expression | term
+			// term: NUMBER
+			int term = lang->getNonTerminalId("expression") + 1;
+			lang->ruleList.push_back("term");
+			string termRuleName("term");
+			LLStarRule* rule = new LLStarRule(lang, termRuleName);
+			vector<int>* symbolList = new vector<int>();
+			symbolList->push_back(lang->getSymbolId("NUMBER"));
+			rule->symbols.push_back(symbolList);
+			lang->grammar->rules.push_back(rule);
+			lang->grammar->rules[0]->symbols[0]->at(0) = term;
+			lang->grammar->rules[0]->symbols[1]->at(0) = term;
+			lang->grammar->analyze();
+			CPPUNIT_ASSERT(lang->grammar->reentered() == vector<int>(1, 1));
+			CPPUNIT_ASSERT(lang->grammar->rules[1]->compile().find("_nomemo") == string::npos);
+			lang->packrat = true;
+			CPPUNIT_ASSERT(lang->grammar->rules[0]->compile().find("_nomemo") == string::npos);
+			CPPUNIT_ASSERT(lang->grammar->rules[1]->compile().find("UT_parse_term_nomemo(tokens, pos)") != string::npos);
+			writeChecker();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ \"1.2 * 5.11 + 2.56\" "
+						 "\"1000000000(1000000001(4()),5(),1000000000(1000000001(4()),5(),1000000000(1000000001(4()))))\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			// the term of the second alternative is the copy of the one parsed by the first alternative
+			res = system("./___test___ \"1.2 * 5.11 +\" "
+						 "\"1000000000(1000000001(4()),5(),1000000000(1000000001(4())))\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+		}
+
+		/**
+		 * Test the precedence and the associativity of the operators of an operator rule (GCC is required).
+		 */
+		void testOperator()
+		{
+			int* validStates;
+			validStates = new int[2]; validStates[0] = lang->getStateId("default"); validStates[1] = -1;
+			lang->tokenizer.add("\\^","POW",-1,validStates);
+			validStates = new int[2]; validStates[0] = lang->getStateId("default"); validStates[1] = -1;
+			lang->tokenizer.add("!","NOT",-1,validStates);
+			string exprRuleName("expression");
+			YAML::Node ruleNode = YAML::Load("{operand: NUMBER, operators: [{left: [OPERATOR]}, {right: [POW]}, "
+				"{prefix: [NOT]}]}");
+			OperatorRule* rule = new OperatorRule(lang, exprRuleName, ruleNode);
+			CPPUNIT_ASSERT_EQUAL(3u, (unsigned int)rule->levels.size());
+			CPPUNIT_ASSERT_EQUAL(4u, (unsigned int)rule->symbols.size());
+			CPPUNIT_ASSERT(*rule->symbols[1] == vector<int>({1000000000, 5, 1000000000}));
+			CPPUNIT_ASSERT(*rule->symbols[3] == vector<int>({7, 1000000000}));
+			delete lang->grammar->rules[0];
+			lang->grammar->rules[0] = rule;
+			ruleNode = YAML::Load("{operand: NUMBER, operators: [{none: [POW]}]}");
+			CPPUNIT_ASSERT_THROW(OperatorRule(lang, exprRuleName, ruleNode), LanguageException);
+			ruleNode = YAML::Load("{operand: NUMBER, operators: [{left: [POW]}, {right: [POW]}]}");
+			CPPUNIT_ASSERT_THROW(OperatorRule(lang, exprRuleName, ruleNode), LanguageException);
+			writeChecker();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ \"1.2\" \"1000000000(4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			// left associative
+			res = system("./___test___ \"1.2 - .5 - .3\" "
+						 "\"1000000000(1000000000(4(),5(),4()),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			// right associative
+			res = system("./___test___ \"1.2 ^ .5 ^ .3\" "
+						 "\"1000000000(4(),6(),1000000000(4(),6(),4()))\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			// precedence
+			res = system("./___test___ \"1.2 + .5 ^ .3 * .2\" "
+						 "\"1000000000(1000000000(4(),5(),1000000000(4(),6(),4())),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			res = system("./___test___ \"! 1.2 ^ .5\" "
+						 "\"1000000000(1000000000(7(),4()),6(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			// an operator without its right operand is not consumed
+			res = system("./___test___ \"1.2 + .5 ^\" "
+						 "\"1000000000(4(),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+		}
+
+		/**
+		 * Test the elimination of the direct and indirect left recursion, and the left-associative trees parsed by the 
+		 * loops, which keep the nodes of the inlined rules (GCC is required).
+		 */
+		void testLeftRecursion()
+		{
+			// expression: term OPERATOR NUMBER | NUMBER
+			// term: expression OPERATOR | NUMBER
+			int expression = lang->getNonTerminalId("expression");
+			int number = lang->getSymbolId("NUMBER");
+			int op = lang->getSymbolId("OPERATOR");
+			lang->ruleList.push_back("term");
+			string termRuleName("term");
+			LLStarRule* term = new LLStarRule(lang, termRuleName);
+			term->symbols.push_back(new vector<int>({ expression, op }));
+			term->symbols.push_back(new vector<int>({ number }));
+			lang->grammar->rules.push_back(term);
+			IGrammarRule* rule = lang->grammar->rules[0];
+			*rule->symbols[0] = vector<int>({ expression + 1, op, number });
+			lang->grammar->eliminateLeftRecursion();
+			CPPUNIT_ASSERT_EQUAL(2u, (unsigned int)rule->symbols.size());
+			CPPUNIT_ASSERT(*rule->symbols[0] == vector<int>({ number, op, number }));
+			CPPUNIT_ASSERT(*rule->symbols[1] == vector<int>({ number }));
+			CPPUNIT_ASSERT_EQUAL(1u, (unsigned int)rule->loops.size());
+			CPPUNIT_ASSERT(*rule->loops[0] == vector<int>({ op, op, number }));
+			CPPUNIT_ASSERT(term->loops.empty());
+			int termId = lang->getNonTerminalId("term");
+			CPPUNIT_ASSERT(rule->inlined[rule->symbols[0]] == (vector<pair<int, unsigned int>>({ { termId, 1 } })));
+			CPPUNIT_ASSERT(rule->inlined[rule->loops[0]] == (vector<pair<int, unsigned int>>({ { termId, 2 } })));
+			CPPUNIT_ASSERT(rule->inlined.count(rule->symbols[1]) == 0);
+			// the trees are the same ones parsed without the rewriting
+			writeChecker();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ \"1.2 + .5\" \"1000000000(1000000001(4()),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			res = system("./___test___ \"1.2 + .5 * - .3\" "
+						 "\"1000000000(1000000001(1000000000(1000000001(4()),5(),4()),5()),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			lang->deferred = true;
+			writeChecker();
+			res = system("gcc -o ___test___ ___test___.c") >> 8;
+			CPPUNIT_ASSERT( res == 0 );
+			res = system("./___test___ \"1.2 + .5 * - .3\" "
+						 "\"1000000000(1000000001(1000000000(1000000001(4()),5(),4()),5()),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			lang->deferred = false;
+			// a rule that leads back to a rule can not be directly left-recursive
+			term->symbols.insert(term->symbols.begin(), new vector<int>({ expression + 1, op }));
+			*rule->symbols[0] = vector<int>({ expression + 1, op, number });
+			CPPUNIT_ASSERT_THROW(lang->grammar->eliminateLeftRecursion(), LanguageException);
+			// expression: expression OPERATOR NUMBER | NUMBER
+			for (IGrammarRule* r: lang->grammar->rules)
+			{
+				for (vector<int>* loop: r->loops)
+				{
+					delete loop;
+				}
+				r->loops.clear();
+				r->inlined.clear();
+			}
+			*rule->symbols[0] = vector<int>({ expression, op, number });
+			writeChecker();
+			CPPUNIT_ASSERT(rule->symbols.size() == 1 && rule->loops.size() == 1);
+			res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ \"1.2 * 5.11 + 2.56\" "
+						 "\"1000000000(1000000000(1000000000(4()),5(),4()),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			res = system("./___test___ \"1.2 +\" \"1000000000(4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+		}
+
+		/**
+		 * Test the rules that build the nodes only when an alternative matches (GCC is required).
+		 */
+		void testDeferred()
+		{
+			lang->deferred = true;
+			lang->grammar->analyze();
+			string code = lang->grammar->rules[0]->compile();
+			CPPUNIT_ASSERT(code.find(" at[0] = (*pos)++;\n") != string::npos);
+			CPPUNIT_ASSERT(code.find("subtree->firstChild = NULL;") == string::npos);
+			CPPUNIT_ASSERT(code.find("UT_parse_expression_0:\n *pos = opos;\n ast_arena_reset(&tokens->arena, start);\n") 
+				!= string::npos);
+			writeChecker();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ \"1.2 * \t /* test */ 5.11 + 2.56\" "
+						 "\"1000000000(4(),5(),1000000000(4(),5(),1000000000(4())))\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			res = system("./___test___ \"1.2 +\" \"1000000000(4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			// expression: expression OPERATOR NUMBER | NUMBER
+			*lang->grammar->rules[0]->symbols[0] = vector<int>({ lang->getSymbolId("expression"), 
+				lang->getSymbolId("OPERATOR"), lang->getSymbolId("NUMBER") });
+			writeChecker();
+			res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 							// assert a successfull compilation
+			res = system("./___test___ \"1.2 * 5.11 + 2.56\" "
+						 "\"1000000000(1000000000(1000000000(4()),5(),4()),5(),4())\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+		}
+
+		/**
+		 * Test the flat array of nodes returned by the parse functions (GCC is required). The nodes are written as
+		 * "tokenId:firstChild:nextSibling:start:end;" in the order of the array.
+		 */
+		void testFlat()
+		{
+			lang->flat = true;
+			system("rm -f ___test___.c"); 								// remove source
+			ofstream o("___test___.c");
+			o << Code::getHeader() << endl << Code::helperCode << endl;
+			lang->compile(o);
+			o << endl << flush <<
+				 "int main(int argc, char* argv[]) {"						"\n"
+				 " char buffer[1024];"										"\n"
+				 " int i, n = 0, res;"										"\n"
+				 " parse_result* pr = UT_parse_string(argv[1]);"			"\n"
+				 " if (pr == NULL || pr->ast != NULL) return 0;"			"\n"
+				 " buffer[0] = 0;"											"\n"
+				 " for (i = 0; i < pr->flat_count; i++) {"					"\n"
+				 "  ast_flat_node* node = &pr->flat[i];"					"\n"
+				 "  n += sprintf(buffer + n, \"%d:%d:%d:%d:%d;\", node->tokenId, node->firstChild, "
+				 "node->nextSibling, node->start, node->end);"				"\n"
+				 " }"														"\n"
+				 " res = (strcmp(buffer, argv[2]) == 0);"					"\n"
+				 " parse_result_free(pr);"									"\n"
+				 " return res;"												"\n"
+				 "}"														"\n";
+			o.close();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+			res = system("./___test___ \"1.2 * 5.11 + 2.56\" \"1000000000:1:-1:0:5;4:-1:2:0:1;5:-1:3:1:2;"
+						 "1000000000:4:-1:2:5;4:-1:5:2:3;5:-1:6:3:4;1000000000:7:-1:4:5;4:-1:-1:4:5;\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+			res = system("./___test___ \"2.56\" \"1000000000:1:-1:0:1;4:-1:-1:0:1;\"") >> 8;
+			CPPUNIT_ASSERT( res == 1 );
+		}
 	}; /* class LLStarTest */
 } /* namespace pgen */
 
@@ -0,0 +1,110 @@
+/*
+ * Linear_Test.h
+ *
+ *  Created on: May 23, 2015
+ *      Author: Dimas Melo Filho
+ */
+
+#ifndef LINEAR_TEST_H_
+#define LINEAR_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+// pgen
+#include "../expr/Linear.h"
+#include "../expr/Regex.h"
+#include "../expr/Code.h"
+#include "../parser/NamedClassManager.h"
+#include "ICompilable_Test.h"
+
+using namespace std;
+namespace pgen
+{
+	/**
+	 * Unit Test Fixture for the "Linear" class.
+	 */
+	class LinearTest 
+	 : public CppUnit::TestFixture 
+	{
+	public:
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test * suite() 
+		{
+			CppUnit::TestSuite * s = new CppUnit::TestSuite("LinearTest");
+			s->addTest(new CppUnit::TestCaller<LinearTest>("LinearTest::testProgram", &LinearTest::testProgram));
+			s->addTest(new CppUnit::TestCaller<LinearTest>("LinearTest::testCompile", &LinearTest::testCompile));
+			s->addTest(new CppUnit::TestCaller<LinearTest>("LinearTest::testPriority", &LinearTest::testPriority));
+			return s;
+		}
+
+		/**
+		 * Test preparations.
+		 */
+		void setUp() 
+		{
+		}
+
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+			ICompilableTest::clearFiles();
+		}
+
+		void testProgram() 
+		{
+			NamedClassManager ncm;
+			Regex r("(a|b)*c", ncm);
+			Linear l(&r);
+			// see the example on Linear.h
+			CPPUNIT_ASSERT_EQUAL(8u, l.size());
+			CPPUNIT_ASSERT(l.name() != r.name());
+			CPPUNIT_ASSERT_EQUAL(r.str(), l.str());
+		}
+
+		/**
+		 * Expressions that take exponential time with the backtracking code are matched in linear time.
+		 */
+		void testCompile() 
+		{
+			NamedClassManager ncm;
+			Regex r("(a+)+b|([a-z]+\\s?)*!", ncm);
+			Linear l(&r);
+			ICompilableTest::compileSource(l, Code::getHeader());
+			ICompilableTest::assert("aaab", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaac", 255,__FILE__,__LINE__);
+			ICompilableTest::assert("cd ab!", 6,__FILE__,__LINE__);
+			ICompilableTest::assert("xyz def ghi jkl mno pqr stu vwx yz abc def ghi jkl mno pqr stu vwx yz abc def ?", 255,__FILE__,__LINE__);
+		}
+
+		/**
+		 * The match is the same one found by the backtracking code: the first alternative that matches and the
+		 * greedy (or lazy) number of occurrences.
+		 */
+		void testPriority() 
+		{
+			NamedClassManager ncm;
+			Regex r("(a|ab)(c|bcd)(d*)|x(a|b)*?b|\\u00e9{2,3}", ncm);
+			Linear l(&r);
+			ICompilableTest::compileSource(l, Code::getHeader());
+			ICompilableTest::assert("abcd", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("abcdd", 5,__FILE__,__LINE__);
+			ICompilableTest::assert("acdd", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("xabbab", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9", 6,__FILE__,__LINE__);
+			ICompilableTest::assert("\xc3\xa9", 255,__FILE__,__LINE__);
+		}
+		
+	}; /* class LinearTest */
+} /* namespace pgen */
+
+#endif /* LINEAR_TEST_H_ */
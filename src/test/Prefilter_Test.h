@@ -0,0 +1,200 @@
+/*
+ * Prefilter_Test.h
+ *
+ *  Created on: May 25, 2015
+ *      Author: Dimas Melo Filho
+ */
+
+#ifndef PREFILTER_TEST_H_
+#define PREFILTER_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+#include <fstream>
+// pgen
+// pgen
+#include "../expr/Prefilter.h"
+#include "../expr/Regex.h"
+#include "../expr/Code.h"
+#include "../expr/Simplifier.h"
+#include "../parser/NamedClassManager.h"
+#include "ICompilable_Test.h"
+
+using namespace std;
+namespace pgen
+{
+	/**
+	 * Unit Test Fixture for the "Prefilter" class.
+	 */
+	class PrefilterTest 
+	 : public CppUnit::TestFixture 
+	{
+	public:
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test * suite() 
+		{
+			CppUnit::TestSuite * s = new CppUnit::TestSuite("PrefilterTest");
+			s->addTest(new CppUnit::TestCaller<PrefilterTest>("PrefilterTest::testPrefix", &PrefilterTest::testPrefix));
+			s->addTest(new CppUnit::TestCaller<PrefilterTest>("PrefilterTest::testCompile", &PrefilterTest::testCompile));
+			s->addTest(new CppUnit::TestCaller<PrefilterTest>("PrefilterTest::testFrom", &PrefilterTest::testFrom));
+			return s;
+		}
+
+		/**
+		 * Test preparations.
+		 */
+		void setUp() 
+		{
+		}
+
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+			ICompilableTest::clearFiles();
+		}
+
+		/**
+		 * \return the bytes that start every match of an expression.
+		 */
+		static string prefix(const string& expression)
+		{
+			NamedClassManager ncm;
+			Regex r(expression, ncm);
+			Simplifier::simplify(r);
+			Prefilter p(&r);
+			return p.prefix();
+		}
+
+		void testPrefix() 
+		{
+			CPPUNIT_ASSERT_EQUAL(string("^^"), prefix("\\^\\^"));
+			CPPUNIT_ASSERT_EQUAL(string("0x"), prefix("0x[0-9a-f]+"));
+			CPPUNIT_ASSERT_EQUAL(string("<a"), prefix("<a(b|c)*>"));
+			CPPUNIT_ASSERT_EQUAL(string("ab"), prefix("(ab)+c"));
+			CPPUNIT_ASSERT_EQUAL(string("Annotation"), prefix("AnnotationAssertion|AnnotationProperty"));
+			CPPUNIT_ASSERT_EQUAL(string(""), prefix("[0-9]+\\.[0-9]+"));
+			CPPUNIT_ASSERT_EQUAL(string(""), prefix("(ab)*c"));
+			CPPUNIT_ASSERT_EQUAL(string(""), prefix("if|else"));
+		}
+
+		/**
+		 * Compiles a program that returns the position of the first match of an expression on the file given as its 
+		 * argument (or 255 when there are no matches). The contents of the file are copied to a buffer that is 
+		 * followed by the bytes of "after" instead of a null character.
+		 */
+		static void compile(const string& expression, const string& after = "")
+		{
+			NamedClassManager ncm;
+			Regex r(expression, ncm);
+			Simplifier::simplify(r);
+			Prefilter p(&r);
+			Code c;
+			c.add(&r);
+			ofstream o("___test___.c");
+			o << c.getHeader() << endl << c.helper() << endl << endl << c.code() << endl 
+			  << p.compile("find", r.funcname()) << 
+				 "int main(int argc, char* argv[]) {"					"\n"
+				 " char buffer[256];"									"\n"
+				 " char* buf;"											"\n"
+				 " token_match m;"										"\n"
+				 " int res;"											"\n"
+				 " FILE* f = fopen(argv[1], \"r\");"					"\n"
+				 " int len = fread(buffer, 1, 255, f);"					"\n"
+				 " fclose(f);"											"\n"
+				 " buf = (char*) malloc(len + sizeof(\"" << after << "\"));"	"\n"
+				 " memcpy(buf, buffer, len);"							"\n"
+				 " memcpy(buf + len, \"" << after << "\", sizeof(\"" << after << "\"));\n"
+				 " res = find(buf, len, &m);"							"\n"
+				 " free(buf);"											"\n"
+				 " return res;"											"\n"
+				 "}"													"\n" << flush;
+			o.close();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+		}
+
+		void testCompile() 
+		{
+			compile("0x[0-9a-f]+");
+			ICompilableTest::assert("0x1f", 0,__FILE__,__LINE__);
+			ICompilableTest::assert("a = 0xg + 0x1f", 10,__FILE__,__LINE__);
+			ICompilableTest::assert("a = 0xg", 255,__FILE__,__LINE__);
+			compile("[0-9]+\\.[0-9]+");
+			ICompilableTest::assert("x = 12 + 1.5", 9,__FILE__,__LINE__);
+			ICompilableTest::assert("x = 12 + 1.", 255,__FILE__,__LINE__);
+			compile("\\^\\^");
+			ICompilableTest::assert("\"5\"^^xsd:integer", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("^ ^", 255,__FILE__,__LINE__);
+			// the bytes after the end of the buffer are not read, and the matches are cut at the end of the buffer
+			compile("0x[0-9a-f]+", "1f");
+			ICompilableTest::assert("zz 0x1f", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("zz 0x", 255,__FILE__,__LINE__);
+			compile("[0-9]+", "345");
+			ICompilableTest::assert("x 12", 2,__FILE__,__LINE__);
+			compile("\\^\\^", "^");
+			ICompilableTest::assert("5^", 255,__FILE__,__LINE__);
+		}
+
+		/**
+		 * Compiles a program that returns the number of matches of an expression on the file given as its argument, 
+		 * searching the text again after each match.
+		 */
+		static void compileFrom(const string& expression)
+		{
+			NamedClassManager ncm;
+			Regex r(expression, ncm);
+			Simplifier::simplify(r);
+			Prefilter p(&r);
+			Code c;
+			c.add(&r);
+			ofstream o("___test___.c");
+			o << c.getHeader() << endl << c.helper() << endl << endl << c.code() << endl 
+			  << p.compile("find", r.funcname()) << 
+				 "int main(int argc, char* argv[]) {"					"\n"
+				 " char text[256];"										"\n"
+				 " token_match m;"										"\n"
+				 " int start = 0, n = 0;"								"\n"
+				 " FILE* f = fopen(argv[1], \"r\");"					"\n"
+				 " int len = fread(text, 1, 255, f);"					"\n"
+				 " fclose(f);"											"\n"
+				 " text[len] = 0;"										"\n"
+				 " while (find_from(text, len, start, &m) != -1) {"		"\n"
+				 "  n++;"												"\n"
+				 "  start = m.start + (m.length > 0 ? m.length : 1);"	"\n"
+				 " }"													"\n"
+				 " return n;"											"\n"
+				 "}"													"\n" << flush;
+			o.close();
+			int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+			CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+		}
+
+		/**
+		 * Test the search of all the matches of a text, from the end of each match.
+		 */
+		void testFrom()
+		{
+			compileFrom("0x[0-9a-f]+");
+			ICompilableTest::assert("0x1f 0xg 0x2 0x", 2,__FILE__,__LINE__);
+			compileFrom("[0-9]+\\.[0-9]+");
+			ICompilableTest::assert("1.5 + 22.75 - 3. 4.0", 3,__FILE__,__LINE__);
+			compileFrom("\\^\\^");
+			ICompilableTest::assert("^^^^ ^ ^^", 3,__FILE__,__LINE__);
+			compileFrom("x*");
+			ICompilableTest::assert("axxb", 4,__FILE__,__LINE__);
+		}
+
+	}; /* class PrefilterTest */
+} /* namespace pgen */
+
+#endif /* PREFILTER_TEST_H_ */
@@ -23,6 +23,8 @@
 #include "../expr/Range.h"
 #include "../expr/CharClass.h"
 #include "../expr/Code.h"
+#include "../expr/Regex.h"
+#include "../parser/NamedClassManager.h"
 #include "ICompilable_Test.h"
 
 using namespace std;
@@ -44,6 +46,7 @@ namespace pgen
 		{
 			CppUnit::TestSuite * s = new CppUnit::TestSuite("QuantifiedTest");
 			s->addTest(new CppUnit::TestCaller<QuantifiedTest>("QuantifiedTest::testCompile", &QuantifiedTest::testCompile));
+			s->addTest(new CppUnit::TestCaller<QuantifiedTest>("QuantifiedTest::testCounted", &QuantifiedTest::testCounted));
 			return s;
 		}
 
@@ -107,6 +110,34 @@ namespace pgen
 			ICompilableTest::clearFiles();
 		}
 
+		/**
+		 * Repetitions of literal texts and bounded repetitions are counted instead of stacked, and they still give
+		 * back occurrences when the rest of the expression does not match.
+		 */
+		void testCounted() 
+		{
+			NamedClassManager ncm;
+			Regex r("x(ab)*abc|[0-9]{0,3}5|(a[0-9]{2})+z|(-[a-z]{2,8})+!", ncm);
+			Code c;
+			for (ICompilable* e: r.dependences())
+			{
+				c.add(e);
+			}
+			ICompilableTest::compileSource(r, Code::getHeader(), c.code());
+			ICompilableTest::assert("xabababc", 8,__FILE__,__LINE__);
+			ICompilableTest::assert("xabc", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("xab", 255,__FILE__,__LINE__);
+			ICompilableTest::assert("1235", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("125", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("555", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("12345", 255,__FILE__,__LINE__);
+			ICompilableTest::assert("a12a34z", 7,__FILE__,__LINE__);
+			ICompilableTest::assert("a1z", 255,__FILE__,__LINE__);
+			ICompilableTest::assert("-en-us!", 7,__FILE__,__LINE__);
+			ICompilableTest::assert("-abcdefghij!", 255,__FILE__,__LINE__);
+			ICompilableTest::clearFiles();
+		}
+
 	}; /* class QuantifiedTest */
 } /* namespace pgen */
 
@@ -26,6 +26,8 @@
 #include "../expr/CharClass.h"
 #include "../expr/Code.h"
 #include "../parser/NamedClassManager.h"
+#include "../misc/RegexException.h"
+#include "../misc/LanguageException.h"
 #include "ICompilable_Test.h"
 
 using namespace std;
@@ -45,6 +47,8 @@ namespace pgen
 		{
 			CppUnit::TestSuite * s = new CppUnit::TestSuite("RegexTest");
 			s->addTest(new CppUnit::TestCaller<RegexTest>("RegexTest::testParse", &RegexTest::testParse));
+			s->addTest(new CppUnit::TestCaller<RegexTest>("RegexTest::testUnicodeProperties", &RegexTest::testUnicodeProperties));
+			s->addTest(new CppUnit::TestCaller<RegexTest>("RegexTest::testIgnoreCase", &RegexTest::testIgnoreCase));
 			return s;
 		}
 
@@ -194,8 +198,8 @@ namespace pgen
 			CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong element type", expected, seq->expr[2]->type());
 			
 			CharClass *h = (CharClass*) seq->expr[0];
-			CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong range start on character class", (unsigned int)'m', h->range->start);
-			CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong range end on character class", (unsigned int)'o', h->range->end);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong range start on character class", (unsigned int)'m', h->ranges.begin()->first);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong range end on character class", (unsigned int)'o', h->ranges.begin()->second);
 			
 			q = (Quantified*) seq->expr[1];
 			CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong quantifier minimum", (unsigned int)1, q->min);
@@ -205,17 +209,90 @@ namespace pgen
 			CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong quantified element type", expected, q->expr->type());
 			
 			h = (CharClass*) q->expr;
-			CPPUNIT_ASSERT_MESSAGE("Wrong range start on character class", h->range->start == 1);
-			CPPUNIT_ASSERT_MESSAGE("Wrong range end on character class", h->range->end == 'o');
-			CPPUNIT_ASSERT_MESSAGE("Wrong range start on character class", h->range->next != nullptr);
-			CPPUNIT_ASSERT_MESSAGE("Wrong range start on character class", h->range->next->start == 't');
-			CPPUNIT_ASSERT_MESSAGE("Wrong range end on character class", h->range->next->end == UINT_MAX);
+			CPPUNIT_ASSERT_MESSAGE("Wrong range start on character class", h->ranges.begin()->first == 1);
+			CPPUNIT_ASSERT_MESSAGE("Wrong range end on character class", h->ranges.begin()->second == 'o');
+			CPPUNIT_ASSERT_MESSAGE("Wrong range start on character class", h->ranges.size() == 2);
+			CPPUNIT_ASSERT_MESSAGE("Wrong range start on character class", (++h->ranges.begin())->first == 't');
+			CPPUNIT_ASSERT_MESSAGE("Wrong range end on character class", (++h->ranges.begin())->second == UINT_MAX);
 			
 			c = (Character*) seq->expr[2];
 			CPPUNIT_ASSERT_EQUAL_MESSAGE("Invalid character value", (unsigned int) 10, c->getChar());
 			
 		}
+
+		void testUnicodeProperties() 
+		{
+			NamedClassManager ncm;
+			// \p{Lu}\P{L}\pN[:Greek:]
+			Regex re("\\p{Lu}\\P{L}\\pN[:Greek:]", ncm);
+			Sequence* seq = (Sequence*)re.expr[0];
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("The regex sequence must contain 4 elements.", 4, (int)seq->expr.size());
+			int expected = CharClass::TYPE;
+			for (unsigned int i = 0; i < seq->expr.size(); i++) 
+			{
+				CPPUNIT_ASSERT_EQUAL_MESSAGE("All objects of the regex sequence are expected to be classes.", expected, seq->expr[i]->type());
+			}
+			CharClass *upper = (CharClass*)seq->expr[0], *nonLetter = (CharClass*)seq->expr[1], 
+				*number = (CharClass*)seq->expr[2], *greek = (CharClass*)seq->expr[3];
+			CPPUNIT_ASSERT(upper->ranges.contains('A') && upper->ranges.contains(0xC9) && !upper->ranges.contains('a'));
+			CPPUNIT_ASSERT(!nonLetter->ranges.contains('a') && !nonLetter->ranges.contains(0x4E00));
+			CPPUNIT_ASSERT(nonLetter->ranges.contains('1') && nonLetter->ranges.contains(0x110000));
+			CPPUNIT_ASSERT(number->ranges.contains('7') && number->ranges.contains(0x663) && !number->ranges.contains('a'));
+			CPPUNIT_ASSERT(greek->ranges.contains(0x3B1) && !greek->ranges.contains('a'));
+			// long names, explicit properties and loose matching
+			Regex re2("[\\p{Uppercase Letter}\\p{gc=Ll}\\p{Script=old-italic}]", ncm);
+			CharClass* cClass = (CharClass*)((Sequence*)re2.expr[0])->expr[0];
+			CPPUNIT_ASSERT(cClass->ranges.contains('A') && cClass->ranges.contains('a') && cClass->ranges.contains(0x10300));
+			CPPUNIT_ASSERT(!cClass->ranges.contains('1'));
+			// unknown properties
+			CPPUNIT_ASSERT_THROW(Regex("\\p{Klingon}", ncm), RegexException);
+			CPPUNIT_ASSERT_THROW(Regex("\\p{Greek", ncm), RegexException);
+			CPPUNIT_ASSERT_THROW(ncm.get("Klingon"), LanguageException);
+		}
 		
+
+		void testIgnoreCase() 
+		{
+			NamedClassManager ncm;
+			// sK1 (case insensitive): [sS][kK\u212A]1
+			Regex re("sK1", ncm, true);
+			Sequence* seq = (Sequence*)re.expr[0];
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("The regex sequence must contain 3 elements.", 3, (int)seq->expr.size());
+			int expected = CharClass::TYPE;
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("Letters must be replaced by classes.", expected, seq->expr[0]->type());
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("Letters must be replaced by classes.", expected, seq->expr[1]->type());
+			expected = Character::TYPE;
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("Digits have no case variants.", expected, seq->expr[2]->type());
+			CharClass *s = (CharClass*)seq->expr[0], *k = (CharClass*)seq->expr[1];
+			CPPUNIT_ASSERT(s->ranges.contains('s') && s->ranges.contains('S') && s->ranges.contains(0x17F));
+			CPPUNIT_ASSERT(k->ranges.contains('k') && k->ranges.contains('K') && k->ranges.contains(0x212A));
+			// classes are folded before they are negated
+			Regex re2("[^a-c\u00e9]", ncm, true);
+			CharClass* cClass = (CharClass*)((Sequence*)re2.expr[0])->expr[0];
+			CPPUNIT_ASSERT(!cClass->ranges.contains('B') && !cClass->ranges.contains(0xC9) && cClass->ranges.contains('d'));
+			// inline flags: (?i) until the end of the group, (?i:...) only inside the group
+			Regex re3("a(b(?i)c)d(?i:e)f(?i)g(?-i)h", ncm);
+			seq = (Sequence*)re3.expr[0];
+			CPPUNIT_ASSERT_EQUAL_MESSAGE("The regex sequence must contain 7 elements.", 7, (int)seq->expr.size());
+			expected = Character::TYPE;
+			CPPUNIT_ASSERT_EQUAL(expected, seq->expr[0]->type());
+			CPPUNIT_ASSERT_EQUAL(expected, seq->expr[2]->type());
+			CPPUNIT_ASSERT_EQUAL(expected, seq->expr[4]->type());
+			CPPUNIT_ASSERT_EQUAL(expected, seq->expr[6]->type());
+			expected = CharClass::TYPE;
+			CPPUNIT_ASSERT_EQUAL(expected, seq->expr[5]->type());
+			CPPUNIT_ASSERT_EQUAL(expected, ((Sequence*)seq->expr[3])->expr[0]->type());
+			Sequence* group = (Sequence*)seq->expr[1];
+			expected = Character::TYPE;
+			CPPUNIT_ASSERT_EQUAL(expected, group->expr[0]->type());
+			expected = CharClass::TYPE;
+			CPPUNIT_ASSERT_EQUAL(expected, group->expr[1]->type());
+			// (?-i) turns off the flag of the constructor
+			Regex re4("(?-i)a", ncm, true);
+			expected = Character::TYPE;
+			CPPUNIT_ASSERT_EQUAL(expected, ((Sequence*)re4.expr[0])->expr[0]->type());
+			CPPUNIT_ASSERT_THROW(Regex("(?x)a", ncm), RegexException);
+		}
 	}; /* class RegexTest */
 } /* namespace pgen */
 
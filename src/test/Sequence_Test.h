@@ -21,6 +21,7 @@
 // pgen
 #include "../expr/Sequence.h"
 #include "../expr/Character.h"
+#include "../expr/Quantified.h"
 #include "ICompilable_Test.h"
 
 using namespace std;
@@ -45,6 +46,7 @@ namespace pgen
 			suite->addTest(new CppUnit::TestCaller<SequenceTest>("SequenceTest::testAdd", &SequenceTest::testAdd));
 			suite->addTest(new CppUnit::TestCaller<SequenceTest>("SequenceTest::testCompile", &SequenceTest::testCompile));
 			suite->addTest(new CppUnit::TestCaller<SequenceTest>("SequenceTest::testName", &SequenceTest::testName));
+			suite->addTest(new CppUnit::TestCaller<SequenceTest>("SequenceTest::testFused", &SequenceTest::testFused));
 			return suite;
 		}
 
@@ -100,7 +102,52 @@ namespace pgen
 		 */
 		void testName() 
 		{
-			CPPUNIT_ICOMPILABLE_ASSERTNAME(*s, "sq_ch_114_ch_101");
+			// structurally equal sequences share the same short name, different ones don't.
+			Sequence same, other;
+			same.add(new Character('r'));
+			same.add(new Character('e'));
+			other.add(new Character('e'));
+			other.add(new Character('r'));
+			CPPUNIT_ICOMPILABLE_ASSERTNAME(*s, same.name());
+			CPPUNIT_ASSERT(s->name() != other.name());
+			string name = s->name();
+			CPPUNIT_ASSERT(name.substr(0, 2) == "sq");
+			CPPUNIT_ASSERT(name.find_first_not_of("0123456789", 2) == string::npos);
+			// the name does not grow with the names of the sub-expressions.
+			Sequence outer;
+			outer.add(new Character('x'));
+			outer.add(new Quantified(new Character('y'), 0, Quantified::INF));
+			Sequence *inner = new Sequence();
+			inner->add(new Character('r'));
+			inner->add(new Character('e'));
+			outer.add(inner);
+			CPPUNIT_ASSERT(outer.name().length() <= 2 + 10);
+		}
+
+		/**
+		 * Test the Sequence::fused() method and the compilation of a fused sequence without any dependences.
+		 */
+		void testFused()
+		{
+			CPPUNIT_ASSERT(s->fused() == 2);
+			CPPUNIT_ASSERT(s->deterministic());
+			Sequence seq;
+			seq.add(new Character('a'));
+			seq.add(new Quantified(new Character('b'), 2, 2));
+			seq.add(new Quantified(new Character('c'), 0, Quantified::INF));
+			seq.add(new Character('d'));
+			CPPUNIT_ASSERT(seq.fused() == 2);
+			CPPUNIT_ASSERT(!seq.deterministic());
+			Sequence fused;
+			fused.add(new Character('a'));
+			fused.add(new Character(0xE9));
+			fused.add(new Quantified(new Character('b'), 2, 2));
+			ICompilableTest::compileSource(fused, Code::getHeader());
+			CPPUNIT_ICOMPILABLE_ASSERT("a\xC3\xA9" "bb", 5);
+			CPPUNIT_ICOMPILABLE_ASSERT("a\xC3\xA9" "bbb", 5);
+			CPPUNIT_ICOMPILABLE_ASSERT("a\xC3\xA9" "b", 255);
+			CPPUNIT_ICOMPILABLE_ASSERT("abb", 255);
+			ICompilableTest::clearFiles();
 		}
 		
 	}; /* class SequenceTest */
@@ -0,0 +1,162 @@
+/*
+ * Simplifier_Test.h
+ *
+ *  Created on: May 24, 2015
+ *      Author: Dimas Melo Filho
+ */
+
+#ifndef SIMPLIFIER_TEST_H_
+#define SIMPLIFIER_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+// pgen
+#include "../expr/Simplifier.h"
+#include "../expr/Regex.h"
+#include "../expr/Code.h"
+#include "../parser/NamedClassManager.h"
+#include "ICompilable_Test.h"
+
+using namespace std;
+namespace pgen
+{
+	/**
+	 * Unit Test Fixture for the "Simplifier" class.
+	 */
+	class SimplifierTest 
+	 : public CppUnit::TestFixture 
+	{
+	private:
+		/**
+		 * \return the simplified regular expression.
+		 */
+		string simplify(const string& expression)
+		{
+			NamedClassManager ncm;
+			Regex r(expression, ncm);
+			Simplifier::simplify(r);
+			return r.str();
+		}
+	public:
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test * suite() 
+		{
+			CppUnit::TestSuite * s = new CppUnit::TestSuite("SimplifierTest");
+			s->addTest(new CppUnit::TestCaller<SimplifierTest>("SimplifierTest::testSequences", &SimplifierTest::testSequences));
+			s->addTest(new CppUnit::TestCaller<SimplifierTest>("SimplifierTest::testAlternatives", &SimplifierTest::testAlternatives));
+			s->addTest(new CppUnit::TestCaller<SimplifierTest>("SimplifierTest::testQuantifiers", &SimplifierTest::testQuantifiers));
+			s->addTest(new CppUnit::TestCaller<SimplifierTest>("SimplifierTest::testCompile", &SimplifierTest::testCompile));
+			return s;
+		}
+
+		/**
+		 * Test preparations.
+		 */
+		void setUp() 
+		{
+		}
+
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+		}
+
+		void testSequences() 
+		{
+			NamedClassManager ncm;
+			Regex r("a(b(cd))[0-9]", ncm);
+			Simplifier::simplify(r);
+			CPPUNIT_ASSERT_EQUAL((size_t)1, r.expr.size());
+			CPPUNIT_ASSERT(r.expr[0]->type() == Sequence::TYPE);
+			CPPUNIT_ASSERT_EQUAL((size_t)2, r.expr[0]->dependences().size());
+			CPPUNIT_ASSERT(r.expr[0]->dependences()[0]->type() == Text::TYPE);
+			CPPUNIT_ASSERT_EQUAL(string("abcd[0-9]"), r.str());
+			CPPUNIT_ASSERT_EQUAL(string("abc\\-[a-z]"), simplify("(a)((b)c)-[a-z]"));
+		}
+
+		void testAlternatives() 
+		{
+			CPPUNIT_ASSERT_EQUAL(string("[a-d]"), simplify("a|(b|c)|d"));
+			CPPUNIT_ASSERT_EQUAL(string("x([a-b]|cd|[0-9e])"), simplify("x(a|b|cd|e|[0-9])"));
+			CPPUNIT_ASSERT_EQUAL(string("ab(c[0-9]|d|)"), simplify("abc[0-9]|abd|ab"));
+			CPPUNIT_ASSERT_EQUAL(string("\\xE9[a-b]|\\xE8|\\xE9[0-9]"), simplify("\\u00e9a|\\u00e9b|\\u00e8|\\u00e9[0-9]"));
+			CPPUNIT_ASSERT_EQUAL(string("[0-9](\\.[0-9])?x"), simplify("([0-9]\\.[0-9]|[0-9])x"));
+			// prefixes that can be matched in more than one way are not factored out
+			CPPUNIT_ASSERT_EQUAL(string("a(b+c|b+d)"), simplify("ab+c|ab+d"));
+			CPPUNIT_ASSERT_EQUAL(string("([0-9]+\\.[0-9]+|[0-9]+)x"), simplify("([0-9]+\\.[0-9]+|[0-9]+)x"));
+			// literal alternatives are left to the trie
+			CPPUNIT_ASSERT_EQUAL(string("if|int|in"), simplify("if|int|in"));
+			// only adjacent alternatives are merged, so that the priorities do not change
+			CPPUNIT_ASSERT_EQUAL(string("a[0-9]|b+|a"), simplify("a[0-9]|b+|a"));
+		}
+
+		void testQuantifiers() 
+		{
+			CPPUNIT_ASSERT_EQUAL(string("x*y"), simplify("x*x*y"));
+			CPPUNIT_ASSERT_EQUAL(string("[0-9]+"), simplify("[0-9][0-9]*"));
+			CPPUNIT_ASSERT_EQUAL(string("a{2,}b"), simplify("a+a+b"));
+			CPPUNIT_ASSERT_EQUAL(string("a+b"), simplify("(a+)+b"));
+			CPPUNIT_ASSERT_EQUAL(string("a*b"), simplify("(a?)*b"));
+			CPPUNIT_ASSERT_EQUAL(string("abc"), simplify("a{1}(bc){1}"));
+			// lazy quantifiers and ambiguous repetitions are kept
+			CPPUNIT_ASSERT_EQUAL(string("x*?x*"), simplify("x*?x*"));
+			CPPUNIT_ASSERT_EQUAL(string("(a|ab)*(a|ab)*"), simplify("(a|ab)*(a|ab)*"));
+			CPPUNIT_ASSERT_EQUAL(string("x?x{0,3}"), simplify("x?x{0,3}"));
+			// nested quantifiers followed by the repeated expression are kept, since the outer one can only give back
+			// all the occurrences of the inner one
+			CPPUNIT_ASSERT_EQUAL(string("(a+)?a"), simplify("(a+)?a"));
+			CPPUNIT_ASSERT_EQUAL(string("((a+)*a|b)c"), simplify("((a+)*a|b)c"));
+			CPPUNIT_ASSERT_EQUAL(string("(a*b)+a"), simplify("((a+)?b)+a"));
+		}
+
+		/**
+		 * The simplified expressions match the same texts as the original ones.
+		 */
+		void testCompile() 
+		{
+			NamedClassManager ncm;
+			Regex r("(ab|a)(bc|c)z|abc[0-9]|abd|ab|(x?x)*y|a+a*w", ncm);
+			Simplifier::simplify(r);
+			Code c;
+			for (ICompilable* e: r.dependences())
+			{
+				c.add(e);
+			}
+			ICompilableTest::compileSource(r, Code::getHeader(), c.code());
+			ICompilableTest::assert("abcz", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("abbcz", 5,__FILE__,__LINE__);
+			ICompilableTest::assert("acz", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("abc1", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("abd", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("abc", 2,__FILE__,__LINE__);
+			ICompilableTest::assert("xxxy", 4,__FILE__,__LINE__);
+			ICompilableTest::assert("aaw", 3,__FILE__,__LINE__);
+			ICompilableTest::assert("aa", 255,__FILE__,__LINE__);
+			ICompilableTest::clearFiles();
+			Regex nested("(a+)?a", ncm);
+			Simplifier::simplify(nested);
+			Code n;
+			for (ICompilable* e: nested.dependences())
+			{
+				n.add(e);
+			}
+			ICompilableTest::compileSource(nested, Code::getHeader(), n.code());
+			ICompilableTest::assert("aa", 1,__FILE__,__LINE__);
+			ICompilableTest::assert("a", 1,__FILE__,__LINE__);
+			ICompilableTest::clearFiles();
+		}
+		
+	}; /* class SimplifierTest */
+} /* namespace pgen */
+
+#endif /* SIMPLIFIER_TEST_H_ */
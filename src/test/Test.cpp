@@ -20,12 +20,20 @@
 #include "Character_Test.h"
 #include "Sequence_Test.h"
 #include "Text_Test.h"
+#include "Trie_Test.h"
+#include "Backtracking_Test.h"
+#include "Linear_Test.h"
+#include "Simplifier_Test.h"
+#include "BitParallel_Test.h"
+#include "Prefilter_Test.h"
 #include "Regex_Test.h"
 #include "Alternative_Test.h"
 #include "Code_Test.h"
 #include "Language_Test.h"
 #include "TokenType_Test.h"
 #include "LLStar_Test.h"
+#include "LL1_Test.h"
+#include "LALR1_Test.h"
 
 int main(int argc, char* argv[]) 
 {
@@ -42,12 +50,20 @@ int main(int argc, char* argv[])
 	runner.addTest(pgen::CharacterTest::suite());
 	runner.addTest(pgen::SequenceTest::suite());
 	runner.addTest(pgen::TextTest::suite());
+	runner.addTest(pgen::TrieTest::suite());
+	runner.addTest(pgen::BacktrackingTest::suite());
+	runner.addTest(pgen::LinearTest::suite());
+	runner.addTest(pgen::SimplifierTest::suite());
+	runner.addTest(pgen::BitParallelTest::suite());
+	runner.addTest(pgen::PrefilterTest::suite());
 	runner.addTest(pgen::RegexTest::suite());
 	runner.addTest(pgen::AlternativeTest::suite());
 	runner.addTest(pgen::CodeTest::suite());
 	runner.addTest(pgen::LanguageTest::suite());
 	runner.addTest(pgen::TokenTypeTest::suite());
 	runner.addTest(pgen::LLStarTest::suite());
+	runner.addTest(pgen::LL1Test::suite());
+	runner.addTest(pgen::LALR1Test::suite());
 	runner.run(controller);
 	return 0;
 }
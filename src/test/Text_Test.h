@@ -74,6 +74,13 @@ namespace pgen
 			ICompilableTest::compileSource(special, pgen::Code::getHeader());
 			CPPUNIT_ICOMPILABLE_ASSERT("\x01\x02\x03\x04\x05\x06", 6);
 			CPPUNIT_ICOMPILABLE_ASSERT("123456", 255);
+			// texts longer than Text::MAX_UNROLLED bytes, with utf-8 characters
+			Text longText("caf\xc3\xa9 com p\xc3\xa3o");
+			ICompilableTest::compileSource(longText, pgen::Code::getHeader());
+			CPPUNIT_ICOMPILABLE_ASSERT("caf\xc3\xa9 com p\xc3\xa3o", 14);
+			CPPUNIT_ICOMPILABLE_ASSERT("caf\xc3\xa9 com p\xc3\xa3o!", 14);
+			CPPUNIT_ICOMPILABLE_ASSERT("caf\xc3\xa9 com p\xc3\xa3", 255);
+			CPPUNIT_ICOMPILABLE_ASSERT("cafe com pao", 255);
 			ICompilableTest::clearFiles();
 		}
 
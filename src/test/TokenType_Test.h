@@ -18,10 +18,12 @@
 // STL
 #include <string>
 #include <fstream>
+#include <vector>
 // pgen
 #include "../parser/TokenType.h"
 #include "../expr/Alternative.h"
 #include "../expr/Sequence.h"
+#include "../expr/Text.h"
 
 using namespace std;
 namespace pgen 
@@ -41,6 +43,9 @@ namespace pgen
 			TestSuite * s = new TestSuite("TokenTypeTest");
 			s->addTest(new TestCaller<TokenTypeTest>("TokenTypeTest::testConstructor", &TokenTypeTest::testConstructor));
 			s->addTest(new TestCaller<TokenTypeTest>("TokenTypeTest::testCompile", &TokenTypeTest::testCompile));
+			s->addTest(new TestCaller<TokenTypeTest>("TokenTypeTest::testMatcher", &TokenTypeTest::testMatcher));
+			s->addTest(new TestCaller<TokenTypeTest>("TokenTypeTest::testEngines", &TokenTypeTest::testEngines));
+			s->addTest(new TestCaller<TokenTypeTest>("TokenTypeTest::testLiteral", &TokenTypeTest::testLiteral));
 			return s;
 		}
 		
@@ -84,8 +89,9 @@ namespace pgen
 			CPPUNIT_ASSERT_EQUAL((unsigned int)2, (unsigned int)t.regex.expr.size());
 			CPPUNIT_ASSERT(Sequence::TYPE == t.regex.expr[0]->type());
 			CPPUNIT_ASSERT_EQUAL((unsigned int)4, (unsigned int)reinterpret_cast<Sequence*>(t.regex.expr[0])->expr.size());
-			CPPUNIT_ASSERT(Sequence::TYPE == t.regex.expr[1]->type());
-			CPPUNIT_ASSERT_EQUAL((unsigned int)2, (unsigned int)reinterpret_cast<Sequence*>(t.regex.expr[1])->expr.size());
+			// the characters of the second alternative are merged into a text (see Simplifier)
+			CPPUNIT_ASSERT(Text::TYPE == t.regex.expr[1]->type());
+			CPPUNIT_ASSERT_EQUAL(string("ab"), reinterpret_cast<Text*>(t.regex.expr[1])->getText());
 		}
 		
 		/**
@@ -99,7 +105,7 @@ namespace pgen
 			TokenType t(lang, "\\d+\\.\\d+|ab", "TEST_TOKEN", 1, true, 0, validStates);
 			string testToken("TEST_TOKEN");
 			Code c;
-			c.add(&t.regex);
+			c.add(t.matcher());
 			system("rm -f ___test___.c"); 								// remove source
 			ofstream o("___test___.c");
 			o << c.getHeader() << endl << c.helper() << endl << endl << c.code() << endl << endl;
@@ -134,6 +140,101 @@ namespace pgen
 			res = system("./___test___ 123.a523") >> 8;
 			CPPUNIT_ASSERT_EQUAL(255, res);
 		}
+
+		/**
+		 * Test that the tokens that may backtrack catastrophically are only matched by the bit-parallel or linear-time
+		 * engines when the language enables them.
+		 */
+		void testMatcher()
+		{
+			TokenType safe(lang, "[0-9]+\\.[0-9]+", "SAFE", 1);
+			CPPUNIT_ASSERT(safe.matcher() == &safe.regex);
+			// by default, the risky tokens are only reported
+			TokenType kept(lang, "\"(\\\\.|[^\"])*\"", "KEPT", 2);
+			CPPUNIT_ASSERT(kept.matcher() == &kept.regex);
+			lang->linear = true;
+			TokenType risky(lang, "\"(\\\\.|[^\"])*\"", "RISKY", 2);
+			CPPUNIT_ASSERT(Linear::TYPE == risky.matcher()->type());
+			CPPUNIT_ASSERT(risky.matcher()->funcname() != risky.regex.funcname());
+			// risky tokens supported by the bit-parallel engine are matched by it
+			TokenType small(lang, "([a-z]+\\s?)*!", "SMALL", 3);
+			CPPUNIT_ASSERT(BitParallel::TYPE == small.matcher()->type());
+		}
+
+		/**
+		 * Test that the backtracking code, the linear-time engine and the bit-parallel engine find the same match on
+		 * the same token (GCC is required).
+		 */
+		void testEngines()
+		{
+			const char* expressions[] = {"([a-z]+\\s?)*!", "(a|b)*c", "\"(\\\\.|[^\"])*\""};
+			const char* texts[] = {"abc def!", "abc def", "!", "aababbc", "aab", "\"a\\\"b\"c", "\"ab", "x"};
+			for (const char* expression: expressions)
+			{
+				TokenType t(lang, expression, "TEST_TOKEN", 1);
+				Linear linear(&t.regex);
+				BitParallel bitParallel(&t.regex);
+				vector<ICompilable*> engines = {&t.regex, &linear};
+				if (bitParallel.supported())
+				{
+					engines.push_back(&bitParallel);
+				}
+				Code c;
+				for (ICompilable* engine: engines)
+				{
+					c.add(engine);
+				}
+				system("rm -f ___test___.c"); 								// remove source
+				ofstream o("___test___.c");
+				o << c.getHeader() << endl << c.helper() << endl << endl << c.code() << endl << endl;
+				o << "int main(int argc, char* argv[]) {"	"\n"
+					 " switch (argv[1][0]) {"				"\n";
+				for (unsigned int i = 0; i < engines.size(); i++)
+				{
+					o << "  case '" << i << "': return " << engines[i]->funcname() << "(argv[2]) + 1;" "\n";
+				}
+				o << " }"									"\n"
+					 " return -1;"							"\n"
+					 "}"									"\n"
+				  << flush;
+				o.close();
+				int res = system("gcc -o ___test___ ___test___.c") >> 8;	// compile using gcc
+				CPPUNIT_ASSERT( res == 0 ); 								// assert a successfull compilation
+				for (const char* text: texts)
+				{
+					string arg = string(" '") + text + "'";
+					int expected = system(("./___test___ 0" + arg).c_str()) >> 8;
+					for (unsigned int i = 1; i < engines.size(); i++)
+					{
+						res = system(("./___test___ " + to_string(i) + arg).c_str()) >> 8;
+						CPPUNIT_ASSERT_EQUAL(expected, res);
+					}
+				}
+			}
+		}
+
+		/**
+		 * Test the texts of the literal tokens, which are matched together by a trie on the next_token function.
+		 */
+		void testLiteral()
+		{
+			int* validStates = (int*)malloc(sizeof(int)*3);
+			validStates[0] = 0;
+			validStates[1] = 2;
+			validStates[2] = -1;
+			TokenType dhat(lang, "\\^\\^", "DHAT", 1, false, 1, validStates);
+			string bytes;
+			CPPUNIT_ASSERT(dhat.literal(bytes));
+			CPPUNIT_ASSERT_EQUAL(string("^^"), bytes);
+			CPPUNIT_ASSERT_EQUAL(string("UT_state == 0 || UT_state == 2"), dhat.stateCondition());
+			stringstream s;
+			dhat.acceptCode(" ", s);
+			CPPUNIT_ASSERT_EQUAL(string(" UT_state = 1;\n return 1;\n"), s.str());
+			TokenType number(lang, "[0-9]+", "NUMBER", 2, true);
+			bytes.clear();
+			CPPUNIT_ASSERT(!number.literal(bytes));
+			CPPUNIT_ASSERT_EQUAL(string(""), number.stateCondition());
+		}
 		
 	};
 };
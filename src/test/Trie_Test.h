@@ -0,0 +1,106 @@
+/*
+ * Trie_Test.h
+ *
+ *  Created on: May 02, 2015
+ *      Author: Dimas Melo Filho
+ */
+
+#ifndef TRIE_TEST_H_
+#define TRIE_TEST_H_
+
+// CppUnit
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/Test.h>
+// STL
+#include <string>
+#include <sstream>
+#include <vector>
+// pgen
+#include "../expr/Trie.h"
+
+using namespace std;
+namespace pgen
+{
+	/**
+	 * Unit Test Fixture for the "Trie" class.
+	 */
+	class TrieTest 
+	 : public CppUnit::TestFixture 
+	{
+	public:
+		/**
+		 * Returns the suite of tests for this fixture.
+		 */
+		static CppUnit::Test * suite() 
+		{
+			CppUnit::TestSuite * s = new CppUnit::TestSuite("TrieTest");
+			s->addTest(new CppUnit::TestCaller<TrieTest>("TrieTest::testCompile", &TrieTest::testCompile));
+			s->addTest(new CppUnit::TestCaller<TrieTest>("TrieTest::testAll", &TrieTest::testAll));
+			return s;
+		}
+
+		/**
+		 * Test preparations.
+		 */
+		void setUp() 
+		{
+		}
+
+		/**
+		 * Post-test procedures.
+		 */
+		void tearDown() 
+		{
+		}
+
+		/**
+		 * Stop code used by the tests: "m<item>:<length>" for each match, followed by "end".
+		 */
+		static void stop(stringstream& s, const string& tabs, const vector<Trie::Match>& matches)
+		{
+			for (const Trie::Match& m: matches)
+			{
+				s << "m" << m.item << ":" << m.length << " ";
+			}
+			s << "end" << endl;
+		}
+
+		void testCompile() 
+		{
+			Trie trie;
+			trie.add("ab", 0);
+			trie.add("a", 1);
+			trie.add("abc", 2);
+			trie.add("b", 3);
+			trie.add("b", 4);
+			string code = trie.compile(false, TrieTest::stop, "");
+			// "abc" can't have a higher priority than "ab", so text[2] is never read.
+			CPPUNIT_ASSERT(code.find("text[2]") == string::npos);
+			CPPUNIT_ASSERT(code.find("m0:2 m1:1 end") != string::npos);
+			CPPUNIT_ASSERT(code.find("m1:1 end") != string::npos);
+			CPPUNIT_ASSERT(code.find("m3:1 end") != string::npos);
+			CPPUNIT_ASSERT(code.find("m4:1") == string::npos);
+			CPPUNIT_ASSERT(code.find("m2:3") == string::npos);
+		}
+
+		void testAll() 
+		{
+			Trie trie;
+			trie.add("ab", 0);
+			trie.add("a", 1);
+			trie.add("abc", 2);
+			string code = trie.compile(true, TrieTest::stop, "");
+			// all the matches are given to the stop code, sorted by item.
+			CPPUNIT_ASSERT(code.find("text[2]") != string::npos);
+			CPPUNIT_ASSERT(code.find("m0:2 m1:1 m2:3 end") != string::npos);
+			CPPUNIT_ASSERT(code.find("m0:2 m1:1 end") != string::npos);
+			CPPUNIT_ASSERT(code.find("m1:1 end") != string::npos);
+		}
+		
+	}; /* class TrieTest */
+} /* namespace pgen */
+
+#endif /* TRIE_TEST_H_ */
@@ -32,6 +32,7 @@ namespace pgen
 			CppUnit::TestSuite * s = new CppUnit::TestSuite("IntervalTest");
 			s->addTest(new CppUnit::TestCaller<UtilTest>("Util::hex2int", &UtilTest::test_hex2int));
 			s->addTest(new CppUnit::TestCaller<UtilTest>("Util::next_utf8", &UtilTest::test_nextutf8));
+			s->addTest(new CppUnit::TestCaller<UtilTest>("Util::int2utf8", &UtilTest::test_int2utf8));
 			return s;
 		}
 		void setUp() 
@@ -242,6 +243,24 @@ namespace pgen
 			}
 			// TODO zzz write tests to check invalid characters.
 		}
+
+		void test_int2utf8()
+		{
+			CPPUNIT_ASSERT( Util::int2utf8('a') == "a" );
+			CPPUNIT_ASSERT( Util::int2utf8(0x7F) == "\x7F" );
+			CPPUNIT_ASSERT( Util::int2utf8(0xE9) == "\xC3\xA9" );
+			CPPUNIT_ASSERT( Util::int2utf8(0x7FF) == "\xDF\xBF" );
+			CPPUNIT_ASSERT( Util::int2utf8(0xFFFD) == "\xEF\xBF\xBD" );
+			CPPUNIT_ASSERT( Util::int2utf8(0x10348) == "\xF0\x90\x8D\x88" );
+			// Every encoded character must be decoded back to itself
+			for (unsigned int c = 1; c <= 0x10FFFF; c += 0x7F)
+			{
+				unsigned int pos = 0;
+				string s = Util::int2utf8(c);
+				CPPUNIT_ASSERT( Util::next_utf8(s, pos) == c );
+				CPPUNIT_ASSERT( pos == s.length() );
+			}
+		}
 		
 	}; /* class UtilTest */
 } /* namespace pgen */